@@ -0,0 +1,128 @@
+// Config parser benchmark: parse time and heap allocations of hb_load_configs_from_json() for
+// synthetic configs of 10 to 10,000 windows that share a handful of titles and addresses.
+//
+//   hb_config_bench [repetitions]
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../src/hb_config.h"
+
+// ---------------- Allocation counting ----------------
+
+// glibc's internal entry points, so every allocation in the process (GLib, JSON-GLib) is counted
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static guint64 hb_bench_allocs = 0;
+
+void* malloc(size_t size)
+{
+    __atomic_fetch_add(&hb_bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    __atomic_fetch_add(&hb_bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    __atomic_fetch_add(&hb_bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+
+// ---------------- Synthetic configs ----------------
+
+static const gchar* hb_bench_titles[] = {"Status", "Clock", "Weather", "Alerts"};
+static const gchar* hb_bench_addresses[] = {
+    "https://status.example.com/mini",
+    "hudbox://clock/index.html",
+    "https://weather.example.com/widget?units=metric",
+};
+
+static gchar* hb_bench_write_config(guint n_windows)
+{
+    GString* json = g_string_new("{\n  \"process_model\": \"per-origin\",\n  \"windows\": [\n");
+    for (guint i = 0; i < n_windows; i++)
+    {
+        g_string_append_printf(json,
+                               "    { \"title\": \"%s\", \"address\": \"%s\", \"width\": %u, \"height\": %u, "
+                               "\"opacity\": 0.85, \"transparent\": %s, \"priority\": %u, \"max_fps\": 30 }%s\n",
+                               hb_bench_titles[i % G_N_ELEMENTS(hb_bench_titles)],
+                               hb_bench_addresses[i % G_N_ELEMENTS(hb_bench_addresses)],
+                               200 + i % 800, 80 + i % 400,
+                               i % 2 ? "true" : "false",
+                               i % 5,
+                               i + 1 < n_windows ? "," : "");
+    }
+    g_string_append(json, "  ]\n}\n");
+
+    gchar* path = NULL;
+    gint fd = g_file_open_tmp("hb_config_bench_XXXXXX.json", &path, NULL);
+    g_assert(fd >= 0);
+    close(fd);
+    g_assert(g_file_set_contents(path, json->str, (gssize)json->len, NULL));
+    g_string_free(json, TRUE);
+    return path;
+}
+
+static gint hb_bench_cmp_i64(gconstpointer a, gconstpointer b)
+{
+    gint64 x = *(const gint64*)a, y = *(const gint64*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv)
+{
+    guint repetitions = argc > 1 ? (guint)MAX(atoi(argv[1]), 1) : 0;
+    static const guint sizes[] = {10, 100, 1000, 10000};
+
+    g_print("%8s %8s %12s %12s %12s %14s %12s\n",
+            "windows", "runs", "median_us", "us/window", "allocs", "allocs/window", "arena_kib");
+    for (guint s = 0; s < G_N_ELEMENTS(sizes); s++)
+    {
+        guint n = sizes[s];
+        gchar* path = hb_bench_write_config(n);
+        // Roughly the same total work per size unless overridden
+        guint runs = repetitions ? repetitions : MAX(5, 20000 / n);
+
+        hb_config_set_free(hb_load_configs_from_json_full(path, NULL, NULL)); // warm-up
+
+        gint64* times = g_new(gint64, runs);
+        guint64 allocs = 0;
+        gsize arena_bytes = 0;
+        for (guint r = 0; r < runs; r++)
+        {
+            guint64 allocs_before = __atomic_load_n(&hb_bench_allocs, __ATOMIC_RELAXED);
+            gint64 t0 = g_get_monotonic_time();
+            HbConfigSet* set = hb_load_configs_from_json_full(path, NULL, NULL);
+            times[r] = g_get_monotonic_time() - t0;
+            allocs = __atomic_load_n(&hb_bench_allocs, __ATOMIC_RELAXED) - allocs_before;
+
+            g_assert(set && set->n_windows == n);
+            arena_bytes = hb_arena_get_used(set->arena);
+            hb_config_set_free(set);
+        }
+
+        qsort(times, runs, sizeof(gint64), hb_bench_cmp_i64);
+        gint64 median = times[runs / 2];
+        g_print("%8u %8u %12" G_GINT64_FORMAT " %12.2f %12" G_GUINT64_FORMAT " %14.1f %12.1f\n",
+                n, runs, median, (gdouble)median / n, allocs, (gdouble)allocs / n, arena_bytes / 1024.0);
+
+        g_free(times);
+        g_unlink(path);
+        g_free(path);
+    }
+    return 0;
+}
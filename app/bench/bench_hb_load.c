@@ -0,0 +1,577 @@
+// End-to-end load benchmark: creates windows through hb_create_window() for fixture pages of
+// increasing weight, served by an HTTP server inside the benchmark (no network access needed),
+// and measures time to first paint, time until the load finished, and peak resident memory of
+// HudBox plus its WebKit processes (in total, and averaged over the windows). Results are printed and written as JSON.
+//
+//   hb_load_bench [--windows=N] [--runs=N] [--output=FILE]
+//
+// Needs a display; on machines without one, run it under a virtual one, e.g.
+//   xvfb-run -a ./hb_load_bench   or   weston --backend=headless & WAYLAND_DISPLAY=wayland-1 ./hb_load_bench
+
+#include <gtk/gtk.h>
+#include <webkit/webkit.h>
+#include <json-glib/json-glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/hb_config.h"
+#include "../src/hb_window.h"
+#include "../src/hb_web.h"
+#include "../src/hb_proc.h"
+
+// Give up on a run whose windows haven't all loaded and painted by then
+#define HB_BENCH_RUN_TIMEOUT_S 60
+// Memory sampling period while a run is in progress
+#define HB_BENCH_RSS_SAMPLE_MS 50
+// Pause between runs so closed windows' web processes can exit
+#define HB_BENCH_SETTLE_MS 1000
+
+// ---------------- Fixture pages ----------------
+
+typedef struct
+{
+    const gchar* name;
+    gchar* body; // generated once, before the server starts; read-only afterwards
+    gsize len;
+} HbBenchFixture;
+
+static HbBenchFixture hb_bench_fixtures[] = {{"light"}, {"medium"}, {"heavy"}};
+
+static const gchar* hb_bench_page_head =
+    "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>%s</title><style>\n"
+    "body { font: 14px sans-serif; margin: 0; color: #eee; background: #123; }\n"
+    ".cell { display: inline-block; width: 48px; height: 24px; margin: 1px; border-radius: 4px;\n"
+    "        background: linear-gradient(135deg, #468, #8ac); box-shadow: 0 1px 3px #0008; }\n"
+    "td { padding: 2px 6px; border-bottom: 1px solid #345; }\n"
+    "</style></head><body>\n";
+
+static void hb_bench_build_fixtures(void)
+{
+    // light: a few lines of text, like a clock or status widget
+    GString* light = g_string_new(NULL);
+    g_string_append_printf(light, hb_bench_page_head, "light");
+    g_string_append(light, "<h1>Status</h1><p id=\"t\">All systems nominal.</p>\n"
+                           "<script>document.getElementById('t').textContent += ' ' + Date.now();</script>\n");
+    g_string_append(light, "</body></html>\n");
+
+    // medium: a 500-row table, like a typical dashboard panel
+    GString* medium = g_string_new(NULL);
+    g_string_append_printf(medium, hb_bench_page_head, "medium");
+    g_string_append(medium, "<table>\n");
+    for (guint i = 0; i < 500; i++)
+    {
+        g_string_append_printf(medium, "<tr><td>host-%03u</td><td>%u.%u%%</td><td>%u ms</td><td>ok</td></tr>\n",
+                               i, (i * 37) % 100, i % 10, (i * 13) % 900);
+    }
+    g_string_append(medium, "</table>\n</body></html>\n");
+
+    // heavy: thousands of styled elements, a large JSON blob parsed at load and canvas drawing
+    GString* heavy = g_string_new(NULL);
+    g_string_append_printf(heavy, hb_bench_page_head, "heavy");
+    for (guint i = 0; i < 6000; i++) g_string_append(heavy, "<div class=\"cell\"></div>");
+    g_string_append(heavy, "\n<canvas id=\"c\" width=\"512\" height=\"512\"></canvas>\n<script>\nvar data = [");
+    for (guint i = 0; i < 20000; i++)
+    {
+        g_string_append_printf(heavy, "%s{\"x\":%u,\"y\":%u,\"v\":%u}", i ? "," : "", i % 512, (i * 7) % 512, i % 255);
+    }
+    g_string_append(heavy, "];\n"
+                           "var ctx = document.getElementById('c').getContext('2d');\n"
+                           "data.forEach(function (p) { ctx.fillStyle = 'rgb(' + p.v + ',80,160)';"
+                           " ctx.fillRect(p.x, p.y, 3, 3); });\n"
+                           "document.querySelectorAll('.cell').forEach(function (el, i) {"
+                           " el.style.opacity = 0.5 + (i % 50) / 100; });\n"
+                           "</script>\n</body></html>\n");
+
+    GString* pages[] = {light, medium, heavy};
+    for (guint i = 0; i < G_N_ELEMENTS(hb_bench_fixtures); i++)
+    {
+        hb_bench_fixtures[i].len = pages[i]->len;
+        hb_bench_fixtures[i].body = g_string_free(pages[i], FALSE);
+    }
+}
+
+// ---------------- Local HTTP server ----------------
+
+// Runs in a worker thread of the threaded service: one request per connection
+static gboolean on_http_connection(GThreadedSocketService* service,
+                                   GSocketConnection* connection,
+                                   GObject* source,
+                                   gpointer user_data)
+{
+    GDataInputStream* in = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+    GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+
+    gchar* request = g_data_input_stream_read_line(in, NULL, NULL, NULL);
+    gchar* line;
+    while ((line = g_data_input_stream_read_line(in, NULL, NULL, NULL)) != NULL)
+    {
+        // Headers end with an empty line
+        gboolean end = line[0] == '\0' || g_strcmp0(line, "\r") == 0;
+        g_free(line);
+        if (end) break;
+    }
+
+    const HbBenchFixture* fixture = NULL;
+    gchar** parts = request ? g_strsplit(request, " ", 3) : NULL;
+    if (parts && parts[0] && parts[1] && g_strcmp0(parts[0], "GET") == 0)
+    {
+        for (guint i = 0; i < G_N_ELEMENTS(hb_bench_fixtures); i++)
+        {
+            if (parts[1][0] == '/' && g_strcmp0(parts[1] + 1, hb_bench_fixtures[i].name) == 0)
+            {
+                fixture = &hb_bench_fixtures[i];
+            }
+        }
+    }
+
+    // no-store: every run measures a full load, not WebKit's memory cache
+    gchar* header = fixture
+                        ? g_strdup_printf("HTTP/1.0 200 OK\r\nContent-Type: text/html; charset=utf-8\r\n"
+                                          "Content-Length: %" G_GSIZE_FORMAT "\r\nCache-Control: no-store\r\n"
+                                          "Connection: close\r\n\r\n", fixture->len)
+                        : g_strdup("HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    g_output_stream_write_all(out, header, strlen(header), NULL, NULL, NULL);
+    if (fixture) g_output_stream_write_all(out, fixture->body, fixture->len, NULL, NULL, NULL);
+
+    g_free(header);
+    g_strfreev(parts);
+    g_free(request);
+    g_object_unref(in);
+    return TRUE;
+}
+
+// Listen on an ephemeral loopback port; returns the port, or 0 on failure
+static guint16 hb_bench_start_server(GSocketService** out_service)
+{
+    GSocketService* service = g_threaded_socket_service_new(8);
+    GInetAddress* loopback = g_inet_address_new_loopback(G_SOCKET_FAMILY_IPV4);
+    GSocketAddress* address = g_inet_socket_address_new(loopback, 0);
+    GSocketAddress* effective = NULL;
+    GError* error = NULL;
+    gboolean ok = g_socket_listener_add_address(G_SOCKET_LISTENER(service), address, G_SOCKET_TYPE_STREAM,
+                                                G_SOCKET_PROTOCOL_TCP, NULL, &effective, &error);
+    g_object_unref(address);
+    g_object_unref(loopback);
+    if (!ok)
+    {
+        g_printerr("Cannot start the fixture server: %s\n", error->message);
+        g_error_free(error);
+        g_object_unref(service);
+        return 0;
+    }
+
+    guint16 port = g_inet_socket_address_get_port(G_INET_SOCKET_ADDRESS(effective));
+    g_object_unref(effective);
+    g_signal_connect(service, "run", G_CALLBACK(on_http_connection), NULL);
+    g_socket_service_start(service);
+    *out_service = service;
+    return port;
+}
+
+// ---------------- Measurement ----------------
+
+typedef struct
+{
+    const HbBenchFixture* fixture;
+    gint64 created_us;     // before hb_create_window()
+    gint64 committed_us;   // load committed; 0 = not yet
+    gint64 first_paint_us; // first frame presented after the commit; 0 = not yet
+    gint64 finished_us;    // load finished; 0 = not yet
+    gboolean failed;
+} HbBenchWindow;
+
+typedef struct
+{
+    GtkApplication* app;
+    guint16 port;
+    guint n_windows;
+    guint n_runs;
+    const gchar* output;
+
+    guint run;
+    HbBenchWindow* windows; // n_windows entries for the current run
+    guint pending;          // windows that haven't both finished and painted
+    guint64 peak_rss_kb;
+    guint rss_source;
+    guint timeout_source;
+    JsonBuilder* results;
+    GArray* samples[G_N_ELEMENTS(hb_bench_fixtures)][2]; // per fixture: first paint, load finished (ms)
+    GArray* rss_avg_per_window; // per run, KiB
+} HbBench;
+
+static void hb_bench_start_run(HbBench* bench);
+
+static guint64 hb_bench_total_rss_kb(void)
+{
+    guint64 total = 0;
+    HbProcInfo* self = hb_proc_read(getpid());
+    if (self)
+    {
+        total += self->rss_kb;
+        hb_proc_info_free(self);
+    }
+    GPtrArray* procs = hb_proc_list_descendants();
+    for (guint i = 0; i < procs->len; i++)
+    {
+        total += ((HbProcInfo*)g_ptr_array_index(procs, i))->rss_kb;
+    }
+    g_ptr_array_free(procs, TRUE);
+    return total;
+}
+
+static gboolean on_rss_sample(gpointer user_data)
+{
+    HbBench* bench = user_data;
+    bench->peak_rss_kb = MAX(bench->peak_rss_kb, hb_bench_total_rss_kb());
+    return G_SOURCE_CONTINUE;
+}
+
+static gdouble hb_bench_ms(gint64 from_us, gint64 to_us)
+{
+    return to_us ? (to_us - from_us) / 1000.0 : -1.0;
+}
+
+static void on_bench_load_changed(WebKitWebView* view, WebKitLoadEvent event, gpointer user_data);
+static gboolean on_bench_load_failed(WebKitWebView* view, WebKitLoadEvent event, gchar* uri,
+                                     GError* error, gpointer user_data);
+
+static void hb_bench_close_windows(HbBench* bench)
+{
+    GList* windows = g_list_copy(gtk_application_get_windows(bench->app));
+    for (GList* l = windows; l; l = l->next)
+    {
+        // Views may report a cancelled load while going away; their HbBenchWindow is about to be freed
+        HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+        if (win)
+        {
+            g_signal_handlers_disconnect_matched(win->web_view, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+                                                 on_bench_load_changed, NULL);
+            g_signal_handlers_disconnect_matched(win->web_view, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
+                                                 on_bench_load_failed, NULL);
+        }
+        gtk_window_destroy(GTK_WINDOW(l->data));
+    }
+    g_list_free(windows);
+}
+
+static gboolean on_settled(gpointer user_data)
+{
+    HbBench* bench = user_data;
+    hb_bench_start_run(bench);
+    return G_SOURCE_REMOVE;
+}
+
+static void hb_bench_finish_run(HbBench* bench, gboolean timed_out)
+{
+    g_clear_handle_id(&bench->rss_source, g_source_remove);
+    g_clear_handle_id(&bench->timeout_source, g_source_remove);
+    on_rss_sample(bench);
+
+    JsonBuilder* b = bench->results;
+    json_builder_begin_object(b);
+    json_builder_set_member_name(b, "run");
+    json_builder_add_int_value(b, bench->run);
+    json_builder_set_member_name(b, "timed_out");
+    json_builder_add_boolean_value(b, timed_out);
+    json_builder_set_member_name(b, "peak_rss_kb");
+    json_builder_add_int_value(b, (gint64)bench->peak_rss_kb);
+    // An average, not any one window's footprint: WebKit doesn't say which web process serves a
+    // view, and views may share one, so only the total can be measured
+    json_builder_set_member_name(b, "peak_rss_kb_avg_per_window");
+    gdouble avg_per_window = (gdouble)bench->peak_rss_kb / bench->n_windows;
+    json_builder_add_double_value(b, avg_per_window);
+    json_builder_set_member_name(b, "windows");
+    json_builder_begin_array(b);
+    for (guint i = 0; i < bench->n_windows; i++)
+    {
+        const HbBenchWindow* w = &bench->windows[i];
+        gdouble paint_ms = hb_bench_ms(w->created_us, w->first_paint_us);
+        gdouble finish_ms = hb_bench_ms(w->created_us, w->finished_us);
+        json_builder_begin_object(b);
+        json_builder_set_member_name(b, "fixture");
+        json_builder_add_string_value(b, w->fixture->name);
+        json_builder_set_member_name(b, "first_paint_ms");
+        json_builder_add_double_value(b, paint_ms);
+        json_builder_set_member_name(b, "load_finished_ms");
+        json_builder_add_double_value(b, finish_ms);
+        json_builder_set_member_name(b, "failed");
+        json_builder_add_boolean_value(b, w->failed);
+        json_builder_end_object(b);
+
+        guint f = (guint)(w->fixture - hb_bench_fixtures);
+        if (paint_ms >= 0) g_array_append_val(bench->samples[f][0], paint_ms);
+        if (finish_ms >= 0 && !w->failed) g_array_append_val(bench->samples[f][1], finish_ms);
+    }
+    json_builder_end_array(b);
+    json_builder_end_object(b);
+    g_array_append_val(bench->rss_avg_per_window, avg_per_window);
+
+    g_print("run %u/%u: peak %.1f MiB (average %.1f MiB/window)%s\n", bench->run + 1, bench->n_runs,
+            bench->peak_rss_kb / 1024.0, avg_per_window / 1024.0, timed_out ? ", timed out" : "");
+
+    hb_bench_close_windows(bench);
+    g_clear_pointer(&bench->windows, g_free);
+    bench->run++;
+    g_timeout_add(HB_BENCH_SETTLE_MS, on_settled, bench);
+}
+
+static void hb_bench_window_progress(HbBench* bench, HbBenchWindow* w)
+{
+    if (!w->finished_us || !w->first_paint_us) return;
+    if (--bench->pending == 0) hb_bench_finish_run(bench, FALSE);
+}
+
+static void on_bench_load_changed(WebKitWebView* view, WebKitLoadEvent event, gpointer user_data)
+{
+    HbBenchWindow* w = user_data;
+    if (event == WEBKIT_LOAD_COMMITTED && !w->committed_us) w->committed_us = g_get_monotonic_time();
+}
+
+static gboolean on_bench_load_failed(WebKitWebView* view, WebKitLoadEvent event, gchar* uri,
+                                     GError* error, gpointer user_data)
+{
+    HbBenchWindow* w = user_data;
+    w->failed = TRUE;
+    return FALSE;
+}
+
+static void on_bench_after_paint(GdkFrameClock* clock, gpointer user_data)
+{
+    HbWindow* win = hb_window_from_widget(GTK_WIDGET(user_data));
+    HbBench* bench = win ? g_object_get_data(G_OBJECT(user_data), "hb-bench") : NULL;
+    if (!bench || !bench->windows) return;
+    HbBenchWindow* w = &bench->windows[GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(user_data), "hb-bench-index"))];
+    if (!w->committed_us || w->first_paint_us) return;
+    w->first_paint_us = g_get_monotonic_time();
+    hb_bench_window_progress(bench, w);
+}
+
+static void on_bench_window_realize(GtkWidget* window, gpointer user_data)
+{
+    GdkFrameClock* clock = gtk_widget_get_frame_clock(window);
+    if (clock) g_signal_connect_object(clock, "after-paint", G_CALLBACK(on_bench_after_paint), window, 0);
+}
+
+static void on_bench_load_done(HbWindow* win, gboolean finished, gpointer user_data)
+{
+    HbBench* bench = user_data;
+    if (!finished || !bench->windows) return;
+    HbBenchWindow* w = &bench->windows[GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(win->window), "hb-bench-index"))];
+    w->finished_us = g_get_monotonic_time();
+    hb_bench_window_progress(bench, w);
+}
+
+static gboolean on_run_timeout(gpointer user_data)
+{
+    HbBench* bench = user_data;
+    bench->timeout_source = 0;
+    hb_bench_finish_run(bench, TRUE);
+    return G_SOURCE_REMOVE;
+}
+
+static gint hb_bench_cmp_double(gconstpointer a, gconstpointer b)
+{
+    gdouble x = *(const gdouble*)a, y = *(const gdouble*)b;
+    return (x > y) - (x < y);
+}
+
+static gdouble hb_bench_median(GArray* values)
+{
+    if (values->len == 0) return -1.0;
+    g_array_sort(values, hb_bench_cmp_double);
+    return g_array_index(values, gdouble, values->len / 2);
+}
+
+static void hb_bench_start_run(HbBench* bench)
+{
+    if (bench->run == bench->n_runs)
+    {
+        g_application_release(G_APPLICATION(bench->app));
+        return;
+    }
+
+    bench->windows = g_new0(HbBenchWindow, bench->n_windows);
+    bench->pending = bench->n_windows;
+    bench->peak_rss_kb = 0;
+    bench->rss_source = g_timeout_add(HB_BENCH_RSS_SAMPLE_MS, on_rss_sample, bench);
+    bench->timeout_source = g_timeout_add_seconds(HB_BENCH_RUN_TIMEOUT_S, on_run_timeout, bench);
+
+    for (guint i = 0; i < bench->n_windows; i++)
+    {
+        HbBenchWindow* w = &bench->windows[i];
+        w->fixture = &hb_bench_fixtures[i % G_N_ELEMENTS(hb_bench_fixtures)];
+
+        HbWindowCfg cfg;
+        hb_window_cfg_init_defaults(&cfg);
+        g_free(cfg.title);
+        cfg.title = g_strdup_printf("bench-%u-%s", i, w->fixture->name);
+        g_free(cfg.address);
+        cfg.address = g_strdup_printf("http://127.0.0.1:%u/%s", bench->port, w->fixture->name);
+        cfg.width = 640;
+        cfg.height = 480;
+        cfg.ephemeral = TRUE;
+
+        w->created_us = g_get_monotonic_time();
+        // Created without loading so the signals below are connected before anything happens
+        HbWindow* win = hb_create_window_full(bench->app, &cfg, FALSE);
+        hb_window_cfg_clear(&cfg);
+
+        g_object_set_data(G_OBJECT(win->window), "hb-bench", bench);
+        g_object_set_data(G_OBJECT(win->window), "hb-bench-index", GUINT_TO_POINTER(i));
+        g_signal_connect(win->web_view, "load-changed", G_CALLBACK(on_bench_load_changed), w);
+        g_signal_connect(win->web_view, "load-failed", G_CALLBACK(on_bench_load_failed), w);
+        if (gtk_widget_get_realized(GTK_WIDGET(win->window)))
+        {
+            on_bench_window_realize(GTK_WIDGET(win->window), NULL);
+        }
+        else
+        {
+            g_signal_connect(win->window, "realize", G_CALLBACK(on_bench_window_realize), NULL);
+        }
+        hb_window_set_load_done_func(win, on_bench_load_done, bench);
+        hb_window_load(win);
+    }
+}
+
+static void on_bench_activate(GtkApplication* app, gpointer user_data)
+{
+    HbBench* bench = user_data;
+    g_application_hold(G_APPLICATION(app));
+    hb_bench_start_run(bench);
+}
+
+static gboolean hb_bench_write_results(HbBench* bench)
+{
+    JsonBuilder* b = json_builder_new();
+    json_builder_begin_object(b);
+    json_builder_set_member_name(b, "windows");
+    json_builder_add_int_value(b, bench->n_windows);
+    json_builder_set_member_name(b, "runs");
+    json_builder_add_int_value(b, bench->n_runs);
+
+    json_builder_set_member_name(b, "fixtures");
+    json_builder_begin_object(b);
+    for (guint f = 0; f < G_N_ELEMENTS(hb_bench_fixtures); f++)
+    {
+        json_builder_set_member_name(b, hb_bench_fixtures[f].name);
+        json_builder_begin_object(b);
+        json_builder_set_member_name(b, "bytes");
+        json_builder_add_int_value(b, (gint64)hb_bench_fixtures[f].len);
+        json_builder_set_member_name(b, "first_paint_ms_median");
+        json_builder_add_double_value(b, hb_bench_median(bench->samples[f][0]));
+        json_builder_set_member_name(b, "load_finished_ms_median");
+        json_builder_add_double_value(b, hb_bench_median(bench->samples[f][1]));
+        json_builder_end_object(b);
+    }
+    json_builder_end_object(b);
+
+    json_builder_set_member_name(b, "peak_rss_kb_avg_per_window_median");
+    json_builder_add_double_value(b, hb_bench_median(bench->rss_avg_per_window));
+
+    json_builder_end_array(bench->results);
+    json_builder_set_member_name(b, "results");
+    json_builder_add_value(b, json_builder_get_root(bench->results));
+    json_builder_end_object(b);
+
+    JsonGenerator* gen = json_generator_new();
+    json_generator_set_pretty(gen, TRUE);
+    JsonNode* root = json_builder_get_root(b);
+    json_generator_set_root(gen, root);
+    GError* error = NULL;
+    gboolean ok = json_generator_to_file(gen, bench->output, &error);
+    if (!ok)
+    {
+        g_printerr("Cannot write %s: %s\n", bench->output, error->message);
+        g_error_free(error);
+    }
+    json_node_unref(root);
+    g_object_unref(gen);
+    g_object_unref(b);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    gint n_windows = 6, n_runs = 3;
+    gchar* output = NULL;
+    GOptionEntry entries[] = {
+        {"windows", 'n', 0, G_OPTION_ARG_INT, &n_windows, "Windows per run (fixtures alternate)", "N"},
+        {"runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of runs", "N"},
+        {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "JSON results file (default: hb_load_bench.json)", "FILE"},
+        {NULL},
+    };
+    GOptionContext* options = g_option_context_new("- HudBox load-latency benchmark");
+    g_option_context_add_main_entries(options, entries, NULL);
+    GError* error = NULL;
+    if (!g_option_context_parse(options, &argc, &argv, &error))
+    {
+        g_printerr("%s\n", error->message);
+        return 2;
+    }
+    g_option_context_free(options);
+
+    if (!gtk_init_check())
+    {
+        g_printerr("No display; run under a virtual one, e.g. `xvfb-run -a %s`\n", argv[0]);
+        return 77;
+    }
+
+    HbBench bench = {0};
+    bench.n_windows = (guint)MAX(n_windows, 1);
+    bench.n_runs = (guint)MAX(n_runs, 1);
+    bench.output = output ? output : "hb_load_bench.json";
+    for (guint f = 0; f < G_N_ELEMENTS(hb_bench_fixtures); f++)
+    {
+        bench.samples[f][0] = g_array_new(FALSE, FALSE, sizeof(gdouble));
+        bench.samples[f][1] = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    }
+    bench.rss_avg_per_window = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    bench.results = json_builder_new();
+    json_builder_begin_array(bench.results);
+
+    hb_bench_build_fixtures();
+    GSocketService* server = NULL;
+    bench.port = hb_bench_start_server(&server);
+    if (bench.port == 0) return 1;
+
+    // Keep website data away from the user's profile
+    gchar* data_dir = g_dir_make_tmp("hb_load_bench_XXXXXX", NULL);
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    app_cfg.data_dir = g_build_filename(data_dir, "data", NULL);
+    app_cfg.cache_dir = g_build_filename(data_dir, "cache", NULL);
+    app_cfg.max_cache_mb = 0;
+    hb_web_init(&app_cfg);
+    hb_app_cfg_clear(&app_cfg);
+
+    bench.app = gtk_application_new("me.stegall.hudbox.bench", G_APPLICATION_NON_UNIQUE);
+    g_signal_connect(bench.app, "activate", G_CALLBACK(on_bench_activate), &bench);
+    g_application_run(G_APPLICATION(bench.app), 0, NULL);
+
+    g_print("\n%8s %10s %16s %20s\n", "fixture", "bytes", "first_paint_ms", "load_finished_ms");
+    for (guint f = 0; f < G_N_ELEMENTS(hb_bench_fixtures); f++)
+    {
+        g_print("%8s %10" G_GSIZE_FORMAT " %16.1f %20.1f\n", hb_bench_fixtures[f].name, hb_bench_fixtures[f].len,
+                hb_bench_median(bench.samples[f][0]), hb_bench_median(bench.samples[f][1]));
+    }
+    g_print("peak RSS, average per window (median of runs): %.1f MiB\n",
+            hb_bench_median(bench.rss_avg_per_window) / 1024.0);
+    gboolean ok = hb_bench_write_results(&bench);
+    if (ok) g_print("Results written to %s\n", bench.output);
+
+    g_socket_service_stop(server);
+    g_object_unref(server);
+    g_object_unref(bench.app);
+    g_object_unref(bench.results);
+    for (guint f = 0; f < G_N_ELEMENTS(hb_bench_fixtures); f++)
+    {
+        g_array_free(bench.samples[f][0], TRUE);
+        g_array_free(bench.samples[f][1], TRUE);
+        g_free(hb_bench_fixtures[f].body);
+    }
+    g_array_free(bench.rss_avg_per_window, TRUE);
+    g_free(data_dir);
+    g_free(output);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include "hb_arena.h"
+#include <string.h>
+
+#define HB_ARENA_DEFAULT_BLOCK_SIZE (16 * 1024)
+#define HB_ARENA_ALIGN (2 * sizeof(gpointer))
+
+typedef struct HbArenaBlock
+{
+    struct HbArenaBlock* next;
+    gsize size; // usable bytes after the header
+    gsize used;
+} HbArenaBlock;
+
+// Usable memory starts after the header, rounded up to the alignment
+#define HB_ARENA_HEADER_SIZE ((sizeof(HbArenaBlock) + HB_ARENA_ALIGN - 1) & ~(HB_ARENA_ALIGN - 1))
+#define HB_ARENA_BLOCK_DATA(block) ((guint8*)(block) + HB_ARENA_HEADER_SIZE)
+
+struct HbArena
+{
+    HbArenaBlock* blocks; // current block first
+    gsize block_size;
+    gsize used;
+    GHashTable* interned; // string -> the same string, both in the arena; created on first use
+};
+
+HbArena* hb_arena_new(gsize block_size)
+{
+    HbArena* arena = g_new0(HbArena, 1);
+    arena->block_size = block_size > 0 ? block_size : HB_ARENA_DEFAULT_BLOCK_SIZE;
+    return arena;
+}
+
+void hb_arena_free(HbArena* arena)
+{
+    if (!arena) return;
+    if (arena->interned) g_hash_table_unref(arena->interned);
+    HbArenaBlock* block = arena->blocks;
+    while (block)
+    {
+        HbArenaBlock* next = block->next;
+        g_free(block);
+        block = next;
+    }
+    g_free(arena);
+}
+
+static HbArenaBlock* hb_arena_block_new(gsize size)
+{
+    HbArenaBlock* block = g_malloc0(HB_ARENA_HEADER_SIZE + size);
+    block->size = size;
+    return block;
+}
+
+gpointer hb_arena_alloc(HbArena* arena, gsize size)
+{
+    g_return_val_if_fail(arena != NULL, NULL);
+    size = (MAX(size, 1) + HB_ARENA_ALIGN - 1) & ~(HB_ARENA_ALIGN - 1);
+    arena->used += size;
+
+    HbArenaBlock* block = arena->blocks;
+    if (block && block->size - block->used >= size)
+    {
+        gpointer p = HB_ARENA_BLOCK_DATA(block) + block->used;
+        block->used += size;
+        return p;
+    }
+
+    if (size > arena->block_size / 4)
+    {
+        // Too big to share a block: give it its own, behind the current one so that block
+        // keeps serving small allocations
+        HbArenaBlock* big = hb_arena_block_new(size);
+        big->used = size;
+        if (block)
+        {
+            big->next = block->next;
+            block->next = big;
+        }
+        else
+        {
+            arena->blocks = big;
+        }
+        return HB_ARENA_BLOCK_DATA(big);
+    }
+
+    block = hb_arena_block_new(arena->block_size);
+    block->next = arena->blocks;
+    arena->blocks = block;
+    block->used = size;
+    return HB_ARENA_BLOCK_DATA(block);
+}
+
+gchar* hb_arena_strdup(HbArena* arena, const gchar* str)
+{
+    if (!str) return NULL;
+    gsize len = strlen(str);
+    gchar* copy = hb_arena_alloc(arena, len + 1);
+    memcpy(copy, str, len); // terminator: arena memory is zeroed
+    return copy;
+}
+
+gchar* hb_arena_intern(HbArena* arena, const gchar* str)
+{
+    if (!str) return NULL;
+    if (!arena->interned) arena->interned = g_hash_table_new(g_str_hash, g_str_equal);
+    gchar* interned = g_hash_table_lookup(arena->interned, str);
+    if (!interned)
+    {
+        interned = hb_arena_strdup(arena, str);
+        g_hash_table_add(arena->interned, interned);
+    }
+    return interned;
+}
+
+gsize hb_arena_get_used(const HbArena* arena)
+{
+    return arena ? arena->used : 0;
+}
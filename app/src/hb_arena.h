@@ -0,0 +1,30 @@
+#ifndef HB_ARENA_H
+#define HB_ARENA_H
+
+#include <glib.h>
+
+// ---------------- Arena allocator ----------------
+
+// Bump allocator for data that lives and dies together (e.g. a parsed configuration). Memory is
+// handed out from large blocks and only released all at once by hb_arena_free().
+typedef struct HbArena HbArena;
+
+// block_size: bytes per block (0 = default). Larger allocations get a block of their own.
+HbArena* hb_arena_new(gsize block_size);
+void hb_arena_free(HbArena* arena);
+
+// size bytes of zeroed memory, aligned for any type.
+gpointer hb_arena_alloc(HbArena* arena, gsize size);
+#define hb_arena_new0(arena, type, n) ((type*)hb_arena_alloc((arena), sizeof(type) * (n)))
+
+// Copy of str in the arena. NULL for NULL.
+gchar* hb_arena_strdup(HbArena* arena, const gchar* str);
+
+// Arena copy of str shared by every equal string interned in the same arena. Must not be
+// modified. NULL for NULL.
+gchar* hb_arena_intern(HbArena* arena, const gchar* str);
+
+// Bytes handed out so far (including alignment padding).
+gsize hb_arena_get_used(const HbArena* arena);
+
+#endif // HB_ARENA_H
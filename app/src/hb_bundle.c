@@ -0,0 +1,230 @@
+#include "hb_bundle.h"
+#include "hb_lru.h"
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+struct HbBundle
+{
+    gchar* root;
+    HbLru* cache; // resolved file path -> HbBundleFile*; NULL when caching is disabled
+};
+
+typedef struct
+{
+    GBytes* bytes; // backed by the file mapping
+    gint64 mtime;
+    goffset size;
+} HbBundleFile;
+
+static void hb_bundle_file_free(gpointer data)
+{
+    HbBundleFile* f = data;
+    g_bytes_unref(f->bytes);
+    g_free(f);
+}
+
+HbBundle* hb_bundle_new(const gchar* root, guint64 cache_bytes)
+{
+    HbBundle* bundle = g_new0(HbBundle, 1);
+    bundle->root = g_strdup(root);
+    if (cache_bytes > 0) bundle->cache = hb_lru_new(cache_bytes, hb_bundle_file_free);
+    return bundle;
+}
+
+void hb_bundle_free(HbBundle* bundle)
+{
+    if (!bundle) return;
+    hb_lru_free(bundle->cache);
+    g_free(bundle->root);
+    g_free(bundle);
+}
+
+void hb_bundle_set_root(HbBundle* bundle, const gchar* root)
+{
+    if (!bundle || g_strcmp0(bundle->root, root) == 0) return;
+    g_free(bundle->root);
+    bundle->root = g_strdup(root);
+    hb_lru_clear(bundle->cache);
+}
+
+// A single decoded path segment that names an entry inside its parent directory
+static gboolean hb_bundle_segment_ok(const gchar* segment)
+{
+    return segment && *segment &&
+           strcmp(segment, ".") != 0 && strcmp(segment, "..") != 0 &&
+           !strchr(segment, '/') && !strchr(segment, '\\');
+}
+
+gchar* hb_bundle_resolve(const gchar* root, const gchar* host, const gchar* path)
+{
+    if (!root || !hb_bundle_segment_ok(host)) return NULL;
+
+    GPtrArray* parts = g_ptr_array_new_with_free_func(g_free);
+    g_ptr_array_add(parts, g_strdup(root));
+    g_ptr_array_add(parts, g_strdup(host));
+
+    gboolean ok = TRUE;
+    gchar** segments = g_strsplit(path ? path : "", "/", -1);
+    for (guint i = 0; ok && segments[i]; i++)
+    {
+        // Empty and "." segments ("a//b", "./a") don't move anywhere
+        if (segments[i][0] == '\0' || strcmp(segments[i], ".") == 0) continue;
+        gchar* decoded = g_uri_unescape_string(segments[i], "/");
+        ok = hb_bundle_segment_ok(decoded);
+        if (ok) g_ptr_array_add(parts, decoded);
+        else g_free(decoded);
+    }
+    g_strfreev(segments);
+
+    gchar* resolved = NULL;
+    if (ok)
+    {
+        if (!path || !*path || g_str_has_suffix(path, "/")) g_ptr_array_add(parts, g_strdup("index.html"));
+        g_ptr_array_add(parts, NULL);
+        resolved = g_build_filenamev((gchar**)parts->pdata);
+    }
+    g_ptr_array_free(parts, TRUE);
+    return resolved;
+}
+
+typedef struct
+{
+    const gchar* ext;
+    const gchar* mime;
+} HbMimeEntry;
+
+// Types pages actually request; the shared-mime-info database lacks several (mjs, wasm, map)
+static const HbMimeEntry hb_mime_types[] = {
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"css", "text/css"},
+    {"js", "text/javascript"},
+    {"mjs", "text/javascript"},
+    {"json", "application/json"},
+    {"map", "application/json"},
+    {"wasm", "application/wasm"},
+    {"svg", "image/svg+xml"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"avif", "image/avif"},
+    {"ico", "image/vnd.microsoft.icon"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"ttf", "font/ttf"},
+    {"otf", "font/otf"},
+    {"txt", "text/plain"},
+    {"xml", "application/xml"},
+    {"mp4", "video/mp4"},
+    {"webm", "video/webm"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/ogg"},
+    {"wav", "audio/wav"},
+};
+
+const gchar* hb_bundle_mime_type(const gchar* filename)
+{
+    const gchar* dot = filename ? strrchr(filename, '.') : NULL;
+    if (dot && !strchr(dot, '/'))
+    {
+        for (guint i = 0; i < G_N_ELEMENTS(hb_mime_types); i++)
+        {
+            if (g_ascii_strcasecmp(dot + 1, hb_mime_types[i].ext) == 0) return hb_mime_types[i].mime;
+        }
+    }
+    return "application/octet-stream";
+}
+
+// file with every symlink resolved, if that is still below root (resolved as well); NULL otherwise.
+// hb_bundle_resolve() only keeps names inside root, symlinks in the tree could point anywhere.
+static gchar* hb_bundle_real_path(const gchar* root, const gchar* file)
+{
+    char* real_root = realpath(root, NULL);
+    char* real_file = realpath(file, NULL);
+    gchar* contained = NULL;
+    if (real_root && real_file)
+    {
+        gsize n = strlen(real_root);
+        // Only "/" itself ends in a separator
+        if (strncmp(real_file, real_root, n) == 0 && (real_file[n] == '/' || real_root[n - 1] == '/'))
+        {
+            contained = g_strdup(real_file);
+        }
+    }
+    free(real_root);
+    free(real_file);
+    return contained;
+}
+
+GBytes* hb_bundle_read(HbBundle* bundle,
+                       const gchar* host,
+                       const gchar* path,
+                       const gchar** mime_type,
+                       GError** error)
+{
+    gchar* file = bundle ? hb_bundle_resolve(bundle->root, host, path) : NULL;
+    if (!file)
+    {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_PERM, "Invalid bundle path %s%s", host ? host : "", path ? path : "");
+        return NULL;
+    }
+
+    GStatBuf st;
+    if (g_stat(file, &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        // hudbox://status/docs -> docs/index.html
+        gchar* index = g_build_filename(file, "index.html", NULL);
+        g_free(file);
+        file = index;
+    }
+    if (g_stat(file, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_NOENT, "No such bundle file: %s", file);
+        g_free(file);
+        return NULL;
+    }
+    // Typed by the requested name; mapped and cached under the real one
+    if (mime_type) *mime_type = hb_bundle_mime_type(file);
+    gchar* real = hb_bundle_real_path(bundle->root, file);
+    if (!real)
+    {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_PERM, "Bundle file %s is outside %s", file, bundle->root);
+        g_free(file);
+        return NULL;
+    }
+    g_free(file);
+    file = real;
+
+    // A cached mapping is only reused while the file is unchanged; rewritten files are re-mapped
+    HbBundleFile* cached = hb_lru_lookup(bundle->cache, file);
+    if (cached && cached->mtime == (gint64)st.st_mtime && cached->size == (goffset)st.st_size)
+    {
+        g_free(file);
+        return g_bytes_ref(cached->bytes);
+    }
+
+    GMappedFile* mapped = g_mapped_file_new(file, FALSE, error);
+    if (!mapped)
+    {
+        g_free(file);
+        return NULL;
+    }
+    // The bytes keep the mapping alive on their own
+    GBytes* bytes = g_mapped_file_get_bytes(mapped);
+    g_mapped_file_unref(mapped);
+
+    if (bundle->cache)
+    {
+        HbBundleFile* f = g_new0(HbBundleFile, 1);
+        f->bytes = g_bytes_ref(bytes);
+        f->mtime = (gint64)st.st_mtime;
+        f->size = (goffset)st.st_size;
+        hb_lru_insert(bundle->cache, file, f, (guint64)st.st_size);
+    }
+    g_free(file);
+    return bytes;
+}
@@ -0,0 +1,36 @@
+#ifndef HB_BUNDLE_H
+#define HB_BUNDLE_H
+
+#include <glib.h>
+
+// ---------------- Local page bundles (hudbox://) ----------------
+
+// Serves files below a root directory: hudbox://status/index.html maps to <root>/status/index.html.
+// File contents are memory-mapped (responses reference the mapping, nothing is copied) and
+// recently served files stay mapped in a size-bounded cache.
+typedef struct HbBundle HbBundle;
+
+HbBundle* hb_bundle_new(const gchar* root, guint64 cache_bytes);
+void hb_bundle_free(HbBundle* bundle);
+
+// Point the bundle at another root directory; drops cached files if it changed.
+void hb_bundle_set_root(HbBundle* bundle, const gchar* root);
+
+// Map host (the bundle name) and the percent-encoded URI path onto a file below root.
+// Empty paths and paths ending in '/' resolve to index.html. Returns NULL for names that would
+// leave root ("..", encoded slashes, NUL bytes). Free with g_free().
+gchar* hb_bundle_resolve(const gchar* root, const gchar* host, const gchar* path);
+
+// MIME type for a file name, from its extension. Never NULL.
+const gchar* hb_bundle_mime_type(const gchar* filename);
+
+// Contents of the file for host/path, served from the cache when it is unchanged on disk.
+// Symlinks are followed only as long as they lead to a file below root.
+// *mime_type (optional) receives a static string. Returns NULL with error set (G_FILE_ERROR) on failure.
+GBytes* hb_bundle_read(HbBundle* bundle,
+                       const gchar* host,
+                       const gchar* path,
+                       const gchar** mime_type,
+                       GError** error);
+
+#endif // HB_BUNDLE_H
@@ -0,0 +1,144 @@
+#include "hb_cache.h"
+#include <glib/gstdio.h>
+#include <sys/stat.h>
+
+typedef struct
+{
+    gchar* path;
+    guint64 size;
+    gint64 mtime;
+    gchar* inode; // "dev:ino", shared by hard links to the same file
+} HbCacheFile;
+
+static void hb_cache_file_free(gpointer data)
+{
+    HbCacheFile* f = data;
+    g_free(f->path);
+    g_free(f->inode);
+    g_free(f);
+}
+
+static void hb_cache_collect(const gchar* dir, GPtrArray* out)
+{
+    GDir* d = g_dir_open(dir, 0, NULL);
+    if (!d) return;
+
+    const gchar* name;
+    while ((name = g_dir_read_name(d)) != NULL)
+    {
+        gchar* path = g_build_filename(dir, name, NULL);
+        GStatBuf st;
+        if (g_lstat(path, &st) != 0)
+        {
+            g_free(path);
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            hb_cache_collect(path, out);
+            g_free(path);
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            HbCacheFile* f = g_new0(HbCacheFile, 1);
+            f->path = path; // take ownership
+            f->size = (guint64)st.st_size;
+            f->mtime = (gint64)st.st_mtime;
+            f->inode = g_strdup_printf("%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT, (guint64)st.st_dev,
+                                       (guint64)st.st_ino);
+            g_ptr_array_add(out, f);
+        }
+        else
+        {
+            g_free(path);
+        }
+    }
+    g_dir_close(d);
+}
+
+// Only the entries of WebKit's HTTP cache: <dir>/WebKitCache/<version>/{Records,Blobs}. The
+// version's salt must survive (a new salt orphans every record), and other files in the
+// directory (e.g. HSTS storage) aren't cache at all.
+static void hb_cache_collect_entries(const gchar* dir, GPtrArray* out)
+{
+    gchar* webkit_dir = g_build_filename(dir, "WebKitCache", NULL);
+    GDir* d = g_dir_open(webkit_dir, 0, NULL);
+    if (d)
+    {
+        const gchar* version;
+        while ((version = g_dir_read_name(d)) != NULL)
+        {
+            gchar* records = g_build_filename(webkit_dir, version, "Records", NULL);
+            gchar* blobs = g_build_filename(webkit_dir, version, "Blobs", NULL);
+            hb_cache_collect(records, out);
+            hb_cache_collect(blobs, out);
+            g_free(records);
+            g_free(blobs);
+        }
+        g_dir_close(d);
+    }
+    g_free(webkit_dir);
+}
+
+// Links to each inode among files; the sum of sizes counting every inode once
+static guint64 hb_cache_count_links(GPtrArray* files, GHashTable* links)
+{
+    guint64 total = 0;
+    for (guint i = 0; i < files->len; i++)
+    {
+        HbCacheFile* f = g_ptr_array_index(files, i);
+        guint n = GPOINTER_TO_UINT(g_hash_table_lookup(links, f->inode));
+        if (n == 0) total += f->size;
+        g_hash_table_insert(links, f->inode, GUINT_TO_POINTER(n + 1));
+    }
+    return total;
+}
+
+guint64 hb_cache_dir_size(const gchar* dir)
+{
+    if (!dir) return 0;
+    GPtrArray* files = g_ptr_array_new_with_free_func(hb_cache_file_free);
+    hb_cache_collect_entries(dir, files);
+
+    GHashTable* links = g_hash_table_new(g_str_hash, g_str_equal);
+    guint64 total = hb_cache_count_links(files, links);
+    g_hash_table_unref(links);
+    g_ptr_array_free(files, TRUE);
+    return total;
+}
+
+static gint hb_cache_file_oldest_first(gconstpointer a, gconstpointer b)
+{
+    const HbCacheFile* fa = *(HbCacheFile* const*)a;
+    const HbCacheFile* fb = *(HbCacheFile* const*)b;
+    return (fa->mtime > fb->mtime) - (fa->mtime < fb->mtime);
+}
+
+guint64 hb_cache_prune(const gchar* dir, guint64 max_bytes)
+{
+    if (!dir) return 0;
+    GPtrArray* files = g_ptr_array_new_with_free_func(hb_cache_file_free);
+    hb_cache_collect_entries(dir, files);
+
+    GHashTable* links = g_hash_table_new(g_str_hash, g_str_equal);
+    guint64 total = hb_cache_count_links(files, links);
+
+    guint64 removed = 0;
+    if (total > max_bytes)
+    {
+        g_ptr_array_sort(files, hb_cache_file_oldest_first);
+        for (guint i = 0; i < files->len && total - removed > max_bytes; i++)
+        {
+            HbCacheFile* f = g_ptr_array_index(files, i);
+            if (g_unlink(f->path) != 0) continue;
+            // The space comes back with the inode's last link
+            guint n = GPOINTER_TO_UINT(g_hash_table_lookup(links, f->inode)) - 1;
+            g_hash_table_insert(links, f->inode, GUINT_TO_POINTER(n));
+            if (n == 0) removed += f->size;
+        }
+    }
+
+    g_hash_table_unref(links);
+    g_ptr_array_free(files, TRUE);
+    return removed;
+}
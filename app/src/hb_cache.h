@@ -0,0 +1,17 @@
+#ifndef HB_CACHE_H
+#define HB_CACHE_H
+
+#include <glib.h>
+
+// ---------------- Disk cache housekeeping ----------------
+
+// Size in bytes of the HTTP cache entries (WebKitCache/<version>/Records and Blobs) below the
+// cache directory dir, counting hard-linked files once. 0 if there are none.
+guint64 hb_cache_dir_size(const gchar* dir);
+
+// Delete the least recently modified HTTP cache entries below dir until they take at most
+// max_bytes. The cache's salt and files that aren't cache entries are left alone. Must run before
+// WebKit opens the cache. Returns the number of bytes freed.
+guint64 hb_cache_prune(const gchar* dir, guint64 max_bytes);
+
+#endif // HB_CACHE_H
@@ -0,0 +1,170 @@
+#include "hb_carousel.h"
+#include "hb_freeze.h"
+#include "hb_trace.h"
+#include <webkit/webkit.h>
+
+static guint hb_carousel_length(const HbWindow* win)
+{
+    return win->cfg.addresses ? g_strv_length(win->cfg.addresses) : 0;
+}
+
+gboolean hb_carousel_is_enabled(const HbWindow* win)
+{
+    return win && hb_carousel_length(win) > 1;
+}
+
+static const gchar* hb_carousel_next_address(const HbWindow* win)
+{
+    return win->cfg.addresses[(win->carousel_index + 1) % hb_carousel_length(win)];
+}
+
+static gboolean on_carousel_dwell(gpointer user_data);
+
+static void hb_carousel_arm(HbWindow* win)
+{
+    g_clear_handle_id(&win->carousel_source, g_source_remove);
+    win->carousel_due = FALSE;
+    win->carousel_source = g_timeout_add_seconds(MAX(win->cfg.dwell, 1), on_carousel_dwell, win);
+}
+
+// Show the preloaded page, and preload the one after it in the view that was shown
+static void hb_carousel_advance(HbWindow* win)
+{
+    hb_freeze_thaw(win);
+    GtkWidget* shown = win->web_view;
+    GtkEventController* shown_drag = win->drag;
+
+    // Keep the outgoing view (and its web process) for the next page
+    g_object_ref(shown);
+    win->web_view = win->carousel_next;
+    win->drag = win->carousel_drag;
+    gtk_event_controller_set_propagation_phase(win->drag, win->cfg.locked ? GTK_PHASE_NONE : GTK_PHASE_BUBBLE);
+    gtk_widget_set_visible(win->web_view, !win->hidden);
+    hb_window_set_content(win, win->web_view);
+    g_object_unref(win->web_view); // the window holds it now
+
+    win->carousel_next = shown;
+    win->carousel_drag = shown_drag;
+    win->carousel_ready = FALSE;
+    win->carousel_index = (win->carousel_index + 1) % hb_carousel_length(win);
+    // The page subscribed to pushes while it was loading out of sight, if at all
+    win->push_subscribed = GPOINTER_TO_INT(g_object_get_data(
+        G_OBJECT(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(win->web_view))), "hb-push-subscribed"));
+    hb_trace_instant(win->trace_track, "carousel_advance");
+
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->carousel_next), hb_carousel_next_address(win));
+    // A new page on screen: restart freeze_after's idle period
+    hb_freeze_note_activity(win);
+    hb_carousel_arm(win);
+}
+
+static gboolean on_carousel_dwell(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    win->carousel_source = 0;
+    // Nobody sees a hidden window change pages; keep the current one until it's visible again
+    if (win->hidden || !win->carousel_next)
+    {
+        hb_carousel_arm(win);
+    }
+    else if (win->carousel_ready)
+    {
+        hb_carousel_advance(win);
+    }
+    else
+    {
+        // Changing now would show a half-loaded page: change once it has loaded
+        win->carousel_due = TRUE;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+void hb_carousel_schedule(HbWindow* win)
+{
+    if (!win) return;
+    if (!hb_carousel_is_enabled(win))
+    {
+        hb_carousel_clear(win);
+        return;
+    }
+    hb_carousel_arm(win);
+}
+
+void hb_carousel_load(HbWindow* win)
+{
+    if (!win || !win->web_view) return;
+    guint n = hb_carousel_length(win);
+    if (n == 0) return;
+    if (win->carousel_index >= n) win->carousel_index = 0;
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->web_view), win->cfg.addresses[win->carousel_index]);
+
+    if (n < 2)
+    {
+        hb_carousel_drop_preload(win);
+        return;
+    }
+    if (!win->carousel_next)
+    {
+        // Built like the shown view; hb_window_build_view() points win->drag at the new view's gesture
+        GtkEventController* drag = win->drag;
+        win->carousel_next = g_object_ref_sink(hb_window_build_view(win));
+        win->carousel_drag = win->drag;
+        win->drag = drag;
+    }
+    win->carousel_ready = FALSE;
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->carousel_next), hb_carousel_next_address(win));
+}
+
+void hb_carousel_note_preload(HbWindow* win, WebKitLoadEvent load_event)
+{
+    WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(win->carousel_next));
+    switch (load_event)
+    {
+    case WEBKIT_LOAD_STARTED:
+        win->carousel_ready = FALSE;
+        g_object_set_data(G_OBJECT(ucm), "hb-push-subscribed", NULL);
+        break;
+    case WEBKIT_LOAD_FINISHED:
+        // Failed loads finish too: their error page is shown in turn like any other
+        win->carousel_ready = TRUE;
+        if (!win->carousel_due) break;
+        if (win->hidden)
+        {
+            hb_carousel_arm(win);
+        }
+        else
+        {
+            hb_carousel_advance(win);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void hb_carousel_preload_terminated(HbWindow* win)
+{
+    if (!win || !win->carousel_next) return;
+    g_warning("Web process preloading the next page of window '%s' went away", win->cfg.title);
+    win->carousel_ready = FALSE;
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->carousel_next), hb_carousel_next_address(win));
+}
+
+void hb_carousel_drop_preload(HbWindow* win)
+{
+    if (!win || !win->carousel_next) return;
+    g_signal_handlers_disconnect_by_data(win->carousel_next, win);
+    g_signal_handlers_disconnect_by_data(
+        webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(win->carousel_next)), win);
+    g_clear_object(&win->carousel_next);
+    win->carousel_drag = NULL;
+    win->carousel_ready = FALSE;
+}
+
+void hb_carousel_clear(HbWindow* win)
+{
+    if (!win) return;
+    g_clear_handle_id(&win->carousel_source, g_source_remove);
+    win->carousel_due = FALSE;
+    hb_carousel_drop_preload(win);
+}
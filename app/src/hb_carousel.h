@@ -0,0 +1,38 @@
+#ifndef HB_CAROUSEL_H
+#define HB_CAROUSEL_H
+
+#include <webkit/webkit.h>
+#include "hb_window.h"
+
+// ---------------- Carousel ----------------
+//
+// A window with cfg.addresses shows those pages one at a time, cfg.dwell seconds each, from a
+// pool of two web views: the one shown, and one loading the next page out of sight. When the
+// dwell time is up the views swap places (the next page is already rendered, so the change is
+// instant) and the view that went out of sight starts loading the page after that. Memory stays
+// that of two pages however many addresses there are.
+
+// Whether the window is a carousel (more than one address).
+gboolean hb_carousel_is_enabled(const HbWindow* win);
+
+// (Re)arm the page change according to cfg.dwell; without a carousel, stop it and release the
+// preloaded view.
+void hb_carousel_schedule(HbWindow* win);
+
+// Load the current page into the shown view and start preloading the next one.
+void hb_carousel_load(HbWindow* win);
+
+// A load event of the preloaded view (not the one shown).
+void hb_carousel_note_preload(HbWindow* win, WebKitLoadEvent load_event);
+
+// The preloaded view's web process went away: load its page again.
+void hb_carousel_preload_terminated(HbWindow* win);
+
+// Release the preloaded view (it's rebuilt on the next hb_carousel_load()), e.g. because the
+// window's views are being rebuilt with new settings.
+void hb_carousel_drop_preload(HbWindow* win);
+
+// Stop the page change and release the preloaded view.
+void hb_carousel_clear(HbWindow* win);
+
+#endif // HB_CAROUSEL_H
@@ -1,16 +1,41 @@
 #include "hb_config.h"
+#include "hb_trace.h"
+#include "hb_arena.h"
 #include <glib.h>
 #include <json-glib/json-glib.h>
+#include <string.h>
 
-void hb_window_cfg_init_defaults(HbWindowCfg* cfg)
+#define HB_DEFAULT_TITLE "HudBox"
+#define HB_DEFAULT_ADDRESS "https://swstegall.github.io/HudBox/"
+
+// Defaults for everything but the strings
+static void hb_window_cfg_set_default_values(HbWindowCfg* cfg)
 {
-    cfg->title = g_strdup("HudBox");
-    cfg->address = g_strdup("https://swstegall.github.io/HudBox/");
     cfg->width = 800;
     cfg->height = 600;
     cfg->locked = FALSE;
     cfg->opacity = 0.9;
     cfg->transparent = FALSE;
+    cfg->memory_limit_mb = 0;
+    cfg->recycle_interval = 0;
+    cfg->refresh_interval = 0;
+    cfg->freeze_after = 0;
+    cfg->dwell = 30;
+    cfg->throttle_when_hidden = TRUE;
+    cfg->max_fps = 0;
+    cfg->perf_overlay = FALSE;
+    cfg->priority = 0;
+    cfg->ephemeral = FALSE;
+}
+
+void hb_window_cfg_init_defaults(HbWindowCfg* cfg)
+{
+    cfg->title = g_strdup(HB_DEFAULT_TITLE);
+    cfg->address = g_strdup(HB_DEFAULT_ADDRESS);
+    cfg->addresses = NULL;
+    cfg->user_css = NULL;
+    cfg->user_js = NULL;
+    hb_window_cfg_set_default_values(cfg);
 }
 
 void hb_window_cfg_clear(HbWindowCfg* cfg)
@@ -18,9 +43,374 @@ void hb_window_cfg_clear(HbWindowCfg* cfg)
     if (!cfg) return;
     g_clear_pointer(&cfg->title, g_free);
     g_clear_pointer(&cfg->address, g_free);
+    g_clear_pointer(&cfg->addresses, g_strfreev);
+    g_clear_pointer(&cfg->user_css, g_strfreev);
+    g_clear_pointer(&cfg->user_js, g_strfreev);
+}
+
+void hb_window_cfg_copy(const HbWindowCfg* src, HbWindowCfg* dst)
+{
+    if (!src || !dst) return;
+    *dst = *src;
+    dst->title = g_strdup(src->title);
+    dst->address = g_strdup(src->address);
+    dst->addresses = g_strdupv(src->addresses);
+    dst->user_css = g_strdupv(src->user_css);
+    dst->user_js = g_strdupv(src->user_js);
+}
+
+// NULL and empty lists are equal
+static gboolean hb_strv_equal(gchar* const* a, gchar* const* b)
+{
+    if (!a || !*a) return !b || !*b;
+    if (!b) return FALSE;
+    return g_strv_equal((const gchar* const*)a, (const gchar* const*)b);
+}
+
+HbCfgChange hb_window_cfg_diff(const HbWindowCfg* old_cfg, const HbWindowCfg* new_cfg)
+{
+    HbCfgChange changes = HB_CFG_CHANGE_NONE;
+    if (!old_cfg || !new_cfg) return changes;
+
+    if (g_strcmp0(old_cfg->title, new_cfg->title) != 0 ||
+        old_cfg->width != new_cfg->width ||
+        old_cfg->height != new_cfg->height ||
+        old_cfg->locked != new_cfg->locked ||
+        old_cfg->opacity != new_cfg->opacity ||
+        old_cfg->throttle_when_hidden != new_cfg->throttle_when_hidden ||
+        old_cfg->perf_overlay != new_cfg->perf_overlay)
+    {
+        changes |= HB_CFG_CHANGE_WINDOW;
+    }
+    if (old_cfg->recycle_interval != new_cfg->recycle_interval ||
+        old_cfg->refresh_interval != new_cfg->refresh_interval ||
+        old_cfg->freeze_after != new_cfg->freeze_after ||
+        old_cfg->dwell != new_cfg->dwell)
+    {
+        changes |= HB_CFG_CHANGE_SCHEDULE;
+    }
+    if (g_strcmp0(old_cfg->address, new_cfg->address) != 0)
+    {
+        changes |= HB_CFG_CHANGE_ADDRESS;
+    }
+    if (!hb_strv_equal(old_cfg->addresses, new_cfg->addresses))
+    {
+        // Starts over, and may turn the carousel on or off
+        changes |= HB_CFG_CHANGE_ADDRESS | HB_CFG_CHANGE_SCHEDULE;
+    }
+    if (old_cfg->transparent != new_cfg->transparent ||
+        old_cfg->ephemeral != new_cfg->ephemeral ||
+        old_cfg->memory_limit_mb != new_cfg->memory_limit_mb ||
+        old_cfg->max_fps != new_cfg->max_fps ||
+        !hb_strv_equal(old_cfg->user_css, new_cfg->user_css) ||
+        !hb_strv_equal(old_cfg->user_js, new_cfg->user_js))
+    {
+        changes |= HB_CFG_CHANGE_VIEW;
+    }
+    return changes;
 }
 
-static void hb_apply_object_to_cfg(JsonObject* obj, HbWindowCfg* cfg)
+void hb_app_cfg_init_defaults(HbAppCfg* app_cfg)
+{
+    app_cfg->process_model = HB_PROCESS_MODEL_PER_WINDOW;
+    app_cfg->max_concurrent_loads = 3;
+    app_cfg->spare_views = 0;
+    app_cfg->profile = g_strdup("default");
+    app_cfg->data_dir = NULL;
+    app_cfg->cache_dir = NULL;
+    app_cfg->max_cache_mb = 256;
+    app_cfg->bundle_root = NULL;
+    app_cfg->bundle_cache_mb = 16;
+    app_cfg->shared_cache_mb = 16;
+    app_cfg->shared_cache_ttl = 5;
+    app_cfg->push_socket = NULL;
+    app_cfg->content_filters = NULL;
+    app_cfg->user_css = NULL;
+    app_cfg->user_js = NULL;
+    app_cfg->restore_session = FALSE;
+    app_cfg->session_save_interval = 60;
+    app_cfg->metrics_socket = NULL;
+    app_cfg->metrics_port = 0;
+}
+
+void hb_app_cfg_clear(HbAppCfg* app_cfg)
+{
+    if (!app_cfg) return;
+    g_clear_pointer(&app_cfg->profile, g_free);
+    g_clear_pointer(&app_cfg->data_dir, g_free);
+    g_clear_pointer(&app_cfg->cache_dir, g_free);
+    g_clear_pointer(&app_cfg->bundle_root, g_free);
+    g_clear_pointer(&app_cfg->push_socket, g_free);
+    g_clear_pointer(&app_cfg->content_filters, g_strfreev);
+    g_clear_pointer(&app_cfg->user_css, g_strfreev);
+    g_clear_pointer(&app_cfg->user_js, g_strfreev);
+    g_clear_pointer(&app_cfg->metrics_socket, g_free);
+}
+
+gchar* hb_app_cfg_get_data_dir(const HbAppCfg* app_cfg)
+{
+    if (app_cfg && app_cfg->data_dir) return g_strdup(app_cfg->data_dir);
+    const gchar* profile = app_cfg && app_cfg->profile ? app_cfg->profile : "default";
+    return g_build_filename(g_get_user_data_dir(), "hudbox", profile, NULL);
+}
+
+gchar* hb_app_cfg_get_cache_dir(const HbAppCfg* app_cfg)
+{
+    if (app_cfg && app_cfg->cache_dir) return g_strdup(app_cfg->cache_dir);
+    const gchar* profile = app_cfg && app_cfg->profile ? app_cfg->profile : "default";
+    return g_build_filename(g_get_user_cache_dir(), "hudbox", profile, NULL);
+}
+
+gchar* hb_app_cfg_get_bundle_root(const HbAppCfg* app_cfg)
+{
+    if (app_cfg && app_cfg->bundle_root) return g_strdup(app_cfg->bundle_root);
+    return g_build_filename(g_get_user_data_dir(), "hudbox", "bundles", NULL);
+}
+
+gboolean hb_process_model_from_string(const gchar* name, HbProcessModel* out)
+{
+    if (!name || !out) return FALSE;
+    if (g_ascii_strcasecmp(name, "per-window") == 0 || g_ascii_strcasecmp(name, "per_window") == 0)
+    {
+        *out = HB_PROCESS_MODEL_PER_WINDOW;
+        return TRUE;
+    }
+    if (g_ascii_strcasecmp(name, "shared") == 0)
+    {
+        *out = HB_PROCESS_MODEL_SHARED;
+        return TRUE;
+    }
+    if (g_ascii_strcasecmp(name, "per-origin") == 0 || g_ascii_strcasecmp(name, "per_origin") == 0)
+    {
+        *out = HB_PROCESS_MODEL_PER_ORIGIN;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gchar* hb_address_origin(const gchar* address)
+{
+    if (!address) return NULL;
+    GUri* uri = g_uri_parse(address, G_URI_FLAGS_NONE, NULL);
+    if (!uri) return NULL;
+
+    gchar* origin = NULL;
+    const gchar* scheme = g_uri_get_scheme(uri);
+    const gchar* host = g_uri_get_host(uri);
+    if (scheme && host && *host)
+    {
+        gchar* lower_scheme = g_ascii_strdown(scheme, -1);
+        gchar* lower_host = g_ascii_strdown(host, -1);
+        gint port = g_uri_get_port(uri);
+        origin = port > 0
+                     ? g_strdup_printf("%s://%s:%d", lower_scheme, lower_host, port)
+                     : g_strdup_printf("%s://%s", lower_scheme, lower_host);
+        g_free(lower_scheme);
+        g_free(lower_host);
+    }
+    g_uri_unref(uri);
+    return origin;
+}
+
+// A string, or an array whose strings are collected; other elements and empty strings are
+// skipped. Returns borrowed strings, NULL-terminated; NULL when there are none.
+static GPtrArray* hb_json_string_list(JsonObject* obj, const gchar* member)
+{
+    JsonNode* node = json_object_get_member(obj, member);
+    GPtrArray* list = g_ptr_array_new();
+    if (node && JSON_NODE_HOLDS_VALUE(node) && json_node_get_value_type(node) == G_TYPE_STRING)
+    {
+        const gchar* s = json_node_get_string(node);
+        if (s && *s) g_ptr_array_add(list, (gpointer)s);
+    }
+    else if (node && JSON_NODE_HOLDS_ARRAY(node))
+    {
+        JsonArray* arr = json_node_get_array(node);
+        for (guint i = 0; i < json_array_get_length(arr); i++)
+        {
+            JsonNode* el = json_array_get_element(arr, i);
+            if (!JSON_NODE_HOLDS_VALUE(el) || json_node_get_value_type(el) != G_TYPE_STRING) continue;
+            const gchar* s = json_node_get_string(el);
+            if (s && *s) g_ptr_array_add(list, (gpointer)s);
+        }
+    }
+    if (list->len == 0)
+    {
+        g_ptr_array_unref(list);
+        return NULL;
+    }
+    g_ptr_array_add(list, NULL);
+    return list;
+}
+
+// Replace *files with the list in member, if present
+static void hb_app_cfg_set_files(gchar*** files, JsonObject* obj, const gchar* member)
+{
+    if (!json_object_has_member(obj, member)) return;
+    GPtrArray* list = hb_json_string_list(obj, member);
+    g_strfreev(*files);
+    *files = list ? g_strdupv((gchar**)list->pdata) : NULL;
+    if (list) g_ptr_array_unref(list);
+}
+
+static void hb_apply_object_to_app_cfg(JsonObject* obj, HbAppCfg* app_cfg)
+{
+    if (!obj || !app_cfg) return;
+
+    // process_model
+    if (json_object_has_member(obj, "process_model"))
+    {
+        const gchar* s = json_object_get_string_member(obj, "process_model");
+        if (!hb_process_model_from_string(s, &app_cfg->process_model))
+        {
+            g_warning("Unknown process_model '%s'; keeping default", s ? s : "(null)");
+        }
+    }
+    // max_concurrent_loads
+    if (json_object_has_member(obj, "max_concurrent_loads"))
+    {
+        gint64 v = json_object_get_int_member(obj, "max_concurrent_loads");
+        app_cfg->max_concurrent_loads = v > 0 ? (guint)v : 0;
+    }
+    // spare_views
+    if (json_object_has_member(obj, "spare_views"))
+    {
+        gint64 v = json_object_get_int_member(obj, "spare_views");
+        app_cfg->spare_views = v > 0 ? (guint)MIN(v, 8) : 0;
+    }
+    // push_socket
+    if (json_object_has_member(obj, "push_socket"))
+    {
+        const gchar* s = json_object_get_string_member(obj, "push_socket");
+        g_free(app_cfg->push_socket);
+        app_cfg->push_socket = s && *s ? g_strdup(s) : NULL;
+    }
+    // content_filters, user_css, user_js: one file or an array of them
+    hb_app_cfg_set_files(&app_cfg->content_filters, obj, "content_filters");
+    hb_app_cfg_set_files(&app_cfg->user_css, obj, "user_css");
+    hb_app_cfg_set_files(&app_cfg->user_js, obj, "user_js");
+    // metrics
+    if (json_object_has_member(obj, "metrics"))
+    {
+        JsonObject* metrics = json_object_get_object_member(obj, "metrics");
+        if (metrics)
+        {
+            const gchar* s;
+            if (json_object_has_member(metrics, "socket") &&
+                (s = json_object_get_string_member(metrics, "socket")) && *s)
+            {
+                g_free(app_cfg->metrics_socket);
+                app_cfg->metrics_socket = g_strdup(s);
+            }
+            if (json_object_has_member(metrics, "port"))
+            {
+                gint64 v = json_object_get_int_member(metrics, "port");
+                app_cfg->metrics_port = v > 0 && v <= G_MAXUINT16 ? (guint)v : 0;
+            }
+        }
+    }
+    // session
+    if (json_object_has_member(obj, "session"))
+    {
+        JsonObject* session = json_object_get_object_member(obj, "session");
+        if (session)
+        {
+            if (json_object_has_member(session, "restore"))
+            {
+                app_cfg->restore_session = json_object_get_boolean_member(session, "restore");
+            }
+            if (json_object_has_member(session, "save_interval"))
+            {
+                gint64 v = json_object_get_int_member(session, "save_interval");
+                app_cfg->session_save_interval = v > 0 ? (guint)v : 0;
+            }
+        }
+    }
+    // storage
+    if (json_object_has_member(obj, "storage"))
+    {
+        JsonObject* storage = json_object_get_object_member(obj, "storage");
+        if (storage)
+        {
+            const gchar* s;
+            if (json_object_has_member(storage, "profile") &&
+                (s = json_object_get_string_member(storage, "profile")) && *s)
+            {
+                g_free(app_cfg->profile);
+                app_cfg->profile = g_strdup(s);
+            }
+            if (json_object_has_member(storage, "data_dir") &&
+                (s = json_object_get_string_member(storage, "data_dir")) && *s)
+            {
+                g_free(app_cfg->data_dir);
+                app_cfg->data_dir = g_strdup(s);
+            }
+            if (json_object_has_member(storage, "cache_dir") &&
+                (s = json_object_get_string_member(storage, "cache_dir")) && *s)
+            {
+                g_free(app_cfg->cache_dir);
+                app_cfg->cache_dir = g_strdup(s);
+            }
+            if (json_object_has_member(storage, "max_cache_mb"))
+            {
+                gint64 v = json_object_get_int_member(storage, "max_cache_mb");
+                app_cfg->max_cache_mb = v > 0 ? (guint)v : 0;
+            }
+        }
+    }
+    // hudbox:// bundles
+    if (json_object_has_member(obj, "bundles"))
+    {
+        JsonObject* bundles = json_object_get_object_member(obj, "bundles");
+        if (bundles)
+        {
+            const gchar* s;
+            if (json_object_has_member(bundles, "root") &&
+                (s = json_object_get_string_member(bundles, "root")) && *s)
+            {
+                g_free(app_cfg->bundle_root);
+                app_cfg->bundle_root = g_strdup(s);
+            }
+            if (json_object_has_member(bundles, "cache_mb"))
+            {
+                gint64 v = json_object_get_int_member(bundles, "cache_mb");
+                app_cfg->bundle_cache_mb = v > 0 ? (guint)v : 0;
+            }
+        }
+    }
+    // hbcache:// shared fetch cache
+    if (json_object_has_member(obj, "shared_cache"))
+    {
+        JsonObject* shared = json_object_get_object_member(obj, "shared_cache");
+        if (shared)
+        {
+            if (json_object_has_member(shared, "cache_mb"))
+            {
+                gint64 v = json_object_get_int_member(shared, "cache_mb");
+                app_cfg->shared_cache_mb = v > 0 ? (guint)v : 0;
+            }
+            if (json_object_has_member(shared, "ttl"))
+            {
+                gint64 v = json_object_get_int_member(shared, "ttl");
+                app_cfg->shared_cache_ttl = v > 0 ? (guint)v : 0;
+            }
+        }
+    }
+}
+
+// hb_json_string_list() copied into arena (strings interned); NULL when empty
+static gchar** hb_arena_string_list(HbArena* arena, JsonObject* obj, const gchar* member)
+{
+    GPtrArray* list = hb_json_string_list(obj, member);
+    if (!list) return NULL;
+    gchar** strv = hb_arena_new0(arena, gchar*, list->len);
+    for (guint i = 0; i + 1 < list->len; i++) strv[i] = hb_arena_intern(arena, g_ptr_array_index(list, i));
+    g_ptr_array_unref(list);
+    return strv;
+}
+
+// Strings are interned in arena: generated configs repeat the same few titles and addresses
+static void hb_apply_object_to_cfg(JsonObject* obj, HbWindowCfg* cfg, HbArena* arena)
 {
     if (!obj || !cfg) return;
 
@@ -28,30 +418,18 @@ static void hb_apply_object_to_cfg(JsonObject* obj, HbWindowCfg* cfg)
     if (json_object_has_member(obj, "title"))
     {
         const gchar* s = json_object_get_string_member(obj, "title");
-        if (s)
-        {
-            g_free(cfg->title);
-            cfg->title = g_strdup(s);
-        }
+        if (s) cfg->title = hb_arena_intern(arena, s);
     }
     // address (aka uri)
     if (json_object_has_member(obj, "address"))
     {
         const gchar* s = json_object_get_string_member(obj, "address");
-        if (s)
-        {
-            g_free(cfg->address);
-            cfg->address = g_strdup(s);
-        }
+        if (s) cfg->address = hb_arena_intern(arena, s);
     }
     else if (json_object_has_member(obj, "uri"))
     {
         const gchar* s = json_object_get_string_member(obj, "uri");
-        if (s)
-        {
-            g_free(cfg->address);
-            cfg->address = g_strdup(s);
-        }
+        if (s) cfg->address = hb_arena_intern(arena, s);
     }
     // width/height
     if (json_object_has_member(obj, "width"))
@@ -77,75 +455,453 @@ static void hb_apply_object_to_cfg(JsonObject* obj, HbWindowCfg* cfg)
     {
         cfg->transparent = json_object_get_boolean_member(obj, "transparent");
     }
+    // memory budget / recycling
+    if (json_object_has_member(obj, "memory_limit_mb"))
+    {
+        gint64 v = json_object_get_int_member(obj, "memory_limit_mb");
+        cfg->memory_limit_mb = v > 0 ? (guint)v : 0;
+    }
+    if (json_object_has_member(obj, "recycle_interval"))
+    {
+        gint64 v = json_object_get_int_member(obj, "recycle_interval");
+        cfg->recycle_interval = v > 0 ? (guint)v : 0;
+    }
+    // periodic refresh
+    if (json_object_has_member(obj, "refresh_interval"))
+    {
+        gint64 v = json_object_get_int_member(obj, "refresh_interval");
+        cfg->refresh_interval = v > 0 ? (guint)v : 0;
+    }
+    // injected style sheets and scripts
+    if (json_object_has_member(obj, "user_css"))
+    {
+        cfg->user_css = hb_arena_string_list(arena, obj, "user_css");
+    }
+    if (json_object_has_member(obj, "user_js"))
+    {
+        cfg->user_js = hb_arena_string_list(arena, obj, "user_js");
+    }
+    // carousel: pages shown in turn, dwell seconds each
+    if (json_object_has_member(obj, "addresses"))
+    {
+        cfg->addresses = hb_arena_string_list(arena, obj, "addresses");
+    }
+    if (json_object_has_member(obj, "dwell"))
+    {
+        gint64 v = json_object_get_int_member(obj, "dwell");
+        cfg->dwell = v > 0 ? (guint)v : 1;
+    }
+    // snapshot while idle
+    if (json_object_has_member(obj, "freeze_after"))
+    {
+        gint64 v = json_object_get_int_member(obj, "freeze_after");
+        cfg->freeze_after = v > 0 ? (guint)v : 0;
+    }
+    // visibility throttling
+    if (json_object_has_member(obj, "throttle_when_hidden"))
+    {
+        cfg->throttle_when_hidden = json_object_get_boolean_member(obj, "throttle_when_hidden");
+    }
+    // frame-rate cap
+    if (json_object_has_member(obj, "max_fps"))
+    {
+        gint64 v = json_object_get_int_member(obj, "max_fps");
+        cfg->max_fps = v > 0 ? (guint)v : 0;
+    }
+    // performance overlay
+    if (json_object_has_member(obj, "perf_overlay"))
+    {
+        cfg->perf_overlay = json_object_get_boolean_member(obj, "perf_overlay");
+    }
+    // startup priority
+    if (json_object_has_member(obj, "priority"))
+    {
+        cfg->priority = (gint)json_object_get_int_member(obj, "priority");
+    }
+    // storage
+    if (json_object_has_member(obj, "ephemeral"))
+    {
+        cfg->ephemeral = json_object_get_boolean_member(obj, "ephemeral");
+    }
 }
 
-GPtrArray* hb_load_configs_from_json(const gchar* path)
+// Type of a setting's JSON value
+typedef enum
 {
-    gchar* contents = NULL;
-    gsize len = 0;
-    GError* error = NULL;
-    if (!g_file_get_contents(path, &contents, &len, &error))
+    HB_JSON_STRING,
+    HB_JSON_INT,
+    HB_JSON_NUMBER,  // integer or floating point
+    HB_JSON_BOOL,
+    HB_JSON_STRINGS, // string or array of strings
+    HB_JSON_OBJECT,  // a section with settings of its own
+    HB_JSON_ARRAY
+} HbJsonKind;
+
+typedef struct HbJsonMember
+{
+    const gchar* name; // NULL ends a table
+    HbJsonKind kind;
+    const struct HbJsonMember* members; // HB_JSON_OBJECT: the section's settings
+} HbJsonMember;
+
+static const HbJsonMember hb_window_members[] = {
+    {"title", HB_JSON_STRING},
+    {"address", HB_JSON_STRING},
+    {"uri", HB_JSON_STRING},
+    {"addresses", HB_JSON_STRINGS},
+    {"dwell", HB_JSON_INT},
+    {"width", HB_JSON_INT},
+    {"height", HB_JSON_INT},
+    {"locked", HB_JSON_BOOL},
+    {"opacity", HB_JSON_NUMBER},
+    {"transparent", HB_JSON_BOOL},
+    {"memory_limit_mb", HB_JSON_INT},
+    {"recycle_interval", HB_JSON_INT},
+    {"refresh_interval", HB_JSON_INT},
+    {"freeze_after", HB_JSON_INT},
+    {"throttle_when_hidden", HB_JSON_BOOL},
+    {"max_fps", HB_JSON_INT},
+    {"perf_overlay", HB_JSON_BOOL},
+    {"priority", HB_JSON_INT},
+    {"ephemeral", HB_JSON_BOOL},
+    {"user_css", HB_JSON_STRINGS},
+    {"user_js", HB_JSON_STRINGS},
+    {NULL},
+};
+
+static const HbJsonMember hb_metrics_members[] = {
+    {"socket", HB_JSON_STRING},
+    {"port", HB_JSON_INT},
+    {NULL},
+};
+
+static const HbJsonMember hb_session_members[] = {
+    {"restore", HB_JSON_BOOL},
+    {"save_interval", HB_JSON_INT},
+    {NULL},
+};
+
+static const HbJsonMember hb_storage_members[] = {
+    {"profile", HB_JSON_STRING},
+    {"data_dir", HB_JSON_STRING},
+    {"cache_dir", HB_JSON_STRING},
+    {"max_cache_mb", HB_JSON_INT},
+    {NULL},
+};
+
+static const HbJsonMember hb_bundles_members[] = {
+    {"root", HB_JSON_STRING},
+    {"cache_mb", HB_JSON_INT},
+    {NULL},
+};
+
+static const HbJsonMember hb_shared_cache_members[] = {
+    {"cache_mb", HB_JSON_INT},
+    {"ttl", HB_JSON_INT},
+    {NULL},
+};
+
+// Top-level form: application settings plus the "windows" array
+static const HbJsonMember hb_app_members[] = {
+    {"process_model", HB_JSON_STRING},
+    {"max_concurrent_loads", HB_JSON_INT},
+    {"spare_views", HB_JSON_INT},
+    {"push_socket", HB_JSON_STRING},
+    {"content_filters", HB_JSON_STRINGS},
+    {"user_css", HB_JSON_STRINGS},
+    {"user_js", HB_JSON_STRINGS},
+    {"metrics", HB_JSON_OBJECT, hb_metrics_members},
+    {"session", HB_JSON_OBJECT, hb_session_members},
+    {"storage", HB_JSON_OBJECT, hb_storage_members},
+    {"bundles", HB_JSON_OBJECT, hb_bundles_members},
+    {"shared_cache", HB_JSON_OBJECT, hb_shared_cache_members},
+    {"windows", HB_JSON_ARRAY},
+    {NULL},
+};
+
+static gboolean hb_json_node_is(JsonNode* node, HbJsonKind kind)
+{
+    if (kind == HB_JSON_OBJECT) return JSON_NODE_HOLDS_OBJECT(node);
+    if (kind == HB_JSON_ARRAY) return JSON_NODE_HOLDS_ARRAY(node);
+    if (kind == HB_JSON_STRINGS && JSON_NODE_HOLDS_ARRAY(node)) return TRUE;
+    if (!JSON_NODE_HOLDS_VALUE(node)) return FALSE;
+    GType type = json_node_get_value_type(node);
+    switch (kind)
     {
-        if (error) g_error_free(error);
-        return NULL;
+    case HB_JSON_STRING:
+    case HB_JSON_STRINGS:
+        return type == G_TYPE_STRING;
+    case HB_JSON_INT:
+        return type == G_TYPE_INT64;
+    case HB_JSON_NUMBER:
+        return type == G_TYPE_INT64 || type == G_TYPE_DOUBLE;
+    case HB_JSON_BOOL:
+        return type == G_TYPE_BOOLEAN;
+    case HB_JSON_OBJECT:
+    case HB_JSON_ARRAY:
+        break;
+    }
+    return FALSE;
+}
+
+static const gchar* hb_json_kind_name(HbJsonKind kind)
+{
+    switch (kind)
+    {
+    case HB_JSON_STRING: return "a string";
+    case HB_JSON_INT: return "an integer";
+    case HB_JSON_NUMBER: return "a number";
+    case HB_JSON_BOOL: return "true or false";
+    case HB_JSON_STRINGS: return "a string or an array of strings";
+    case HB_JSON_OBJECT: return "an object";
+    case HB_JSON_ARRAY: return "an array";
+    }
+    return "";
+}
+
+// Report members of obj with a value of the wrong type, and remove them so the defaults apply;
+// unknown members (typos) are reported and left alone. Sections are checked in turn. Messages
+// start with where ("window 2: ", "metrics: "), which may be empty.
+static void hb_validate_object(JsonObject* obj, const HbJsonMember* table, const gchar* where, GPtrArray* errors)
+{
+    GList* members = json_object_get_members(obj);
+    for (GList* l = members; l; l = l->next)
+    {
+        const gchar* name = l->data;
+        const HbJsonMember* m = table;
+        while (m->name && g_strcmp0(m->name, name) != 0) m++;
+        if (!m->name)
+        {
+            g_ptr_array_add(errors, g_strdup_printf("%sunknown setting \"%s\"", where, name));
+            continue;
+        }
+        JsonNode* node = json_object_get_member(obj, name);
+        if (!hb_json_node_is(node, m->kind))
+        {
+            g_ptr_array_add(errors, g_strdup_printf("%s\"%s\" must be %s; using the default",
+                                                    where, name, hb_json_kind_name(m->kind)));
+            json_object_remove_member(obj, name);
+            continue;
+        }
+        if (m->members)
+        {
+            gchar* section = g_strdup_printf("%s%s: ", where, name);
+            hb_validate_object(json_node_get_object(node), m->members, section, errors);
+            g_free(section);
+        }
+    }
+    g_list_free(members);
+}
+
+// Window entry index (0-based)
+static void hb_validate_window_object(JsonObject* obj, guint index, GPtrArray* errors)
+{
+    gchar* where = g_strdup_printf("window %u: ", index + 1);
+    hb_validate_object(obj, hb_window_members, where, errors);
+    g_free(where);
+}
+
+// Fill cfg (arena memory) from one window object
+static void hb_cfg_from_object(JsonObject* obj, HbWindowCfg* cfg, HbArena* arena)
+{
+    cfg->title = hb_arena_intern(arena, HB_DEFAULT_TITLE);
+    cfg->address = hb_arena_intern(arena, HB_DEFAULT_ADDRESS);
+    hb_window_cfg_set_default_values(cfg);
+    hb_apply_object_to_cfg(obj, cfg, arena);
+    // The first page stands for the carousel wherever one address is needed (process model, origin)
+    if (cfg->addresses) cfg->address = cfg->addresses[0];
+    // clamp opacity
+    if (cfg->opacity < 0.0) cfg->opacity = 0.0;
+    if (cfg->opacity > 1.0) cfg->opacity = 1.0;
+}
+
+static void hb_config_set_add_array(HbConfigSet* set, JsonArray* ja, GPtrArray* errors)
+{
+    guint n = json_array_get_length(ja);
+    set->windows = hb_arena_new0(set->arena, HbWindowCfg, MAX(n, 1));
+    for (guint i = 0; i < n; i++)
+    {
+        JsonNode* node = json_array_get_element(ja, i);
+        if (!node || !JSON_NODE_HOLDS_OBJECT(node))
+        {
+            g_ptr_array_add(errors, g_strdup_printf("window %u: not an object; skipped", i + 1));
+            continue;
+        }
+        hb_validate_window_object(json_node_get_object(node), i, errors);
+        hb_cfg_from_object(json_node_get_object(node), &set->windows[set->n_windows++], set->arena);
     }
+}
 
+void hb_config_set_free(HbConfigSet* set)
+{
+    // The set itself lives in its arena
+    if (set) hb_arena_free(set->arena);
+}
+
+// Read and parse path, recording spans on track. NULL with error when the file can't be read or
+// parsed or lists no usable windows.
+static HbConfigSet* hb_config_load(const gchar* path, HbAppCfg* app_cfg, guint track, GError** error)
+{
+    gchar* contents = NULL;
+    gsize len = 0;
+    gint64 t_read = hb_trace_now();
+    if (!g_file_get_contents(path, &contents, &len, error)) return NULL;
+    hb_trace_span(track, "config_read", t_read);
+
+    gint64 t_parse = hb_trace_now();
     JsonParser* parser = json_parser_new();
-    if (!json_parser_load_from_data(parser, contents, len, &error))
+    if (!json_parser_load_from_data(parser, contents, len, error))
     {
-        if (error) g_error_free(error);
         g_object_unref(parser);
         g_free(contents);
         return NULL;
     }
+    hb_trace_span(track, "config_parse_json", t_parse);
 
     JsonNode* root = json_parser_get_root(parser);
     if (!root)
     {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s is empty", path);
         g_object_unref(parser);
         g_free(contents);
         return NULL;
     }
 
-    GPtrArray* arr = g_ptr_array_new_with_free_func(g_free);
+    HbArena* arena = hb_arena_new(0);
+    HbConfigSet* set = hb_arena_new0(arena, HbConfigSet, 1);
+    set->arena = arena;
+    GPtrArray* errors = g_ptr_array_new_with_free_func(g_free);
 
     if (JSON_NODE_HOLDS_ARRAY(root))
     {
-        JsonArray* ja = json_node_get_array(root);
-        guint n = json_array_get_length(ja);
-        for (guint i = 0; i < n; i++)
+        hb_config_set_add_array(set, json_node_get_array(root), errors);
+    }
+    else if (JSON_NODE_HOLDS_OBJECT(root) &&
+        json_object_has_member(json_node_get_object(root), "windows"))
+    {
+        // Top-level form: application settings plus a "windows" array
+        JsonObject* obj = json_node_get_object(root);
+        hb_validate_object(obj, hb_app_members, "", errors);
+        hb_apply_object_to_app_cfg(obj, app_cfg);
+        // Gone if it wasn't an array
+        if (json_object_has_member(obj, "windows"))
         {
-            JsonObject* obj = json_array_get_object_element(ja, i);
-            if (!obj) continue;
-            HbWindowCfg* cfg = g_new0(HbWindowCfg, 1);
-            hb_window_cfg_init_defaults(cfg);
-            hb_apply_object_to_cfg(obj, cfg);
-            // clamp opacity
-            if (cfg->opacity < 0.0) cfg->opacity = 0.0;
-            if (cfg->opacity > 1.0) cfg->opacity = 1.0;
-            g_ptr_array_add(arr, cfg);
+            hb_config_set_add_array(set, json_object_get_array_member(obj, "windows"), errors);
         }
     }
     else if (JSON_NODE_HOLDS_OBJECT(root))
     {
-        JsonObject* obj = json_node_get_object(root);
-        HbWindowCfg* cfg = g_new0(HbWindowCfg, 1);
-        hb_window_cfg_init_defaults(cfg);
-        hb_apply_object_to_cfg(obj, cfg);
-        if (cfg->opacity < 0.0) cfg->opacity = 0.0;
-        if (cfg->opacity > 1.0) cfg->opacity = 1.0;
-        g_ptr_array_add(arr, cfg);
+        set->windows = hb_arena_new0(arena, HbWindowCfg, 1);
+        hb_validate_window_object(json_node_get_object(root), 0, errors);
+        hb_cfg_from_object(json_node_get_object(root), &set->windows[set->n_windows++], arena);
     }
 
     g_object_unref(parser);
     g_free(contents);
 
-    if (arr->len == 0)
+    if (set->n_windows == 0)
     {
-        g_ptr_array_free(arr, TRUE);
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s lists no windows%s%s", path,
+                    errors->len > 0 ? ": " : "", errors->len > 0 ? (const gchar*)g_ptr_array_index(errors, 0) : "");
+        g_ptr_array_unref(errors);
+        hb_config_set_free(set);
         return NULL;
     }
-    return arr;
+
+    set->n_errors = errors->len;
+    set->errors = hb_arena_new0(arena, const gchar*, MAX(errors->len, 1));
+    for (guint i = 0; i < errors->len; i++) set->errors[i] = hb_arena_intern(arena, g_ptr_array_index(errors, i));
+    g_ptr_array_unref(errors);
+    return set;
+}
+
+HbConfigSet* hb_load_configs_from_json(const gchar* path)
+{
+    return hb_load_configs_from_json_full(path, NULL, NULL);
+}
+
+HbConfigSet* hb_load_configs_from_json_full(const gchar* path, HbAppCfg* app_cfg, GError** error)
+{
+    return hb_config_load(path, app_cfg, HB_TRACE_TRACK_MAIN, error);
+}
+
+void hb_config_set_log_errors(const HbConfigSet* set, const gchar* path)
+{
+    for (guint i = 0; set && i < set->n_errors; i++)
+    {
+        g_warning("Config %s: %s", path, set->errors[i]);
+    }
+}
+
+typedef struct
+{
+    gchar* path;
+    gboolean create_default;
+    HbAppCfg app_cfg;
+} HbConfigLoad;
+
+static void hb_config_load_free(gpointer data)
+{
+    HbConfigLoad* load = data;
+    g_free(load->path);
+    hb_app_cfg_clear(&load->app_cfg);
+    g_free(load);
+}
+
+static void hb_config_load_thread(GTask* task, gpointer source_object, gpointer task_data, GCancellable* cancellable)
+{
+    HbConfigLoad* load = task_data;
+    guint track = hb_trace_new_track("config loader");
+    if (load->create_default)
+    {
+        gint64 t_ensure = hb_trace_now();
+        hb_ensure_default_config_exists(load->path);
+        hb_trace_span(track, "ensure_default_config", t_ensure);
+    }
+
+    GError* error = NULL;
+    HbConfigSet* set = hb_config_load(load->path, &load->app_cfg, track, &error);
+    if (set)
+    {
+        g_task_return_pointer(task, set, (GDestroyNotify)hb_config_set_free);
+    }
+    else
+    {
+        g_task_return_error(task, error);
+    }
+}
+
+void hb_load_configs_async(const gchar* path,
+                           gboolean create_default,
+                           GCancellable* cancellable,
+                           GAsyncReadyCallback callback,
+                           gpointer user_data)
+{
+    HbConfigLoad* load = g_new0(HbConfigLoad, 1);
+    load->path = g_strdup(path);
+    load->create_default = create_default;
+    hb_app_cfg_init_defaults(&load->app_cfg);
+
+    GTask* task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_source_tag(task, hb_load_configs_async);
+    g_task_set_task_data(task, load, hb_config_load_free);
+    g_task_run_in_thread(task, hb_config_load_thread);
+    g_object_unref(task);
+}
+
+HbConfigSet* hb_load_configs_finish(GAsyncResult* result, HbAppCfg* app_cfg, GError** error)
+{
+    g_return_val_if_fail(g_task_is_valid(result, NULL), NULL);
+    GTask* task = G_TASK(result);
+    HbConfigSet* set = g_task_propagate_pointer(task, error);
+    if (set && app_cfg)
+    {
+        HbConfigLoad* load = g_task_get_task_data(task);
+        hb_app_cfg_clear(app_cfg);
+        *app_cfg = load->app_cfg;
+        memset(&load->app_cfg, 0, sizeof(load->app_cfg));
+    }
+    return set;
 }
 
 gboolean hb_write_default_config(const gchar* path)
@@ -2,26 +2,155 @@
 #define HB_CONFIG_H
 
 #include <glib.h>
+#include <gio/gio.h>
 #include <json-glib/json-glib.h>
+#include "hb_arena.h"
 
 // ---------------- Config parsing (JSON) ----------------
 
+// How web views are distributed across WebKit web processes.
+typedef enum
+{
+    HB_PROCESS_MODEL_PER_WINDOW = 0, // every window gets its own web process (default)
+    HB_PROCESS_MODEL_SHARED,         // all windows share a single web process
+    HB_PROCESS_MODEL_PER_ORIGIN      // windows loading the same origin share a web process
+} HbProcessModel;
+
+// Top-level (application-wide) settings. Only present when the config root is an
+// object with a "windows" array; otherwise defaults apply.
+typedef struct
+{
+    HbProcessModel process_model;
+    guint max_concurrent_loads; // startup: windows loading at the same time; 0 = unlimited
+    guint spare_views;          // web views kept ready (web process running) for new windows; at most 8
+
+    // "storage" section: persistent website data (cookies, local storage) and HTTP disk cache
+    gchar* profile;     // name of the storage profile; selects the default directories
+    gchar* data_dir;    // website data directory; NULL = $XDG_DATA_HOME/hudbox/<profile>
+    gchar* cache_dir;   // HTTP disk cache directory; NULL = $XDG_CACHE_HOME/hudbox/<profile>
+    guint max_cache_mb; // disk cache size bound, enforced at startup; 0 = unbounded
+
+    // "bundles" section: static pages served from disk as hudbox://<bundle>/<path>
+    gchar* bundle_root;    // directory holding one subdirectory per bundle; NULL = $XDG_DATA_HOME/hudbox/bundles
+    guint bundle_cache_mb; // in-memory cache of recently served bundle files; 0 = disabled
+
+    // "shared_cache" section: hbcache:// responses shared by every window
+    guint shared_cache_mb;  // bound on cached response bodies; 0 = only merge requests in flight
+    guint shared_cache_ttl; // seconds a response is reused when upstream doesn't say (Cache-Control max-age)
+
+    gchar* push_socket; // Unix socket accepting push messages for pages; NULL = disabled
+
+    gchar** content_filters; // content-blocker rule files applied to every view; NULL = none
+    gchar** user_css;        // style sheet files injected into every window; NULL = none
+    gchar** user_js;         // script files injected into every window; NULL = none
+
+    // "session" section: window state kept across restarts
+    gboolean restore_session;     // save pages' history/scroll state and window sizes, restore them at startup
+    guint session_save_interval;  // seconds between saves while running (also saved at exit); 0 = only at exit
+
+    // "metrics" section: Prometheus-style endpoint; disabled unless one of them is set
+    gchar* metrics_socket; // Unix socket path
+    guint metrics_port;    // TCP port on 127.0.0.1; 0 = none
+} HbAppCfg;
+
 typedef struct
 {
     gchar* title;
     gchar* address;
+    gchar** addresses; // carousel: pages shown one at a time, in turn; address is the first. NULL = none
+    guint dwell;       // carousel: seconds each page is shown
     gint width;
     gint height;
     gboolean locked;
     gdouble opacity;
     gboolean transparent; // if true, make window and web content backgrounds transparent
+    guint memory_limit_mb; // web process memory budget in MiB; 0 = unlimited
+    guint recycle_interval; // seconds between proactive view recycles; 0 = never
+    guint refresh_interval; // seconds between reloads (skipped when the page is unchanged); 0 = never
+    guint freeze_after; // seconds without input before the page is replaced by a snapshot; 0 = never
+    gboolean throttle_when_hidden; // hide the page (throttling timers/rendering) while minimized or occluded
+    guint max_fps; // cap on page animation frames per second; 0 = follow the display
+    gboolean perf_overlay; // draw frame rate, load and memory statistics over the page
+    gint priority; // startup order: higher priorities are created and loaded first
+    gboolean ephemeral; // keep this window's website data and cache in memory only
+    gchar** user_css; // style sheet files injected into the page (after the global ones); NULL = none
+    gchar** user_js;  // script files injected into the page (after the global ones); NULL = none
 } HbWindowCfg;
 
 void hb_window_cfg_init_defaults(HbWindowCfg* cfg);
 void hb_window_cfg_clear(HbWindowCfg* cfg);
 
-// Load configuration(s) from a JSON file. Returns GPtrArray* of HbWindowCfg* on success; NULL on failure.
-GPtrArray* hb_load_configs_from_json(const gchar* path);
+// What differs between two configurations of the same window, as far as a running window cares.
+typedef enum
+{
+    HB_CFG_CHANGE_NONE = 0,
+    HB_CFG_CHANGE_WINDOW = 1 << 0,   // title, size, opacity, locked, throttling, overlay: applied in place
+    HB_CFG_CHANGE_SCHEDULE = 1 << 1, // timers (recycle/refresh_interval/freeze_after/dwell): rescheduled in place
+    HB_CFG_CHANGE_ADDRESS = 1 << 2,  // the page must be reloaded
+    HB_CFG_CHANGE_VIEW = 1 << 3      // settings baked into the web view: the view must be rebuilt
+} HbCfgChange;
+
+// Compare two configurations. Startup-only fields (priority) are ignored.
+HbCfgChange hb_window_cfg_diff(const HbWindowCfg* old_cfg, const HbWindowCfg* new_cfg);
+
+// Deep-copy src into dst (dst is overwritten, not cleared). Release dst with hb_window_cfg_clear().
+void hb_window_cfg_copy(const HbWindowCfg* src, HbWindowCfg* dst);
+
+void hb_app_cfg_init_defaults(HbAppCfg* app_cfg);
+void hb_app_cfg_clear(HbAppCfg* app_cfg);
+
+// Resolved storage directories for app_cfg (explicit paths, or the profile defaults). Free with g_free().
+gchar* hb_app_cfg_get_data_dir(const HbAppCfg* app_cfg);
+gchar* hb_app_cfg_get_cache_dir(const HbAppCfg* app_cfg);
+gchar* hb_app_cfg_get_bundle_root(const HbAppCfg* app_cfg);
+
+// Parse "per-window", "shared" or "per-origin". Returns FALSE (leaving *out untouched) on unknown names.
+gboolean hb_process_model_from_string(const gchar* name, HbProcessModel* out);
+
+// Return the origin ("scheme://host[:port]") of an address, or NULL if it has none. Free with g_free().
+gchar* hb_address_origin(const gchar* address);
+
+// The window configurations of one config file. The set, its entries and all their strings live
+// in a single arena (strings are interned, so repeated titles/addresses are stored once) and are
+// released together by hb_config_set_free(). Entries must not be hb_window_cfg_clear()ed or
+// modified; copy them with hb_window_cfg_copy() to keep one.
+typedef struct
+{
+    HbWindowCfg* windows; // in file order
+    guint n_windows;      // at least 1
+    // Problems with individual entries, e.g. "window 2: \"width\" must be an integer; using the
+    // default". Entries that aren't objects are skipped, settings of the wrong type keep their default.
+    const gchar** errors;
+    guint n_errors;
+    HbArena* arena;
+} HbConfigSet;
+
+void hb_config_set_free(HbConfigSet* set);
+
+// Log each of set->errors as a warning naming path.
+void hb_config_set_log_errors(const HbConfigSet* set, const gchar* path);
+
+// Load configuration(s) from a JSON file. Returns NULL on failure or when it lists no windows.
+HbConfigSet* hb_load_configs_from_json(const gchar* path);
+
+// Same as hb_load_configs_from_json(), additionally filling app_cfg (if non-NULL, and already
+// initialized with hb_app_cfg_init_defaults()) from the top-level object form:
+// { "process_model": "shared", "windows": [ ... ] }. On failure, error (optional) says why.
+HbConfigSet* hb_load_configs_from_json_full(const gchar* path, HbAppCfg* app_cfg, GError** error);
+
+// Like hb_load_configs_from_json_full(), but read and parse on a worker thread; callback runs in
+// the calling thread's main context. With create_default, a missing file is first created with the
+// default configuration (see hb_ensure_default_config_exists()).
+void hb_load_configs_async(const gchar* path,
+                           gboolean create_default,
+                           GCancellable* cancellable,
+                           GAsyncReadyCallback callback,
+                           gpointer user_data);
+
+// Result of hb_load_configs_async(). On success, app_cfg (if non-NULL, and initialized with
+// hb_app_cfg_init_defaults()) is replaced by the file's application settings. Returns NULL with
+// error when the file can't be read, isn't valid JSON or lists no usable windows.
+HbConfigSet* hb_load_configs_finish(GAsyncResult* result, HbAppCfg* app_cfg, GError** error);
 
 // Write the default configuration JSON to the given path. Returns TRUE on success.
 gboolean hb_write_default_config(const gchar* path);
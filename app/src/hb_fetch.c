@@ -0,0 +1,185 @@
+#include "hb_fetch.h"
+#include "hb_lru.h"
+#include <gio/gio.h>
+
+typedef struct
+{
+    HbFetchResponse* response;
+    gint64 expires_us;
+} HbFetchEntry;
+
+typedef struct
+{
+    HbFetchCallback callback;
+    gpointer user_data;
+} HbFetchWaiter;
+
+struct HbFetchCache
+{
+    HbLru* lru;             // url -> HbFetchEntry*
+    GHashTable* in_flight;  // url -> GArray of HbFetchWaiter
+    HbFetchFunc fetch;
+    gpointer fetch_data;
+    gint64 (*now)(void);
+    HbFetchStats stats;
+};
+
+void hb_fetch_response_free(HbFetchResponse* response)
+{
+    if (!response) return;
+    g_free(response->content_type);
+    g_free(response->allow_origin);
+    if (response->body) g_bytes_unref(response->body);
+    g_free(response);
+}
+
+static void hb_fetch_entry_free(gpointer data)
+{
+    HbFetchEntry* entry = data;
+    hb_fetch_response_free(entry->response);
+    g_free(entry);
+}
+
+static void hb_fetch_waiters_free(gpointer data)
+{
+    g_array_unref(data);
+}
+
+HbFetchCache* hb_fetch_cache_new(guint64 max_bytes, HbFetchFunc fetch, gpointer fetch_data)
+{
+    HbFetchCache* cache = g_new0(HbFetchCache, 1);
+    cache->lru = hb_lru_new(max_bytes, hb_fetch_entry_free);
+    cache->in_flight = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, hb_fetch_waiters_free);
+    cache->fetch = fetch;
+    cache->fetch_data = fetch_data;
+    cache->now = g_get_monotonic_time;
+    return cache;
+}
+
+void hb_fetch_cache_free(HbFetchCache* cache)
+{
+    if (!cache) return;
+    GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CANCELLED, "Fetch cache is going away");
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, cache->in_flight);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        GArray* waiters = value;
+        for (guint i = 0; i < waiters->len; i++)
+        {
+            HbFetchWaiter* w = &g_array_index(waiters, HbFetchWaiter, i);
+            w->callback(NULL, error, w->user_data);
+        }
+    }
+    g_error_free(error);
+    g_hash_table_unref(cache->in_flight);
+    hb_lru_free(cache->lru);
+    g_free(cache);
+}
+
+void hb_fetch_cache_get(HbFetchCache* cache, const gchar* url, HbFetchCallback callback, gpointer user_data)
+{
+    g_return_if_fail(cache && url && callback);
+
+    HbFetchEntry* entry = hb_lru_lookup(cache->lru, url);
+    if (entry && entry->expires_us > cache->now())
+    {
+        cache->stats.hits++;
+        callback(entry->response, NULL, user_data);
+        return;
+    }
+    if (entry) hb_lru_remove(cache->lru, url);
+
+    HbFetchWaiter waiter = {callback, user_data};
+    GArray* waiters = g_hash_table_lookup(cache->in_flight, url);
+    if (waiters)
+    {
+        cache->stats.coalesced++;
+        g_array_append_val(waiters, waiter);
+        return;
+    }
+
+    cache->stats.misses++;
+    waiters = g_array_new(FALSE, FALSE, sizeof(HbFetchWaiter));
+    g_array_append_val(waiters, waiter);
+    g_hash_table_insert(cache->in_flight, g_strdup(url), waiters);
+    cache->fetch(cache, url, cache->fetch_data);
+}
+
+void hb_fetch_cache_complete(HbFetchCache* cache,
+                             const gchar* url,
+                             HbFetchResponse* response,
+                             guint ttl_s,
+                             const GError* error)
+{
+    g_return_if_fail(cache && url);
+
+    gchar* key = NULL;
+    GArray* waiters = NULL;
+    if (!g_hash_table_steal_extended(cache->in_flight, url, (gpointer*)&key, (gpointer*)&waiters))
+    {
+        hb_fetch_response_free(response);
+        return;
+    }
+
+    // Callbacks may ask for url again: that starts a new fetch (or hits the entry inserted below)
+    for (guint i = 0; i < waiters->len; i++)
+    {
+        HbFetchWaiter* w = &g_array_index(waiters, HbFetchWaiter, i);
+        w->callback(response, response ? NULL : error, w->user_data);
+    }
+    g_array_unref(waiters);
+
+    if (response && response->status == 200 && ttl_s > 0)
+    {
+        HbFetchEntry* entry = g_new0(HbFetchEntry, 1);
+        entry->response = response;
+        entry->expires_us = cache->now() + (gint64)ttl_s * G_USEC_PER_SEC;
+        gsize size = response->body ? g_bytes_get_size(response->body) : 0;
+        hb_lru_insert(cache->lru, key, entry, size);
+    }
+    else
+    {
+        hb_fetch_response_free(response);
+    }
+    g_free(key);
+}
+
+void hb_fetch_cache_get_stats(const HbFetchCache* cache, HbFetchStats* stats)
+{
+    if (!cache || !stats) return;
+    *stats = cache->stats;
+    stats->entries = hb_lru_get_count(cache->lru);
+    stats->bytes = hb_lru_get_size(cache->lru);
+}
+
+void hb_fetch_cache_set_clock(HbFetchCache* cache, gint64 (*now)(void))
+{
+    if (!cache) return;
+    cache->now = now ? now : g_get_monotonic_time;
+}
+
+guint hb_fetch_ttl(const gchar* cache_control, guint default_ttl_s)
+{
+    if (!cache_control) return default_ttl_s;
+    guint ttl = default_ttl_s;
+    gchar** directives = g_strsplit(cache_control, ",", -1);
+    for (gchar** d = directives; *d; d++)
+    {
+        gchar* directive = g_strstrip(*d);
+        if (g_ascii_strcasecmp(directive, "no-store") == 0 || g_ascii_strcasecmp(directive, "no-cache") == 0)
+        {
+            ttl = 0;
+            break;
+        }
+        if (g_ascii_strncasecmp(directive, "max-age=", 8) == 0)
+        {
+            gchar* end = NULL;
+            guint64 v = g_ascii_strtoull(directive + 8, &end, 10);
+            if (end != directive + 8) ttl = (guint)MIN(v, G_MAXUINT);
+        }
+    }
+    g_strfreev(directives);
+    return ttl;
+}
@@ -0,0 +1,65 @@
+#ifndef HB_FETCH_H
+#define HB_FETCH_H
+
+#include <glib.h>
+
+// ---------------- Shared fetch cache (hbcache://) ----------------
+
+// Responses to GET requests shared by every window: identical requests in flight are merged
+// into one upstream fetch, and successful responses are kept in a size-bounded LRU for a
+// per-entry time to live. The upstream fetch itself is left to a HbFetchFunc. Not thread-safe.
+typedef struct HbFetchCache HbFetchCache;
+
+typedef struct
+{
+    guint status;        // HTTP status
+    gchar* content_type; // Content-Type header as sent; may be NULL
+    gchar* allow_origin; // Access-Control-Allow-Origin header as sent; may be NULL
+    GBytes* body;
+} HbFetchResponse;
+
+typedef struct
+{
+    guint64 hits;      // served from the cache
+    guint64 misses;    // sent upstream
+    guint64 coalesced; // joined a fetch already in flight
+    guint entries;
+    guint64 bytes;     // cached body bytes
+} HbFetchStats;
+
+// Start fetching url upstream; report the outcome with hb_fetch_cache_complete(), possibly
+// before returning.
+typedef void (*HbFetchFunc)(HbFetchCache* cache, const gchar* url, gpointer user_data);
+
+// Called once per hb_fetch_cache_get(): response on success, error otherwise. The response is
+// only valid during the call.
+typedef void (*HbFetchCallback)(const HbFetchResponse* response, const GError* error, gpointer user_data);
+
+HbFetchCache* hb_fetch_cache_new(guint64 max_bytes, HbFetchFunc fetch, gpointer fetch_data);
+
+// Requests still waiting for an upstream response are failed (G_IO_ERROR_CANCELLED).
+void hb_fetch_cache_free(HbFetchCache* cache);
+
+// Answer from the cache when a fresh entry exists, join the fetch in flight for url, or start one.
+void hb_fetch_cache_get(HbFetchCache* cache, const gchar* url, HbFetchCallback callback, gpointer user_data);
+
+// Outcome of the upstream fetch for url: response (taken over; NULL with error on failure) is
+// delivered to every waiting request. 200 responses with ttl_s > 0 are cached for ttl_s seconds.
+void hb_fetch_cache_complete(HbFetchCache* cache,
+                             const gchar* url,
+                             HbFetchResponse* response,
+                             guint ttl_s,
+                             const GError* error);
+
+void hb_fetch_cache_get_stats(const HbFetchCache* cache, HbFetchStats* stats);
+
+// Replace the monotonic clock (microseconds) used for expiry, for tests. NULL restores the default.
+void hb_fetch_cache_set_clock(HbFetchCache* cache, gint64 (*now)(void));
+
+// Time to live for a response with the given Cache-Control header (may be NULL): max-age when
+// present, 0 for no-store/no-cache, default_ttl_s otherwise.
+guint hb_fetch_ttl(const gchar* cache_control, guint default_ttl_s);
+
+void hb_fetch_response_free(HbFetchResponse* response);
+
+#endif // HB_FETCH_H
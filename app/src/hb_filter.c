@@ -0,0 +1,163 @@
+#include "hb_filter.h"
+#include "hb_trace.h"
+
+static WebKitUserContentFilterStore* hb_filter_store = NULL;
+static GPtrArray* hb_filters = NULL;  // WebKitUserContentFilter*, ready to attach
+static GPtrArray* hb_filter_targets = NULL; // GWeakRef* to managers waiting for pending filters
+static GHashTable* hb_filter_ids = NULL; // identifiers of the configured files
+static guint hb_filter_pending = 0; // rule files still being loaded or compiled
+
+typedef struct
+{
+    gchar* path;
+    gchar* identifier;
+    GBytes* source;
+    gint64 started_us;
+} HbFilterJob;
+
+static void hb_filter_job_free(HbFilterJob* job)
+{
+    g_free(job->path);
+    g_free(job->identifier);
+    if (job->source) g_bytes_unref(job->source);
+    g_free(job);
+}
+
+static void hb_weak_ref_free(gpointer data)
+{
+    GWeakRef* ref = data;
+    g_weak_ref_clear(ref);
+    g_free(ref);
+}
+
+gboolean hb_filter_is_enabled(void)
+{
+    return hb_filter_store != NULL;
+}
+
+void hb_filter_attach(WebKitUserContentManager* ucm)
+{
+    if (!hb_filter_store || !ucm) return;
+    for (guint i = 0; i < hb_filters->len; i++)
+    {
+        webkit_user_content_manager_add_filter(ucm, g_ptr_array_index(hb_filters, i));
+    }
+    if (hb_filter_pending == 0) return;
+
+    // Forget managers whose views are gone before remembering another one
+    for (guint i = hb_filter_targets->len; i > 0; i--)
+    {
+        GObject* obj = g_weak_ref_get(g_ptr_array_index(hb_filter_targets, i - 1));
+        if (obj) g_object_unref(obj);
+        else g_ptr_array_remove_index_fast(hb_filter_targets, i - 1);
+    }
+    GWeakRef* ref = g_new0(GWeakRef, 1);
+    g_weak_ref_init(ref, ucm);
+    g_ptr_array_add(hb_filter_targets, ref);
+}
+
+static void on_identifiers_fetched(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    gchar** ids = webkit_user_content_filter_store_fetch_identifiers_finish(WEBKIT_USER_CONTENT_FILTER_STORE(source), result);
+    for (gchar** id = ids; id && *id; id++)
+    {
+        if (g_hash_table_contains(hb_filter_ids, *id)) continue;
+        webkit_user_content_filter_store_remove(WEBKIT_USER_CONTENT_FILTER_STORE(source), *id, NULL, NULL, NULL);
+    }
+    g_strfreev(ids);
+}
+
+static void hb_filter_job_done(HbFilterJob* job, WebKitUserContentFilter* filter)
+{
+    if (filter)
+    {
+        g_ptr_array_add(hb_filters, filter);
+        for (guint i = 0; i < hb_filter_targets->len; i++)
+        {
+            WebKitUserContentManager* ucm = g_weak_ref_get(g_ptr_array_index(hb_filter_targets, i));
+            if (!ucm) continue;
+            webkit_user_content_manager_add_filter(ucm, filter);
+            g_object_unref(ucm);
+        }
+    }
+    hb_filter_job_free(job);
+
+    if (--hb_filter_pending > 0) return;
+    g_ptr_array_set_size(hb_filter_targets, 0);
+    // Drop compiled forms of rule files that changed or are no longer configured
+    webkit_user_content_filter_store_fetch_identifiers(hb_filter_store, NULL, on_identifiers_fetched, NULL);
+}
+
+static void on_filter_saved(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbFilterJob* job = user_data;
+    GError* error = NULL;
+    WebKitUserContentFilter* filter =
+        webkit_user_content_filter_store_save_finish(WEBKIT_USER_CONTENT_FILTER_STORE(source), result, &error);
+    if (filter)
+    {
+        g_message("Compiled content filter %s", job->path);
+        hb_trace_span(HB_TRACE_TRACK_MAIN, "content_filter_compile", job->started_us);
+    }
+    else
+    {
+        g_warning("Invalid content filter %s: %s", job->path, error->message);
+        g_error_free(error);
+    }
+    hb_filter_job_done(job, filter);
+}
+
+static void on_filter_loaded(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbFilterJob* job = user_data;
+    GError* error = NULL;
+    WebKitUserContentFilter* filter =
+        webkit_user_content_filter_store_load_finish(WEBKIT_USER_CONTENT_FILTER_STORE(source), result, &error);
+    if (filter)
+    {
+        hb_trace_span(HB_TRACE_TRACK_MAIN, "content_filter_load", job->started_us);
+        hb_filter_job_done(job, filter);
+        return;
+    }
+
+    // First use of this version of the file: compile it
+    g_error_free(error);
+    job->started_us = hb_trace_now();
+    webkit_user_content_filter_store_save(hb_filter_store, job->identifier, job->source, NULL, on_filter_saved, job);
+}
+
+void hb_filter_init(const gchar* const* rule_files, const gchar* store_dir)
+{
+    if (hb_filter_store || !rule_files || !rule_files[0] || !store_dir) return;
+
+    hb_filter_store = webkit_user_content_filter_store_new(store_dir);
+    hb_filters = g_ptr_array_new_with_free_func((GDestroyNotify)webkit_user_content_filter_unref);
+    hb_filter_targets = g_ptr_array_new_with_free_func(hb_weak_ref_free);
+    hb_filter_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    for (const gchar* const* path = rule_files; *path; path++)
+    {
+        gchar* contents = NULL;
+        gsize len = 0;
+        GError* error = NULL;
+        if (!g_file_get_contents(*path, &contents, &len, &error))
+        {
+            g_warning("Cannot read content filter %s: %s", *path, error->message);
+            g_error_free(error);
+            continue;
+        }
+
+        HbFilterJob* job = g_new0(HbFilterJob, 1);
+        job->path = g_strdup(*path);
+        job->source = g_bytes_new_take(contents, len);
+        // Same rules, same identifier: a compiled entry is reused until the file changes
+        gchar* digest = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, job->source);
+        job->identifier = g_strdup_printf("hb-%.32s", digest);
+        g_free(digest);
+        g_hash_table_add(hb_filter_ids, g_strdup(job->identifier));
+
+        hb_filter_pending++;
+        job->started_us = hb_trace_now();
+        webkit_user_content_filter_store_load(hb_filter_store, job->identifier, NULL, on_filter_loaded, job);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef HB_FILTER_H
+#define HB_FILTER_H
+
+#include <webkit/webkit.h>
+
+// ---------------- Content-blocking filters ----------------
+
+// Compile the content-blocker rule files (WebKit's JSON format) into a filter store in
+// store_dir, in the background. Each file is stored under an identifier derived from its
+// contents, so later startups load the compiled form and only changed files are recompiled;
+// compiled entries of files no longer configured are removed. Only the first call has an effect.
+void hb_filter_init(const gchar* const* rule_files, const gchar* store_dir);
+
+// TRUE if hb_filter_init() was given at least one rule file.
+gboolean hb_filter_is_enabled(void);
+
+// Apply every filter to ucm: those already compiled right away, the others as they become ready.
+void hb_filter_attach(WebKitUserContentManager* ucm);
+
+#endif // HB_FILTER_H
@@ -0,0 +1,65 @@
+#include "hb_fps.h"
+#include <string.h>
+
+const guint hb_frame_time_bucket_ms[HB_FRAME_TIME_BUCKETS - 1] = {17, 33, 50, 100};
+
+void hb_frame_stats_reset(HbFrameStats* stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+}
+
+void hb_frame_stats_add(HbFrameStats* stats, gint64 timestamp_us)
+{
+    if (!stats) return;
+    stats->frames[stats->head] = timestamp_us;
+    stats->head = (stats->head + 1) % HB_FRAME_STATS_HISTORY;
+    if (stats->count < HB_FRAME_STATS_HISTORY) stats->count++;
+}
+
+gdouble hb_frame_stats_fps(const HbFrameStats* stats, gint64 now_us, gint64 span_us)
+{
+    if (!stats || span_us <= 0) return 0.0;
+
+    guint n = 0;
+    gint64 since = now_us - span_us;
+    // Walk backwards from the newest frame until we leave the span
+    for (guint i = 0; i < stats->count; i++)
+    {
+        guint idx = (stats->head + HB_FRAME_STATS_HISTORY - 1 - i) % HB_FRAME_STATS_HISTORY;
+        gint64 t = stats->frames[idx];
+        if (t <= since) break;
+        if (t <= now_us) n++;
+    }
+    return (gdouble)n * G_USEC_PER_SEC / (gdouble)span_us;
+}
+
+guint hb_frame_stats_histogram(const HbFrameStats* stats,
+                               gint64 now_us,
+                               gint64 span_us,
+                               guint buckets[HB_FRAME_TIME_BUCKETS])
+{
+    memset(buckets, 0, sizeof(guint) * HB_FRAME_TIME_BUCKETS);
+    if (!stats || span_us <= 0) return 0;
+
+    guint n = 0;
+    gint64 since = now_us - span_us;
+    gint64 later = -1; // the frame after the current one, once inside the span
+    for (guint i = 0; i < stats->count; i++)
+    {
+        guint idx = (stats->head + HB_FRAME_STATS_HISTORY - 1 - i) % HB_FRAME_STATS_HISTORY;
+        gint64 t = stats->frames[idx];
+        if (t <= since) break;
+        if (t > now_us) continue;
+        if (later >= 0)
+        {
+            gint64 interval_ms = (later - t) / 1000;
+            guint b = 0;
+            while (b < HB_FRAME_TIME_BUCKETS - 1 && interval_ms > hb_frame_time_bucket_ms[b]) b++;
+            buckets[b]++;
+            n++;
+        }
+        later = t;
+    }
+    return n;
+}
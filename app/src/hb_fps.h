@@ -0,0 +1,40 @@
+#ifndef HB_FPS_H
+#define HB_FPS_H
+
+#include <glib.h>
+
+// ---------------- Frame statistics ----------------
+
+// Enough frames for the longest span asked for (the 5 s --show-fps report) at 240 Hz, so an
+// uncapped window on a fast display isn't under-reported; 16 KiB, only while frames are watched
+#define HB_FRAME_STATS_HISTORY 2048
+
+// Ring buffer of recent frame presentation times (monotonic microseconds).
+typedef struct
+{
+    gint64 frames[HB_FRAME_STATS_HISTORY];
+    guint head;  // index of the next slot to write
+    guint count; // number of valid entries (<= HB_FRAME_STATS_HISTORY)
+} HbFrameStats;
+
+void hb_frame_stats_reset(HbFrameStats* stats);
+
+// Record a presented frame at timestamp_us (g_get_monotonic_time() or frame clock time).
+void hb_frame_stats_add(HbFrameStats* stats, gint64 timestamp_us);
+
+// Frames per second over the span_us microseconds ending at now_us.
+gdouble hb_frame_stats_fps(const HbFrameStats* stats, gint64 now_us, gint64 span_us);
+
+// Frame-time histogram: intervals between consecutive frames of at most 17, 33, 50 and 100 ms
+// (up to 60, 30, 20 and 10 fps), and longer ones.
+#define HB_FRAME_TIME_BUCKETS 5
+extern const guint hb_frame_time_bucket_ms[HB_FRAME_TIME_BUCKETS - 1];
+
+// Sort the intervals between frames presented during the span_us microseconds ending at now_us
+// into buckets. Returns the number of intervals counted.
+guint hb_frame_stats_histogram(const HbFrameStats* stats,
+                               gint64 now_us,
+                               gint64 span_us,
+                               guint buckets[HB_FRAME_TIME_BUCKETS]);
+
+#endif // HB_FPS_H
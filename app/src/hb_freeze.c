@@ -0,0 +1,205 @@
+#include "hb_freeze.h"
+#include "hb_trace.h"
+#include <webkit/webkit.h>
+
+typedef struct
+{
+    HbWindow* win; // not owned; only touched while cancellable isn't cancelled
+    GCancellable* cancellable;
+    gint64 started_us;
+} HbFreezeSnapshot;
+
+static gboolean on_freeze_check(gpointer user_data);
+
+static void hb_freeze_arm(HbWindow* win, guint seconds)
+{
+    g_clear_handle_id(&win->freeze_source, g_source_remove);
+    win->freeze_source = g_timeout_add_seconds(MAX(seconds, 1), on_freeze_check, win);
+}
+
+static void on_snapshot_ready(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbFreezeSnapshot* snap = user_data;
+    GError* error = NULL;
+    GdkTexture* texture = webkit_web_view_get_snapshot_finish(WEBKIT_WEB_VIEW(source), result, &error);
+    if (g_cancellable_is_cancelled(snap->cancellable))
+    {
+        if (texture) g_object_unref(texture);
+        g_clear_error(&error);
+        g_object_unref(snap->cancellable);
+        g_free(snap);
+        return;
+    }
+
+    HbWindow* win = snap->win;
+    g_clear_object(&win->freeze_snapshot);
+    if (!texture)
+    {
+        g_message("Cannot freeze window '%s': %s", win->cfg.title, error->message);
+        g_error_free(error);
+        hb_freeze_arm(win, win->cfg.freeze_after);
+    }
+    else if (win->last_activity_us > snap->started_us || GTK_WIDGET(source) != win->web_view)
+    {
+        // Input or a new page while the snapshot was taken: it's already stale
+        g_object_unref(texture);
+        hb_freeze_arm(win, win->cfg.freeze_after);
+    }
+    else
+    {
+        GtkWidget* picture = gtk_picture_new_for_paintable(GDK_PAINTABLE(texture));
+        gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_FILL);
+        gtk_picture_set_can_shrink(GTK_PICTURE(picture), TRUE);
+        g_object_unref(texture);
+
+        // Keep the view alive while it's out of the window; unmapped, WebKit suspends the page
+        g_object_ref(win->web_view);
+        win->frozen = picture;
+        hb_window_set_content(win, picture);
+        hb_trace_instant(win->trace_track, "freeze");
+    }
+
+    g_object_unref(snap->cancellable);
+    g_free(snap);
+}
+
+static gboolean on_freeze_check(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    win->freeze_source = 0;
+    if (win->cfg.freeze_after == 0 || win->frozen || win->freeze_snapshot) return G_SOURCE_REMOVE;
+
+    gint64 idle_s = (g_get_monotonic_time() - win->last_activity_us) / G_USEC_PER_SEC;
+    if (idle_s < win->cfg.freeze_after)
+    {
+        hb_freeze_arm(win, win->cfg.freeze_after - (guint)idle_s);
+        return G_SOURCE_REMOVE;
+    }
+    // Only a mapped, settled page can be captured
+    if (win->hidden || !gtk_widget_get_mapped(win->web_view) ||
+        webkit_web_view_is_loading(WEBKIT_WEB_VIEW(win->web_view)))
+    {
+        hb_freeze_arm(win, win->cfg.freeze_after);
+        return G_SOURCE_REMOVE;
+    }
+
+    HbFreezeSnapshot* snap = g_new0(HbFreezeSnapshot, 1);
+    snap->win = win;
+    snap->cancellable = g_cancellable_new();
+    snap->started_us = g_get_monotonic_time();
+    win->freeze_snapshot = g_object_ref(snap->cancellable);
+    webkit_web_view_get_snapshot(WEBKIT_WEB_VIEW(win->web_view),
+                                 WEBKIT_SNAPSHOT_REGION_VISIBLE,
+                                 win->cfg.transparent ? WEBKIT_SNAPSHOT_OPTIONS_TRANSPARENT_BACKGROUND
+                                                      : WEBKIT_SNAPSHOT_OPTIONS_NONE,
+                                 snap->cancellable,
+                                 on_snapshot_ready,
+                                 snap);
+    return G_SOURCE_REMOVE;
+}
+
+void hb_freeze_thaw(HbWindow* win)
+{
+    if (!win || !win->frozen) return;
+    win->frozen = NULL;
+    hb_window_set_content(win, win->web_view);
+    g_object_unref(win->web_view);
+    hb_trace_instant(win->trace_track, "thaw");
+}
+
+void hb_freeze_note_activity(HbWindow* win)
+{
+    if (!win) return;
+    win->last_activity_us = g_get_monotonic_time();
+    if (win->cfg.freeze_after == 0) return;
+    if (win->frozen)
+    {
+        hb_freeze_thaw(win);
+        hb_freeze_arm(win, win->cfg.freeze_after);
+    }
+    // Otherwise the pending check sees the new timestamp and waits again
+}
+
+static void on_freeze_pointer(GtkEventControllerMotion* motion, gdouble x, gdouble y, gpointer user_data)
+{
+    hb_freeze_note_activity(user_data);
+}
+
+static void on_freeze_click(GtkGestureClick* gesture, gint n_press, gdouble x, gdouble y, gpointer user_data)
+{
+    hb_freeze_note_activity(user_data);
+}
+
+static gboolean on_freeze_key(GtkEventControllerKey* key, guint keyval, guint keycode,
+                              GdkModifierType state, gpointer user_data)
+{
+    hb_freeze_note_activity(user_data);
+    return FALSE;
+}
+
+static gboolean on_freeze_scroll(GtkEventControllerScroll* scroll, gdouble dx, gdouble dy, gpointer user_data)
+{
+    hb_freeze_note_activity(user_data);
+    return FALSE;
+}
+
+// Input anywhere in the window, seen before the web view (or the snapshot) handles it
+static void hb_freeze_watch_input(HbWindow* win)
+{
+    GtkWidget* window = GTK_WIDGET(win->window);
+
+    GtkEventController* motion = gtk_event_controller_motion_new();
+    gtk_event_controller_set_propagation_phase(motion, GTK_PHASE_CAPTURE);
+    g_signal_connect(motion, "enter", G_CALLBACK(on_freeze_pointer), win);
+    g_signal_connect(motion, "motion", G_CALLBACK(on_freeze_pointer), win);
+    gtk_widget_add_controller(window, motion);
+
+    GtkGesture* click = gtk_gesture_click_new();
+    gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(click), 0);
+    gtk_event_controller_set_propagation_phase(GTK_EVENT_CONTROLLER(click), GTK_PHASE_CAPTURE);
+    g_signal_connect(click, "pressed", G_CALLBACK(on_freeze_click), win);
+    gtk_widget_add_controller(window, GTK_EVENT_CONTROLLER(click));
+
+    GtkEventController* key = gtk_event_controller_key_new();
+    gtk_event_controller_set_propagation_phase(key, GTK_PHASE_CAPTURE);
+    g_signal_connect(key, "key-pressed", G_CALLBACK(on_freeze_key), win);
+    gtk_widget_add_controller(window, key);
+
+    GtkEventController* scroll = gtk_event_controller_scroll_new(GTK_EVENT_CONTROLLER_SCROLL_BOTH_AXES);
+    gtk_event_controller_set_propagation_phase(scroll, GTK_PHASE_CAPTURE);
+    g_signal_connect(scroll, "scroll", G_CALLBACK(on_freeze_scroll), win);
+    gtk_widget_add_controller(window, scroll);
+
+    win->freeze_watching = TRUE;
+}
+
+void hb_freeze_schedule(HbWindow* win)
+{
+    if (!win) return;
+    g_clear_handle_id(&win->freeze_source, g_source_remove);
+    if (win->cfg.freeze_after == 0)
+    {
+        if (win->freeze_snapshot) g_cancellable_cancel(win->freeze_snapshot);
+        g_clear_object(&win->freeze_snapshot);
+        hb_freeze_thaw(win);
+        return;
+    }
+
+    if (!win->freeze_watching) hb_freeze_watch_input(win);
+    win->last_activity_us = g_get_monotonic_time();
+    if (!win->frozen && !win->freeze_snapshot) hb_freeze_arm(win, win->cfg.freeze_after);
+}
+
+void hb_freeze_clear(HbWindow* win)
+{
+    if (!win) return;
+    g_clear_handle_id(&win->freeze_source, g_source_remove);
+    if (win->freeze_snapshot) g_cancellable_cancel(win->freeze_snapshot);
+    g_clear_object(&win->freeze_snapshot);
+    if (win->frozen)
+    {
+        // The window is going away with the snapshot as its child
+        win->frozen = NULL;
+        g_object_unref(win->web_view);
+    }
+}
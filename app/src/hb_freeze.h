@@ -0,0 +1,24 @@
+#ifndef HB_FREEZE_H
+#define HB_FREEZE_H
+
+#include "hb_window.h"
+
+// ---------------- Freeze to snapshot ----------------
+
+// (Re)arm the window's idle check according to cfg.freeze_after; with 0 the window is thawed and
+// stays live. Once nothing happened for freeze_after seconds (no pointer, key or scroll input,
+// page load or push), a snapshot of the page replaces the web view. The unparented view is kept
+// but suspended like a hidden one: no painting, no animation frames, throttled timers.
+// Hovering or clicking the window brings the live view back.
+void hb_freeze_schedule(HbWindow* win);
+
+// Something happened that the user should see live: thaw, and restart the idle period.
+void hb_freeze_note_activity(HbWindow* win);
+
+// Put the live web view back in place of the snapshot, if frozen.
+void hb_freeze_thaw(HbWindow* win);
+
+// Stop the idle check, cancel a snapshot in flight and release a frozen view.
+void hb_freeze_clear(HbWindow* win);
+
+#endif // HB_FREEZE_H
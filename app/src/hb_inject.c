@@ -0,0 +1,112 @@
+#include "hb_inject.h"
+#include <glib/gstdio.h>
+#include <errno.h>
+
+typedef struct
+{
+    gint64 mtime;
+    goffset size;
+    gpointer content; // WebKitUserStyleSheet* or WebKitUserScript*; NULL when the file is unreadable
+} HbInjectEntry;
+
+static GHashTable* hb_inject_sheets = NULL;  // path -> HbInjectEntry* (style sheets)
+static GHashTable* hb_inject_scripts = NULL; // path -> HbInjectEntry* (scripts)
+static gchar** hb_inject_global_css = NULL;
+static gchar** hb_inject_global_js = NULL;
+
+static void hb_inject_sheet_entry_free(gpointer data)
+{
+    HbInjectEntry* entry = data;
+    if (entry->content) webkit_user_style_sheet_unref(entry->content);
+    g_free(entry);
+}
+
+static void hb_inject_script_entry_free(gpointer data)
+{
+    HbInjectEntry* entry = data;
+    if (entry->content) webkit_user_script_unref(entry->content);
+    g_free(entry);
+}
+
+static void hb_inject_ensure_tables(void)
+{
+    if (hb_inject_sheets) return;
+    hb_inject_sheets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, hb_inject_sheet_entry_free);
+    hb_inject_scripts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, hb_inject_script_entry_free);
+}
+
+// Cached content for path, (re)read when the file changed; NULL if it can't be read
+static gpointer hb_inject_lookup(GHashTable* table, const gchar* path, gboolean is_script)
+{
+    GStatBuf st;
+    gboolean found = g_stat(path, &st) == 0;
+    HbInjectEntry* entry = g_hash_table_lookup(table, path);
+    if (entry && found && entry->mtime == (gint64)st.st_mtime && entry->size == (goffset)st.st_size)
+    {
+        return entry->content;
+    }
+    if (entry && !found && !entry->content) return NULL; // still missing; already reported
+
+    gchar* source = NULL;
+    GError* error = NULL;
+    if (!found || !g_file_get_contents(path, &source, NULL, &error))
+    {
+        g_warning("Cannot read %s %s: %s", is_script ? "user script" : "user style sheet", path,
+                  error ? error->message : g_strerror(errno));
+        g_clear_error(&error);
+    }
+
+    HbInjectEntry* fresh = g_new0(HbInjectEntry, 1);
+    if (found)
+    {
+        fresh->mtime = (gint64)st.st_mtime;
+        fresh->size = (goffset)st.st_size;
+    }
+    if (source && is_script)
+    {
+        fresh->content = webkit_user_script_new(source,
+                                                WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                                                WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_END,
+                                                NULL, NULL);
+    }
+    else if (source)
+    {
+        fresh->content = webkit_user_style_sheet_new(source,
+                                                     WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+                                                     WEBKIT_USER_STYLE_LEVEL_USER,
+                                                     NULL, NULL);
+    }
+    g_free(source);
+    g_hash_table_replace(table, g_strdup(path), fresh);
+    return fresh->content;
+}
+
+static void hb_inject_add_files(WebKitUserContentManager* ucm, gchar* const* css, gchar* const* js)
+{
+    for (gchar* const* path = css; path && *path; path++)
+    {
+        WebKitUserStyleSheet* sheet = hb_inject_lookup(hb_inject_sheets, *path, FALSE);
+        if (sheet) webkit_user_content_manager_add_style_sheet(ucm, sheet);
+    }
+    for (gchar* const* path = js; path && *path; path++)
+    {
+        WebKitUserScript* script = hb_inject_lookup(hb_inject_scripts, *path, TRUE);
+        if (script) webkit_user_content_manager_add_script(ucm, script);
+    }
+}
+
+void hb_inject_set_global(const gchar* const* user_css, const gchar* const* user_js)
+{
+    g_strfreev(hb_inject_global_css);
+    g_strfreev(hb_inject_global_js);
+    hb_inject_global_css = g_strdupv((gchar**)user_css);
+    hb_inject_global_js = g_strdupv((gchar**)user_js);
+}
+
+void hb_inject_apply(WebKitUserContentManager* ucm, const HbWindowCfg* cfg)
+{
+    if (!ucm) return;
+    hb_inject_ensure_tables();
+    hb_inject_add_files(ucm, hb_inject_global_css, hb_inject_global_js);
+    if (cfg) hb_inject_add_files(ucm, cfg->user_css, cfg->user_js);
+}
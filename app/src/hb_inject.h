@@ -0,0 +1,21 @@
+#ifndef HB_INJECT_H
+#define HB_INJECT_H
+
+#include <webkit/webkit.h>
+#include "hb_config.h"
+
+// ---------------- User style sheets and scripts ----------------
+//
+// Files are read into a WebKitUserStyleSheet / WebKitUserScript once and shared by every view
+// that uses them; a file is only read again when its modification time or size changed.
+// Style sheets apply to all frames at user level (they win over the page's own !important
+// rules); scripts run in the top frame once the document is parsed.
+
+// Files applied to every window, before the window's own. Affects views built from now on.
+void hb_inject_set_global(const gchar* const* user_css, const gchar* const* user_js);
+
+// Add the global and cfg's user_css / user_js files to ucm. Unreadable files are skipped (with a
+// warning the first time).
+void hb_inject_apply(WebKitUserContentManager* ucm, const HbWindowCfg* cfg);
+
+#endif // HB_INJECT_H
@@ -0,0 +1,106 @@
+#include "hb_lru.h"
+
+typedef struct
+{
+    gchar* key;
+    gpointer value;
+    guint64 size;
+} HbLruEntry;
+
+struct HbLru
+{
+    guint64 max_bytes;
+    guint64 size;
+    GDestroyNotify value_free;
+    GHashTable* index; // key (owned by the entry) -> GList* link in order
+    GQueue order;      // HbLruEntry*, most recently used at the head
+};
+
+HbLru* hb_lru_new(guint64 max_bytes, GDestroyNotify value_free)
+{
+    HbLru* lru = g_new0(HbLru, 1);
+    lru->max_bytes = max_bytes;
+    lru->value_free = value_free;
+    lru->index = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&lru->order);
+    return lru;
+}
+
+static void hb_lru_unlink(HbLru* lru, GList* link)
+{
+    HbLruEntry* e = link->data;
+    g_hash_table_remove(lru->index, e->key);
+    g_queue_delete_link(&lru->order, link);
+    lru->size -= e->size;
+    if (lru->value_free && e->value) lru->value_free(e->value);
+    g_free(e->key);
+    g_free(e);
+}
+
+void hb_lru_clear(HbLru* lru)
+{
+    if (!lru) return;
+    while (lru->order.tail) hb_lru_unlink(lru, lru->order.tail);
+}
+
+void hb_lru_free(HbLru* lru)
+{
+    if (!lru) return;
+    hb_lru_clear(lru);
+    g_hash_table_unref(lru->index);
+    g_free(lru);
+}
+
+gpointer hb_lru_lookup(HbLru* lru, const gchar* key)
+{
+    if (!lru || !key) return NULL;
+    GList* link = g_hash_table_lookup(lru->index, key);
+    if (!link) return NULL;
+    g_queue_unlink(&lru->order, link);
+    g_queue_push_head_link(&lru->order, link);
+    return ((HbLruEntry*)link->data)->value;
+}
+
+gboolean hb_lru_insert(HbLru* lru, const gchar* key, gpointer value, guint64 size)
+{
+    if (!lru || !key) return FALSE;
+    hb_lru_remove(lru, key);
+    if (size > lru->max_bytes)
+    {
+        if (lru->value_free && value) lru->value_free(value);
+        return FALSE;
+    }
+
+    while (lru->order.tail && lru->size + size > lru->max_bytes)
+    {
+        hb_lru_unlink(lru, lru->order.tail);
+    }
+
+    HbLruEntry* e = g_new0(HbLruEntry, 1);
+    e->key = g_strdup(key);
+    e->value = value;
+    e->size = size;
+    g_queue_push_head(&lru->order, e);
+    g_hash_table_insert(lru->index, e->key, lru->order.head);
+    lru->size += size;
+    return TRUE;
+}
+
+gboolean hb_lru_remove(HbLru* lru, const gchar* key)
+{
+    if (!lru || !key) return FALSE;
+    GList* link = g_hash_table_lookup(lru->index, key);
+    if (!link) return FALSE;
+    hb_lru_unlink(lru, link);
+    return TRUE;
+}
+
+guint hb_lru_get_count(const HbLru* lru)
+{
+    return lru ? lru->order.length : 0;
+}
+
+guint64 hb_lru_get_size(const HbLru* lru)
+{
+    return lru ? lru->size : 0;
+}
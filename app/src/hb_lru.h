@@ -0,0 +1,29 @@
+#ifndef HB_LRU_H
+#define HB_LRU_H
+
+#include <glib.h>
+
+// ---------------- Size-bounded LRU cache ----------------
+
+// String-keyed cache that evicts least recently used entries once the summed entry sizes
+// exceed a byte budget. Not thread-safe.
+typedef struct HbLru HbLru;
+
+// value_free (may be NULL) releases values when they are evicted, replaced or removed.
+HbLru* hb_lru_new(guint64 max_bytes, GDestroyNotify value_free);
+void hb_lru_free(HbLru* lru);
+
+// Look up key and mark it most recently used. Returns NULL if absent; the value stays owned by the cache.
+gpointer hb_lru_lookup(HbLru* lru, const gchar* key);
+
+// Insert (or replace) key, taking ownership of value. Entries larger than the whole budget are
+// not cached: value is released right away and FALSE is returned.
+gboolean hb_lru_insert(HbLru* lru, const gchar* key, gpointer value, guint64 size);
+
+gboolean hb_lru_remove(HbLru* lru, const gchar* key);
+void hb_lru_clear(HbLru* lru);
+
+guint hb_lru_get_count(const HbLru* lru);
+guint64 hb_lru_get_size(const HbLru* lru);
+
+#endif // HB_LRU_H
@@ -0,0 +1,310 @@
+#include "hb_metrics.h"
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <glib/gstdio.h>
+#include <math.h>
+#include <sys/stat.h>
+
+// Interval of the main-loop latency probe
+#define HB_METRICS_PROBE_INTERVAL_MS 250
+
+struct HbMetricsServer
+{
+    gchar* socket_path; // NULL when only listening on a port
+    GSocketService* service;
+    GCancellable* cancellable;
+    HbMetricsCollectFunc collect;
+    gpointer user_data;
+};
+
+// One scrape: read the request head, then write the response and close
+typedef struct
+{
+    HbMetricsServer* server; // only valid while server_cancellable isn't cancelled
+    GCancellable* server_cancellable;
+    gulong server_cancelled_id;
+    GCancellable* cancellable; // cancelled when the server goes away or the deadline passes
+    guint deadline_source;
+    GSocketConnection* connection;
+    GString* head; // request head received so far
+    gchar buf[1024];
+    gchar* response;
+} HbMetricsRequest;
+
+static void hb_metrics_request_free(HbMetricsRequest* req)
+{
+    g_clear_handle_id(&req->deadline_source, g_source_remove);
+    g_cancellable_disconnect(req->server_cancellable, req->server_cancelled_id);
+    g_io_stream_close(G_IO_STREAM(req->connection), NULL, NULL);
+    g_object_unref(req->connection);
+    g_object_unref(req->cancellable);
+    g_object_unref(req->server_cancellable);
+    g_string_free(req->head, TRUE);
+    g_free(req->response);
+    g_free(req);
+}
+
+void hb_metrics_append_header(GString* out, const gchar* name, const gchar* type, const gchar* help)
+{
+    g_string_append_printf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void hb_metrics_append_escaped(GString* out, const gchar* value)
+{
+    for (const gchar* p = value ? value : ""; *p; p++)
+    {
+        switch (*p)
+        {
+        case '\\':
+            g_string_append(out, "\\\\");
+            break;
+        case '"':
+            g_string_append(out, "\\\"");
+            break;
+        case '\n':
+            g_string_append(out, "\\n");
+            break;
+        default:
+            g_string_append_c(out, *p);
+            break;
+        }
+    }
+}
+
+void hb_metrics_append_sample(GString* out, const gchar* name, const gchar* const* labels, gdouble value)
+{
+    g_string_append(out, name);
+    if (labels && labels[0])
+    {
+        g_string_append_c(out, '{');
+        for (guint i = 0; labels[i] && labels[i + 1]; i += 2)
+        {
+            if (i > 0) g_string_append_c(out, ',');
+            g_string_append_printf(out, "%s=\"", labels[i]);
+            hb_metrics_append_escaped(out, labels[i + 1]);
+            g_string_append_c(out, '"');
+        }
+        g_string_append_c(out, '}');
+    }
+
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    if (isnan(value)) g_string_append(out, " NaN\n");
+    else if (isinf(value)) g_string_append(out, value > 0 ? " +Inf\n" : " -Inf\n");
+    else g_string_append_printf(out, " %s\n", g_ascii_dtostr(buf, sizeof(buf), value));
+}
+
+static void on_response_written(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbMetricsRequest* req = user_data;
+    g_output_stream_write_all_finish(G_OUTPUT_STREAM(source), result, NULL, NULL);
+    hb_metrics_request_free(req);
+}
+
+// request_line is NULL when the request head was too large
+static void hb_metrics_respond(HbMetricsRequest* req, const gchar* request_line)
+{
+    // "GET /metrics HTTP/1.1": any path but only GET/HEAD
+    gboolean head = request_line && g_str_has_prefix(request_line, "HEAD ");
+    const gchar* status = "200 OK";
+    GString* body = g_string_new(NULL);
+    if (!request_line)
+    {
+        status = "400 Bad Request";
+        g_string_append(body, "request too large\n");
+    }
+    else if (head || g_str_has_prefix(request_line, "GET "))
+    {
+        req->server->collect(body, req->server->user_data);
+    }
+    else
+    {
+        status = "405 Method Not Allowed";
+        g_string_append(body, "method not allowed\n");
+    }
+
+    GString* response = g_string_new(NULL);
+    g_string_append_printf(response,
+                           "HTTP/1.0 %s\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+                           "Connection: close\r\n"
+                           "\r\n",
+                           status, body->len);
+    if (!head) g_string_append_len(response, body->str, (gssize)body->len);
+    g_string_free(body, TRUE);
+
+    gsize len = response->len;
+    req->response = g_string_free(response, FALSE);
+    GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(req->connection));
+    g_output_stream_write_all_async(out, req->response, len, G_PRIORITY_DEFAULT, req->cancellable,
+                                    on_response_written, req);
+}
+
+static void on_request_read(GObject* source, GAsyncResult* result, gpointer user_data);
+
+static void hb_metrics_read_head(HbMetricsRequest* req)
+{
+    // Never past the limit: whatever follows the head (a body, a pipelined request) is ignored
+    gsize want = MIN(sizeof(req->buf), HB_METRICS_MAX_REQUEST_HEAD - req->head->len);
+    GInputStream* in = g_io_stream_get_input_stream(G_IO_STREAM(req->connection));
+    g_input_stream_read_async(in, req->buf, want, G_PRIORITY_DEFAULT, req->cancellable, on_request_read, req);
+}
+
+static void on_request_read(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbMetricsRequest* req = user_data;
+    gssize n = g_input_stream_read_finish(G_INPUT_STREAM(source), result, NULL);
+    if (n <= 0 || g_cancellable_is_cancelled(req->cancellable))
+    {
+        hb_metrics_request_free(req);
+        return;
+    }
+    g_string_append_len(req->head, req->buf, n);
+
+    // Headers are not needed, only the request line
+    if (g_strstr_len(req->head->str, (gssize)req->head->len, "\r\n\r\n"))
+    {
+        gchar* eol = g_strstr_len(req->head->str, (gssize)req->head->len, "\r\n");
+        g_string_truncate(req->head, eol - req->head->str);
+        hb_metrics_respond(req, req->head->str);
+    }
+    else if (req->head->len >= HB_METRICS_MAX_REQUEST_HEAD)
+    {
+        hb_metrics_respond(req, NULL);
+    }
+    else
+    {
+        hb_metrics_read_head(req);
+    }
+}
+
+static void on_server_cancelled(GCancellable* cancellable, gpointer user_data)
+{
+    HbMetricsRequest* req = user_data;
+    g_cancellable_cancel(req->cancellable);
+}
+
+static gboolean on_request_deadline(gpointer user_data)
+{
+    HbMetricsRequest* req = user_data;
+    req->deadline_source = 0;
+    // The pending read or write fails and frees the request
+    g_cancellable_cancel(req->cancellable);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_incoming(GSocketService* service,
+                            GSocketConnection* connection,
+                            GObject* source_object,
+                            gpointer user_data)
+{
+    HbMetricsServer* server = user_data;
+    HbMetricsRequest* req = g_new0(HbMetricsRequest, 1);
+    req->server = server;
+    req->cancellable = g_cancellable_new();
+    req->server_cancellable = g_object_ref(server->cancellable);
+    req->server_cancelled_id =
+        g_cancellable_connect(server->cancellable, G_CALLBACK(on_server_cancelled), req, NULL);
+    req->connection = g_object_ref(connection);
+    req->head = g_string_new(NULL);
+    // A client that never finishes its request (or never reads the response) doesn't hold on
+    req->deadline_source = g_timeout_add_seconds(HB_METRICS_REQUEST_TIMEOUT_S, on_request_deadline, req);
+    hb_metrics_read_head(req);
+    return TRUE;
+}
+
+HbMetricsServer* hb_metrics_server_new(const gchar* socket_path,
+                                       guint port,
+                                       HbMetricsCollectFunc collect,
+                                       gpointer user_data,
+                                       GError** error)
+{
+    g_return_val_if_fail(collect != NULL && (socket_path || port > 0), NULL);
+
+    GSocketService* service = g_socket_service_new();
+    gboolean ok = TRUE;
+    if (socket_path)
+    {
+        GStatBuf st;
+        if (g_lstat(socket_path, &st) == 0 && S_ISSOCK(st.st_mode)) g_unlink(socket_path);
+        GSocketAddress* address = g_unix_socket_address_new(socket_path);
+        ok = g_socket_listener_add_address(G_SOCKET_LISTENER(service), address, G_SOCKET_TYPE_STREAM,
+                                           G_SOCKET_PROTOCOL_DEFAULT, NULL, NULL, error);
+        g_object_unref(address);
+        if (ok) g_chmod(socket_path, 0600);
+    }
+    if (ok && port > 0)
+    {
+        // Loopback only: metrics include window titles and addresses
+        GSocketAddress* address = g_inet_socket_address_new_from_string("127.0.0.1", port);
+        ok = g_socket_listener_add_address(G_SOCKET_LISTENER(service), address, G_SOCKET_TYPE_STREAM,
+                                           G_SOCKET_PROTOCOL_TCP, NULL, NULL, error);
+        g_object_unref(address);
+    }
+    if (!ok)
+    {
+        g_socket_listener_close(G_SOCKET_LISTENER(service));
+        g_object_unref(service);
+        if (socket_path) g_unlink(socket_path);
+        return NULL;
+    }
+
+    HbMetricsServer* server = g_new0(HbMetricsServer, 1);
+    server->socket_path = g_strdup(socket_path);
+    server->service = service;
+    server->cancellable = g_cancellable_new();
+    server->collect = collect;
+    server->user_data = user_data;
+    g_signal_connect(service, "incoming", G_CALLBACK(on_incoming), server);
+    g_socket_service_start(service);
+    return server;
+}
+
+void hb_metrics_server_free(HbMetricsServer* server)
+{
+    if (!server) return;
+    g_signal_handlers_disconnect_by_data(server->service, server);
+    g_socket_service_stop(server->service);
+    g_socket_listener_close(G_SOCKET_LISTENER(server->service));
+    g_object_unref(server->service);
+    g_cancellable_cancel(server->cancellable);
+    g_object_unref(server->cancellable);
+    if (server->socket_path) g_unlink(server->socket_path);
+    g_free(server->socket_path);
+    g_free(server);
+}
+
+// ---------------- Main-loop latency ----------------
+
+static guint hb_latency_source = 0;
+static gint64 hb_latency_due_us = 0;
+static gint64 hb_latency_last_us = 0;
+static gint64 hb_latency_max_us = 0; // since the last hb_metrics_append_latency()
+
+static gboolean on_latency_probe(gpointer user_data)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 late = MAX(now - hb_latency_due_us, 0);
+    hb_latency_last_us = late;
+    if (late > hb_latency_max_us) hb_latency_max_us = late;
+    hb_latency_due_us = now + HB_METRICS_PROBE_INTERVAL_MS * 1000;
+    return G_SOURCE_CONTINUE;
+}
+
+void hb_metrics_start_latency_probe(void)
+{
+    if (hb_latency_source) return;
+    hb_latency_due_us = g_get_monotonic_time() + HB_METRICS_PROBE_INTERVAL_MS * 1000;
+    hb_latency_source = g_timeout_add(HB_METRICS_PROBE_INTERVAL_MS, on_latency_probe, NULL);
+}
+
+void hb_metrics_append_latency(GString* out)
+{
+    hb_metrics_append_header(out, "hudbox_main_loop_latency_seconds", "gauge",
+                             "How late the most recent main-loop probe timer fired.");
+    hb_metrics_append_sample(out, "hudbox_main_loop_latency_seconds", NULL, hb_latency_last_us / 1e6);
+    hb_metrics_append_header(out, "hudbox_main_loop_latency_max_seconds", "gauge",
+                             "Worst main-loop probe delay since the previous scrape.");
+    hb_metrics_append_sample(out, "hudbox_main_loop_latency_max_seconds", NULL, hb_latency_max_us / 1e6);
+    hb_latency_max_us = 0;
+}
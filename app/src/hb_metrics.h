@@ -0,0 +1,42 @@
+#ifndef HB_METRICS_H
+#define HB_METRICS_H
+
+#include <glib.h>
+
+// ---------------- Metrics endpoint ----------------
+
+// Append the current metrics to out in the Prometheus text exposition format.
+typedef void (*HbMetricsCollectFunc)(GString* out, gpointer user_data);
+
+typedef struct HbMetricsServer HbMetricsServer;
+
+// Longest request head (request line and headers) the server reads; larger requests get a 400
+#define HB_METRICS_MAX_REQUEST_HEAD 8192
+
+// Seconds a client has to send its request and take the response before it is disconnected
+#define HB_METRICS_REQUEST_TIMEOUT_S 10
+
+// Serve metrics over HTTP on a Unix-domain socket (socket_path, mode 0600) and/or on
+// 127.0.0.1:port (port > 0). Every GET is answered with the output of collect. Returns NULL
+// with error set if a listener cannot be created.
+HbMetricsServer* hb_metrics_server_new(const gchar* socket_path,
+                                       guint port,
+                                       HbMetricsCollectFunc collect,
+                                       gpointer user_data,
+                                       GError** error);
+void hb_metrics_server_free(HbMetricsServer* server);
+
+// "# HELP" and "# TYPE" lines of a metric family.
+void hb_metrics_append_header(GString* out, const gchar* name, const gchar* type, const gchar* help);
+
+// One sample. labels is a NULL-terminated list of name, value pairs (or NULL); values are escaped.
+void hb_metrics_append_sample(GString* out, const gchar* name, const gchar* const* labels, gdouble value);
+
+// Start measuring main-loop latency: how late a periodic timer on the default main context
+// fires compared to when it was due. Idempotent.
+void hb_metrics_start_latency_probe(void);
+
+// Append the main-loop latency metrics (last and worst delay since the previous call).
+void hb_metrics_append_latency(GString* out);
+
+#endif // HB_METRICS_H
@@ -0,0 +1,197 @@
+#include "hb_perf.h"
+#include "hb_proc.h"
+#include <webkit/webkit.h>
+
+// Milliseconds between refreshes of a visible overlay
+#define HB_PERF_REFRESH_MS 500
+
+// Span the frame rate and frame-time histogram are computed over
+#define HB_PERF_SPAN_US (2 * G_USEC_PER_SEC)
+
+// Listing /proc isn't free: one reading of web-process memory is shared by every overlay for this long
+#define HB_PERF_RSS_MAX_AGE_US (2 * G_USEC_PER_SEC)
+
+static gboolean hb_perf_all = FALSE;
+static gboolean hb_perf_css_installed = FALSE;
+static gint64 hb_perf_rss_read_us = 0;
+static guint64 hb_perf_rss_kb = 0;
+static guint hb_perf_rss_procs = 0;
+
+// Resources loaded by the page, counted in a script world of its own so the page sees no new
+// globals. The observer keeps counting past the resource timing buffer (250 entries by default).
+static const char* hb_perf_resources_js =
+    "(function () {\n"
+    "  var s = globalThis.__hudboxPerf;\n"
+    "  if (!s) {\n"
+    "    s = globalThis.__hudboxPerf = { n: performance.getEntriesByType('resource').length };\n"
+    "    new PerformanceObserver(function (list) { s.n += list.getEntries().length; })\n"
+    "      .observe({ type: 'resource' });\n"
+    "  }\n"
+    "  return s.n;\n"
+    "})()";
+
+void hb_perf_set_overlay_all(gboolean enabled)
+{
+    hb_perf_all = enabled;
+}
+
+static void hb_perf_install_css(void)
+{
+    if (hb_perf_css_installed) return;
+    hb_perf_css_installed = TRUE;
+    const char* css =
+        ".hb-perf-overlay { background-color: rgba(0, 0, 0, 0.7); color: #e8e8e8; font-family: monospace;"
+        " font-size: 8pt; padding: 3px 6px; margin: 4px; border-radius: 4px; }\n";
+    GtkCssProvider* provider = gtk_css_provider_new();
+    gtk_css_provider_load_from_string(provider, css);
+    GdkDisplay* display = gdk_display_get_default();
+    if (display)
+    {
+        gtk_style_context_add_provider_for_display(
+            display,
+            GTK_STYLE_PROVIDER(provider),
+            GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    }
+    g_object_unref(provider);
+}
+
+static void hb_perf_read_rss(void)
+{
+    gint64 now = g_get_monotonic_time();
+    if (hb_perf_rss_read_us && now - hb_perf_rss_read_us < HB_PERF_RSS_MAX_AGE_US) return;
+    hb_perf_rss_read_us = now;
+
+    hb_perf_rss_kb = 0;
+    hb_perf_rss_procs = 0;
+    GPtrArray* procs = hb_proc_list_descendants();
+    for (guint i = 0; i < procs->len; i++)
+    {
+        HbProcInfo* info = g_ptr_array_index(procs, i);
+        // "WebKitWebProcess", truncated to 15 characters by the kernel
+        if (!g_str_has_prefix(info->name, "WebKitWebProc")) continue;
+        hb_perf_rss_kb += info->rss_kb;
+        hb_perf_rss_procs++;
+    }
+    g_ptr_array_free(procs, TRUE);
+}
+
+static void on_resources_counted(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    JSCValue* value = webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(source), result, NULL);
+    if (!value) return;
+    // The view may have been replaced or its window closed meanwhile
+    HbWindow* win = hb_window_from_widget(GTK_WIDGET(source));
+    if (win && win->perf_overlay && GTK_WIDGET(source) == win->web_view && jsc_value_is_number(value))
+    {
+        win->perf_resources = jsc_value_to_int32(value);
+    }
+    g_object_unref(value);
+}
+
+static gboolean on_perf_refresh(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    // Nobody sees the overlay of a hidden window
+    if (win->hidden || !gtk_widget_get_mapped(GTK_WIDGET(win->window))) return G_SOURCE_CONTINUE;
+
+    gint64 now = g_get_monotonic_time();
+    gdouble fps = hb_frame_stats_fps(win->frame_stats, now, HB_PERF_SPAN_US);
+    guint buckets[HB_FRAME_TIME_BUCKETS];
+    guint intervals = hb_frame_stats_histogram(win->frame_stats, now, HB_PERF_SPAN_US, buckets);
+    hb_perf_read_rss();
+
+    GString* text = g_string_new(NULL);
+    g_string_append_printf(text, "%.1f fps", fps);
+    if (win->cfg.max_fps > 0) g_string_append_printf(text, " (max_fps %u)", win->cfg.max_fps);
+    g_string_append(text, "\nframes");
+    for (guint b = 0; b < HB_FRAME_TIME_BUCKETS; b++)
+    {
+        guint percent = intervals ? (buckets[b] * 100 + intervals / 2) / intervals : 0;
+        if (b < HB_FRAME_TIME_BUCKETS - 1)
+        {
+            g_string_append_printf(text, " ≤%ums %u%%", hb_frame_time_bucket_ms[b], percent);
+        }
+        else
+        {
+            g_string_append_printf(text, " slower %u%%", percent);
+        }
+    }
+    if (win->last_load_us > 0)
+    {
+        g_string_append_printf(text, "\nload %.2f s", win->last_load_us / 1e6);
+    }
+    else
+    {
+        g_string_append(text, "\nload -");
+    }
+    if (win->perf_resources >= 0) g_string_append_printf(text, ", %d resources", win->perf_resources);
+    g_string_append_printf(text, "\nweb processes %.1f MiB (%u)", hb_perf_rss_kb / 1024.0, hb_perf_rss_procs);
+    gtk_label_set_text(GTK_LABEL(win->perf_label), text->str);
+    g_string_free(text, TRUE);
+
+    // Shown on the next refresh; a frozen page is suspended and wouldn't answer
+    if (!win->frozen)
+    {
+        webkit_web_view_evaluate_javascript(WEBKIT_WEB_VIEW(win->web_view), hb_perf_resources_js, -1,
+                                            "hudbox-perf", NULL, NULL, on_resources_counted, NULL);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// Put a GtkOverlay between the window and its content, with the statistics on top
+static void hb_perf_show(HbWindow* win)
+{
+    hb_perf_install_css();
+
+    GtkWidget* content = g_object_ref(win->frozen ? win->frozen : win->web_view);
+    gtk_window_set_child(win->window, NULL);
+    win->perf_overlay = gtk_overlay_new();
+    gtk_overlay_set_child(GTK_OVERLAY(win->perf_overlay), content);
+    g_object_unref(content);
+
+    win->perf_label = gtk_label_new(NULL);
+    gtk_widget_add_css_class(win->perf_label, "hb-perf-overlay");
+    gtk_widget_set_halign(win->perf_label, GTK_ALIGN_START);
+    gtk_widget_set_valign(win->perf_label, GTK_ALIGN_START);
+    // Input goes to the page (and the drag gesture) underneath
+    gtk_widget_set_can_target(win->perf_label, FALSE);
+    gtk_overlay_add_overlay(GTK_OVERLAY(win->perf_overlay), win->perf_label);
+    gtk_window_set_child(win->window, win->perf_overlay);
+
+    win->perf_resources = -1;
+    hb_window_watch_frames(win, TRUE);
+    win->perf_source = g_timeout_add(HB_PERF_REFRESH_MS, on_perf_refresh, win);
+}
+
+static void hb_perf_hide(HbWindow* win)
+{
+    hb_perf_clear(win);
+    GtkWidget* content = g_object_ref(gtk_overlay_get_child(GTK_OVERLAY(win->perf_overlay)));
+    gtk_overlay_set_child(GTK_OVERLAY(win->perf_overlay), NULL);
+    win->perf_overlay = NULL;
+    win->perf_label = NULL;
+    // Replacing the child destroys the overlay
+    gtk_window_set_child(win->window, content);
+    g_object_unref(content);
+    hb_window_watch_frames(win, FALSE);
+}
+
+void hb_perf_update(HbWindow* win)
+{
+    if (!win) return;
+    gboolean enabled = hb_perf_all || win->cfg.perf_overlay;
+    if (enabled && !win->perf_overlay)
+    {
+        hb_perf_show(win);
+    }
+    else if (!enabled && win->perf_overlay)
+    {
+        hb_perf_hide(win);
+    }
+}
+
+void hb_perf_clear(HbWindow* win)
+{
+    if (!win) return;
+    g_clear_handle_id(&win->perf_source, g_source_remove);
+}
@@ -0,0 +1,22 @@
+#ifndef HB_PERF_H
+#define HB_PERF_H
+
+#include "hb_window.h"
+
+// ---------------- Performance overlay ----------------
+//
+// A small panel drawn over the page: the window's effective frame rate and frame-time histogram
+// over the last two seconds, how long the last load took, how many resources the page loaded,
+// and the resident memory of the WebKit web processes. It's refreshed twice a second while the
+// window is visible. Windows without it have no overlay widget, timer or frame accounting.
+
+// Show the overlay in every window created after this call, whatever its cfg.perf_overlay.
+void hb_perf_set_overlay_all(gboolean enabled);
+
+// Add or remove the window's overlay according to cfg.perf_overlay.
+void hb_perf_update(HbWindow* win);
+
+// Stop refreshing the overlay.
+void hb_perf_clear(HbWindow* win);
+
+#endif // HB_PERF_H
@@ -0,0 +1,196 @@
+#include "hb_proc.h"
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+void hb_proc_info_free(HbProcInfo* info)
+{
+    if (!info) return;
+    g_free(info->name);
+    g_free(info);
+}
+
+gboolean hb_proc_parse_status(const gchar* text, HbProcInfo* info)
+{
+    if (!text || !info) return FALSE;
+
+    gboolean have_name = FALSE;
+    gboolean have_ppid = FALSE;
+    info->rss_kb = 0;
+
+    gchar** lines = g_strsplit(text, "\n", -1);
+    for (gchar** l = lines; *l; l++)
+    {
+        const gchar* line = *l;
+        if (g_str_has_prefix(line, "Name:"))
+        {
+            g_free(info->name);
+            info->name = g_strstrip(g_strdup(line + 5));
+            have_name = TRUE;
+        }
+        else if (g_str_has_prefix(line, "PPid:"))
+        {
+            info->ppid = (gint)g_ascii_strtoll(line + 5, NULL, 10);
+            have_ppid = TRUE;
+        }
+        else if (g_str_has_prefix(line, "VmRSS:"))
+        {
+            // Format: "VmRSS:\t   12345 kB"
+            info->rss_kb = g_ascii_strtoull(line + 6, NULL, 10);
+        }
+    }
+    g_strfreev(lines);
+
+    return have_name && have_ppid;
+}
+
+HbProcInfo* hb_proc_read(gint pid)
+{
+    gchar* path = g_strdup_printf("/proc/%d/status", pid);
+    gchar* contents = NULL;
+    gboolean ok = g_file_get_contents(path, &contents, NULL, NULL);
+    g_free(path);
+    if (!ok) return NULL;
+
+    HbProcInfo* info = g_new0(HbProcInfo, 1);
+    info->pid = pid;
+    if (!hb_proc_parse_status(contents, info))
+    {
+        hb_proc_info_free(info);
+        info = NULL;
+    }
+    g_free(contents);
+    return info;
+}
+
+gboolean hb_proc_parse_stat(const gchar* text, guint64* cpu_ticks)
+{
+    if (!text || !cpu_ticks) return FALSE;
+
+    // "pid (comm) state ppid ...": comm may contain spaces and parentheses, so fields are
+    // counted from the last ')'. utime and stime are fields 14 and 15.
+    const gchar* rparen = strrchr(text, ')');
+    if (!rparen) return FALSE;
+    gchar** fields = g_strsplit_set(rparen + 1, " \n", -1);
+    guint n = 0;
+    guint64 utime = 0, stime = 0;
+    gboolean ok = FALSE;
+    for (gchar** f = fields; *f; f++)
+    {
+        if (!**f) continue;
+        n++; // field 3 (state) is the first one after comm
+        if (n == 12) utime = g_ascii_strtoull(*f, NULL, 10);
+        if (n == 13)
+        {
+            stime = g_ascii_strtoull(*f, NULL, 10);
+            ok = TRUE;
+            break;
+        }
+    }
+    g_strfreev(fields);
+
+    if (ok) *cpu_ticks = utime + stime;
+    return ok;
+}
+
+gboolean hb_proc_read_cpu(HbProcInfo* info)
+{
+    if (!info) return FALSE;
+    gchar* path = g_strdup_printf("/proc/%d/stat", info->pid);
+    gchar* contents = NULL;
+    gboolean ok = g_file_get_contents(path, &contents, NULL, NULL);
+    g_free(path);
+
+    guint64 ticks = 0;
+    ok = ok && hb_proc_parse_stat(contents, &ticks);
+    g_free(contents);
+    if (ok) info->cpu_seconds = (gdouble)ticks / (gdouble)sysconf(_SC_CLK_TCK);
+    return ok;
+}
+
+GPtrArray* hb_proc_list_descendants(void)
+{
+    GPtrArray* result = g_ptr_array_new_with_free_func((GDestroyNotify)hb_proc_info_free);
+
+    GDir* dir = g_dir_open("/proc", 0, NULL);
+    if (!dir) return result;
+
+    // Snapshot every process once, then walk parent links from our own pid
+    GPtrArray* all = g_ptr_array_new_with_free_func((GDestroyNotify)hb_proc_info_free);
+    const gchar* entry;
+    while ((entry = g_dir_read_name(dir)) != NULL)
+    {
+        if (!g_ascii_isdigit(entry[0])) continue;
+        HbProcInfo* info = hb_proc_read((gint)g_ascii_strtoll(entry, NULL, 10));
+        if (info) g_ptr_array_add(all, info);
+    }
+    g_dir_close(dir);
+
+    GHashTable* family = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_add(family, GINT_TO_POINTER(getpid()));
+
+    gboolean grew = TRUE;
+    while (grew)
+    {
+        grew = FALSE;
+        for (guint i = 0; i < all->len; i++)
+        {
+            HbProcInfo* info = g_ptr_array_index(all, i);
+            if (!info) continue;
+            if (g_hash_table_contains(family, GINT_TO_POINTER(info->ppid)))
+            {
+                g_hash_table_add(family, GINT_TO_POINTER(info->pid));
+                // move ownership into the result and leave a hole behind
+                g_ptr_array_add(result, info);
+                all->pdata[i] = NULL;
+                grew = TRUE;
+            }
+        }
+    }
+
+    g_hash_table_unref(family);
+    g_ptr_array_free(all, TRUE);
+    return result;
+}
+
+void hb_proc_log_memory_report(void)
+{
+    GPtrArray* procs = hb_proc_list_descendants();
+    HbProcInfo* self = hb_proc_read(getpid());
+
+    guint64 total_kb = self ? self->rss_kb : 0;
+    if (self)
+    {
+        g_message("memory: pid %d %-16s rss=%" G_GUINT64_FORMAT " kB (ui)", self->pid, self->name, self->rss_kb);
+    }
+    for (guint i = 0; i < procs->len; i++)
+    {
+        HbProcInfo* info = g_ptr_array_index(procs, i);
+        g_message("memory: pid %d %-16s rss=%" G_GUINT64_FORMAT " kB", info->pid, info->name, info->rss_kb);
+        total_kb += info->rss_kb;
+    }
+    g_message("memory: %u child processes, total rss=%" G_GUINT64_FORMAT " kB", procs->len, total_kb);
+
+    hb_proc_info_free(self);
+    g_ptr_array_free(procs, TRUE);
+}
+
+static guint hb_memory_report_source = 0;
+
+static gboolean on_memory_report_tick(gpointer user_data)
+{
+    hb_proc_log_memory_report();
+    return G_SOURCE_CONTINUE;
+}
+
+void hb_proc_start_memory_report(guint interval_seconds)
+{
+    if (hb_memory_report_source)
+    {
+        g_source_remove(hb_memory_report_source);
+        hb_memory_report_source = 0;
+    }
+    if (interval_seconds == 0) return;
+    hb_memory_report_source = g_timeout_add_seconds(interval_seconds, on_memory_report_tick, NULL);
+}
@@ -0,0 +1,43 @@
+#ifndef HB_PROC_H
+#define HB_PROC_H
+
+#include <glib.h>
+
+// ---------------- Process inspection (/proc) ----------------
+
+typedef struct
+{
+    gint pid;
+    gint ppid;
+    gchar* name;
+    guint64 rss_kb; // resident set size in KiB
+    gdouble cpu_seconds; // user + system CPU time; only filled by hb_proc_read_cpu()
+} HbProcInfo;
+
+void hb_proc_info_free(HbProcInfo* info);
+
+// Parse the contents of a /proc/<pid>/status file into info (name, ppid, rss). Returns FALSE if
+// the mandatory Name/PPid fields are missing. info->pid is left untouched.
+gboolean hb_proc_parse_status(const gchar* text, HbProcInfo* info);
+
+// Read /proc/<pid>/status. Returns NULL if the process is gone or unreadable.
+HbProcInfo* hb_proc_read(gint pid);
+
+// Parse the contents of a /proc/<pid>/stat file: user + system CPU time in clock ticks.
+// Returns FALSE if the line is malformed.
+gboolean hb_proc_parse_stat(const gchar* text, guint64* cpu_ticks);
+
+// Fill info->cpu_seconds from /proc/<pid>/stat. Returns FALSE if the process is gone.
+gboolean hb_proc_read_cpu(HbProcInfo* info);
+
+// List all descendants of the current process (WebKit web/network processes, possibly behind a
+// bubblewrap sandbox). Returns a GPtrArray* of HbProcInfo* owning its elements.
+GPtrArray* hb_proc_list_descendants(void);
+
+// Log one line per descendant process with its RSS, plus totals (g_message).
+void hb_proc_log_memory_report(void);
+
+// Log a memory report every interval_seconds from the main loop. 0 stops reporting.
+void hb_proc_start_memory_report(guint interval_seconds);
+
+#endif // HB_PROC_H
@@ -0,0 +1,171 @@
+#include "hb_push.h"
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <glib/gstdio.h>
+#include <json-glib/json-glib.h>
+#include <sys/stat.h>
+
+struct HbPushServer
+{
+    gchar* path;
+    GSocketService* service;
+    GCancellable* cancellable; // cancels reads of every open connection
+    HbPushFunc func;
+    gpointer user_data;
+};
+
+typedef struct
+{
+    HbPushServer* server;      // only valid while cancellable isn't cancelled
+    GCancellable* cancellable; // the server's
+    GSocketConnection* connection;
+    GDataInputStream* input;
+} HbPushConnection;
+
+gboolean hb_push_parse_line(const gchar* line, gchar** window, gchar** payload, GError** error)
+{
+    JsonParser* parser = json_parser_new();
+    if (!json_parser_load_from_data(parser, line, -1, error))
+    {
+        g_object_unref(parser);
+        return FALSE;
+    }
+
+    JsonNode* root = json_parser_get_root(parser);
+    if (!root || !JSON_NODE_HOLDS_OBJECT(root))
+    {
+        g_set_error(error, JSON_PARSER_ERROR, JSON_PARSER_ERROR_INVALID_DATA, "message is not a JSON object");
+        g_object_unref(parser);
+        return FALSE;
+    }
+
+    JsonObject* obj = json_node_get_object(root);
+    JsonNode* target = json_object_get_member(obj, "window");
+    if (target && !JSON_NODE_HOLDS_NULL(target) &&
+        (!JSON_NODE_HOLDS_VALUE(target) || json_node_get_value_type(target) != G_TYPE_STRING))
+    {
+        g_set_error(error, JSON_PARSER_ERROR, JSON_PARSER_ERROR_INVALID_DATA, "\"window\" must be a string");
+        g_object_unref(parser);
+        return FALSE;
+    }
+
+    JsonNode* data = json_object_get_member(obj, "data");
+    *window = target && !JSON_NODE_HOLDS_NULL(target) ? g_strdup(json_node_get_string(target)) : NULL;
+    *payload = json_to_string(data ? data : root, FALSE);
+    g_object_unref(parser);
+    return TRUE;
+}
+
+static void hb_push_connection_free(HbPushConnection* conn)
+{
+    g_io_stream_close(G_IO_STREAM(conn->connection), NULL, NULL);
+    g_object_unref(conn->input);
+    g_object_unref(conn->connection);
+    g_object_unref(conn->cancellable);
+    g_free(conn);
+}
+
+static void on_line_read(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbPushConnection* conn = user_data;
+    GError* error = NULL;
+    gchar* line = g_data_input_stream_read_line_finish_utf8(G_DATA_INPUT_STREAM(source), result, NULL, &error);
+    if (!line || g_cancellable_is_cancelled(conn->cancellable))
+    {
+        // EOF, or the server is shutting down (conn->server is gone then)
+        if (error && !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        {
+            g_warning("push: connection error: %s", error->message);
+        }
+        g_clear_error(&error);
+        g_free(line);
+        hb_push_connection_free(conn);
+        return;
+    }
+
+    HbPushServer* server = conn->server;
+    g_strstrip(line);
+    if (*line)
+    {
+        gchar* window = NULL;
+        gchar* payload = NULL;
+        if (hb_push_parse_line(line, &window, &payload, &error))
+        {
+            server->func(window, payload, server->user_data);
+            g_free(window);
+            g_free(payload);
+        }
+        else
+        {
+            g_warning("push: ignoring malformed message: %s", error->message);
+            g_clear_error(&error);
+        }
+    }
+    g_free(line);
+
+    g_data_input_stream_read_line_async(conn->input, G_PRIORITY_DEFAULT, conn->cancellable, on_line_read, conn);
+}
+
+static gboolean on_incoming(GSocketService* service,
+                            GSocketConnection* connection,
+                            GObject* source_object,
+                            gpointer user_data)
+{
+    HbPushServer* server = user_data;
+    HbPushConnection* conn = g_new0(HbPushConnection, 1);
+    conn->server = server;
+    conn->cancellable = g_object_ref(server->cancellable);
+    conn->connection = g_object_ref(connection);
+    conn->input = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+    g_data_input_stream_set_newline_type(conn->input, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+    g_data_input_stream_read_line_async(conn->input, G_PRIORITY_DEFAULT, server->cancellable, on_line_read, conn);
+    return TRUE;
+}
+
+HbPushServer* hb_push_server_new(const gchar* path, HbPushFunc func, gpointer user_data, GError** error)
+{
+    g_return_val_if_fail(path != NULL && func != NULL, NULL);
+
+    // A socket left behind by a previous instance would make bind() fail
+    GStatBuf st;
+    if (g_lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) g_unlink(path);
+
+    GSocketService* service = g_socket_service_new();
+    GSocketAddress* address = g_unix_socket_address_new(path);
+    gboolean ok = g_socket_listener_add_address(G_SOCKET_LISTENER(service), address,
+                                                G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT,
+                                                NULL, NULL, error);
+    g_object_unref(address);
+    if (!ok)
+    {
+        g_object_unref(service);
+        return NULL;
+    }
+    // Anyone who can connect can drive the pages
+    g_chmod(path, 0600);
+
+    HbPushServer* server = g_new0(HbPushServer, 1);
+    server->path = g_strdup(path);
+    server->service = service;
+    server->cancellable = g_cancellable_new();
+    server->func = func;
+    server->user_data = user_data;
+    g_signal_connect(service, "incoming", G_CALLBACK(on_incoming), server);
+    g_socket_service_start(service);
+    return server;
+}
+
+void hb_push_server_free(HbPushServer* server)
+{
+    if (!server) return;
+    g_signal_handlers_disconnect_by_data(server->service, server);
+    g_socket_service_stop(server->service);
+    g_socket_listener_close(G_SOCKET_LISTENER(server->service));
+    g_object_unref(server->service);
+    // Pending reads complete with G_IO_ERROR_CANCELLED and free their connections
+    g_cancellable_cancel(server->cancellable);
+    g_object_unref(server->cancellable);
+    g_unlink(server->path);
+    g_free(server->path);
+    g_free(server);
+}
@@ -0,0 +1,26 @@
+#ifndef HB_PUSH_H
+#define HB_PUSH_H
+
+#include <glib.h>
+
+// ---------------- Push-data socket ----------------
+
+// Called on the main context for every message received. window is the target window title, or
+// NULL for all windows; payload is the message's data serialized as compact JSON.
+typedef void (*HbPushFunc)(const gchar* window, const gchar* payload, gpointer user_data);
+
+typedef struct HbPushServer HbPushServer;
+
+// Listen on a Unix-domain stream socket at path (replacing a stale socket file, mode 0600) for
+// newline-delimited JSON messages: { "window": "Status Bar", "data": ... }. "window" is optional;
+// without "data" the whole object is the payload. Malformed lines are logged and skipped.
+// Returns NULL with error set if the socket cannot be created.
+HbPushServer* hb_push_server_new(const gchar* path, HbPushFunc func, gpointer user_data, GError** error);
+
+// Stop listening, drop open connections and remove the socket file.
+void hb_push_server_free(HbPushServer* server);
+
+// Parse one message line. On success *window (may be NULL) and *payload are set; free with g_free().
+gboolean hb_push_parse_line(const gchar* line, gchar** window, gchar** payload, GError** error);
+
+#endif // HB_PUSH_H
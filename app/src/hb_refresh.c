@@ -0,0 +1,178 @@
+#include "hb_refresh.h"
+#include "hb_trace.h"
+#include <libsoup/soup.h>
+#include <webkit/webkit.h>
+
+// One tick per second; 64 slots keep typical intervals (up to a minute) within one turn
+#define HB_REFRESH_WHEEL_SLOTS 64
+#define HB_REFRESH_JITTER_PERCENT 10
+
+static HbWheel* hb_refresh_wheel = NULL;
+static guint hb_refresh_source = 0;
+static SoupSession* hb_refresh_session = NULL; // conditional HEAD checks
+
+// A conditional request in flight. win is only valid while cancellable isn't cancelled.
+typedef struct
+{
+    HbWindow* win;
+    GCancellable* cancellable; // ref of win->refresh_check
+} HbRefreshCheck;
+
+static void hb_refresh_check(HbWindow* win);
+
+static gboolean on_refresh_tick(gpointer user_data)
+{
+    hb_wheel_advance(hb_refresh_wheel);
+    if (hb_wheel_get_count(hb_refresh_wheel) > 0) return G_SOURCE_CONTINUE;
+    // Nothing left to refresh: stop waking up
+    hb_refresh_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void on_refresh_due(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    win->refresh_timer = NULL;
+    hb_refresh_schedule(win);
+    hb_refresh_check(win);
+}
+
+void hb_refresh_schedule(HbWindow* win)
+{
+    if (!win) return;
+    if (win->refresh_timer)
+    {
+        hb_wheel_remove(hb_refresh_wheel, win->refresh_timer);
+        win->refresh_timer = NULL;
+    }
+    if (win->cfg.refresh_interval == 0) return;
+
+    if (!hb_refresh_wheel) hb_refresh_wheel = hb_wheel_new(HB_REFRESH_WHEEL_SLOTS);
+    guint64 ticks = hb_wheel_jitter(win->cfg.refresh_interval, HB_REFRESH_JITTER_PERCENT);
+    win->refresh_timer = hb_wheel_add(hb_refresh_wheel, ticks, on_refresh_due, win);
+    if (!hb_refresh_source)
+    {
+        hb_refresh_source = g_timeout_add_seconds(1, on_refresh_tick, NULL);
+    }
+}
+
+static void hb_refresh_reload(HbWindow* win, const gchar* reason)
+{
+    hb_trace_instant(win->trace_track, reason);
+    webkit_web_view_reload(WEBKIT_WEB_VIEW(win->web_view));
+}
+
+static void on_refresh_checked(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    SoupSession* session = SOUP_SESSION(source);
+    HbRefreshCheck* check = user_data;
+    GError* error = NULL;
+    GInputStream* body = soup_session_send_finish(session, result, &error);
+    gboolean cancelled = g_cancellable_is_cancelled(check->cancellable);
+    HbWindow* win = check->win;
+    g_object_unref(check->cancellable);
+    g_free(check);
+    if (cancelled)
+    {
+        // The window went away or started another check
+        g_clear_error(&error);
+        g_clear_object(&body);
+        return;
+    }
+
+    g_clear_object(&win->refresh_check);
+    if (!body)
+    {
+        // Can't tell (offline, DNS, ...): let the page itself deal with it
+        g_error_free(error);
+        hb_refresh_reload(win, "refresh_check_failed");
+        return;
+    }
+    g_object_unref(body);
+
+    SoupMessage* msg = soup_session_get_async_result_message(session, result);
+    guint status = soup_message_get_status(msg);
+    SoupMessageHeaders* headers = soup_message_get_response_headers(msg);
+    const gchar* etag = soup_message_headers_get_one(headers, "ETag");
+    const gchar* last_modified = soup_message_headers_get_one(headers, "Last-Modified");
+
+    // Servers that ignore conditional headers still return the same validators
+    gboolean unchanged = status == SOUP_STATUS_NOT_MODIFIED ||
+        (SOUP_STATUS_IS_SUCCESSFUL(status) &&
+         (win->refresh_etag ? g_strcmp0(etag, win->refresh_etag) == 0
+                            : g_strcmp0(last_modified, win->refresh_last_modified) == 0));
+    if (unchanged)
+    {
+        hb_trace_instant(win->trace_track, "refresh_unchanged");
+        return;
+    }
+    hb_refresh_reload(win, "refresh_changed");
+}
+
+static void hb_refresh_check(HbWindow* win)
+{
+    if (!win->web_view) return;
+    const gchar* uri = webkit_web_view_get_uri(WEBKIT_WEB_VIEW(win->web_view));
+
+    // Without validators (or for non-HTTP pages) there is nothing to compare against
+    SoupMessage* msg = NULL;
+    if (uri && (win->refresh_etag || win->refresh_last_modified) &&
+        (g_str_has_prefix(uri, "http://") || g_str_has_prefix(uri, "https://")))
+    {
+        msg = soup_message_new(SOUP_METHOD_HEAD, uri);
+    }
+    if (!msg)
+    {
+        hb_refresh_reload(win, "refresh");
+        return;
+    }
+
+    SoupMessageHeaders* headers = soup_message_get_request_headers(msg);
+    if (win->refresh_etag) soup_message_headers_replace(headers, "If-None-Match", win->refresh_etag);
+    if (win->refresh_last_modified)
+    {
+        soup_message_headers_replace(headers, "If-Modified-Since", win->refresh_last_modified);
+    }
+
+    if (!hb_refresh_session) hb_refresh_session = soup_session_new();
+    if (win->refresh_check) g_cancellable_cancel(win->refresh_check);
+    g_clear_object(&win->refresh_check);
+    win->refresh_check = g_cancellable_new();
+    HbRefreshCheck* check = g_new0(HbRefreshCheck, 1);
+    check->win = win;
+    check->cancellable = g_object_ref(win->refresh_check);
+    soup_session_send_async(hb_refresh_session, msg, G_PRIORITY_LOW, check->cancellable, on_refresh_checked, check);
+    g_object_unref(msg);
+}
+
+void hb_refresh_note_load(HbWindow* win)
+{
+    if (!win || !win->web_view) return;
+    g_clear_pointer(&win->refresh_etag, g_free);
+    g_clear_pointer(&win->refresh_last_modified, g_free);
+
+    WebKitWebResource* resource = webkit_web_view_get_main_resource(WEBKIT_WEB_VIEW(win->web_view));
+    WebKitURIResponse* response = resource ? webkit_web_resource_get_response(resource) : NULL;
+    SoupMessageHeaders* headers = response ? webkit_uri_response_get_http_headers(response) : NULL;
+    if (!headers || !SOUP_STATUS_IS_SUCCESSFUL(webkit_uri_response_get_status_code(response))) return;
+
+    win->refresh_etag = g_strdup(soup_message_headers_get_one(headers, "ETag"));
+    win->refresh_last_modified = g_strdup(soup_message_headers_get_one(headers, "Last-Modified"));
+}
+
+void hb_refresh_clear(HbWindow* win)
+{
+    if (!win) return;
+    if (win->refresh_timer)
+    {
+        hb_wheel_remove(hb_refresh_wheel, win->refresh_timer);
+        win->refresh_timer = NULL;
+    }
+    if (win->refresh_check)
+    {
+        g_cancellable_cancel(win->refresh_check);
+        g_clear_object(&win->refresh_check);
+    }
+    g_clear_pointer(&win->refresh_etag, g_free);
+    g_clear_pointer(&win->refresh_last_modified, g_free);
+}
@@ -0,0 +1,21 @@
+#ifndef HB_REFRESH_H
+#define HB_REFRESH_H
+
+#include "hb_window.h"
+
+// ---------------- Periodic refresh ----------------
+
+// (Re)arm the window's refresh according to cfg.refresh_interval, replacing a pending one. All
+// windows share one timer wheel ticking once per second, and each interval is jittered so that
+// windows with the same interval spread out. When a refresh is due and the last load returned
+// an ETag or Last-Modified validator, a conditional HEAD request decides whether the page
+// changed; unchanged pages are not reloaded.
+void hb_refresh_schedule(HbWindow* win);
+
+// Remember the validators of the page that just finished loading.
+void hb_refresh_note_load(HbWindow* win);
+
+// Cancel the pending refresh and any check in flight, and forget the validators.
+void hb_refresh_clear(HbWindow* win);
+
+#endif // HB_REFRESH_H
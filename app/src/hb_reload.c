@@ -0,0 +1,167 @@
+#include "hb_reload.h"
+#include "hb_config.h"
+#include "hb_window.h"
+#include "hb_startup.h"
+#include "hb_web.h"
+
+// Editors save in several steps (truncate + write, or write temp + rename); wait for quiet
+#define HB_RELOAD_DEBOUNCE_MS 250
+
+typedef struct
+{
+    GtkApplication* app; // not owned; the watch is stored on the app
+    gchar* path;
+    GFileMonitor* monitor;
+    guint debounce_source;
+} HbReloadWatch;
+
+static void hb_reload_watch_free(gpointer data)
+{
+    HbReloadWatch* watch = data;
+    if (!watch) return;
+    g_clear_handle_id(&watch->debounce_source, g_source_remove);
+    if (watch->monitor)
+    {
+        g_file_monitor_cancel(watch->monitor);
+        g_object_unref(watch->monitor);
+    }
+    g_free(watch->path);
+    g_free(watch);
+}
+
+void hb_reload_apply(GtkApplication* app, const gchar* path)
+{
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    GError* error = NULL;
+    HbConfigSet* set = hb_load_configs_from_json_full(path, &app_cfg, &error);
+    if (!set)
+    {
+        // Most likely caught mid-write or temporarily invalid: keep what is running
+        g_warning("Config %s could not be loaded (%s); keeping current windows", path, error->message);
+        g_error_free(error);
+        hb_app_cfg_clear(&app_cfg);
+        return;
+    }
+    // Same as at startup: what was skipped or defaulted, on every edit
+    hb_config_set_log_errors(set, path);
+
+    // Only affects views created from now on; storage settings need a restart
+    hb_web_init(&app_cfg);
+    hb_app_cfg_clear(&app_cfg);
+
+    // Windows of a startup still in progress are matched like any other; new windows load in turn
+    hb_startup_flush(app);
+
+    // Running windows by title; duplicate titles are matched in order of appearance
+    // (keys are copies: applying a config replaces the window's own title string)
+    GHashTable* by_title = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_queue_free);
+    GList* windows = g_list_reverse(g_list_copy(gtk_application_get_windows(app)));
+    for (GList* l = windows; l; l = l->next)
+    {
+        HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+        if (!win) continue;
+        GQueue* q = g_hash_table_lookup(by_title, win->cfg.title);
+        if (!q)
+        {
+            q = g_queue_new();
+            g_hash_table_insert(by_title, g_strdup(win->cfg.title), q);
+        }
+        g_queue_push_tail(q, win);
+    }
+    g_list_free(windows);
+
+    guint updated = 0, created = 0, closed = 0;
+    for (guint i = 0; i < set->n_windows; i++)
+    {
+        const HbWindowCfg* cfg = &set->windows[i];
+        GQueue* q = g_hash_table_lookup(by_title, cfg->title);
+        HbWindow* win = q ? g_queue_pop_head(q) : NULL;
+        if (win)
+        {
+            if (hb_window_cfg_diff(&win->cfg, cfg) != HB_CFG_CHANGE_NONE) updated++;
+            hb_window_apply_cfg(win, cfg);
+        }
+        else
+        {
+            hb_startup_create_window(app, cfg);
+            created++;
+        }
+    }
+
+    // Close leftovers last, so the application never runs out of windows mid-reload
+    GHashTableIter it;
+    gpointer value;
+    g_hash_table_iter_init(&it, by_title);
+    while (g_hash_table_iter_next(&it, NULL, &value))
+    {
+        HbWindow* win;
+        while ((win = g_queue_pop_head(value)) != NULL)
+        {
+            gtk_window_destroy(win->window);
+            closed++;
+        }
+    }
+
+    g_message("Reloaded %s: %u updated, %u created, %u closed", path, updated, created, closed);
+
+    g_hash_table_unref(by_title);
+    hb_config_set_free(set);
+}
+
+static gboolean on_reload_debounced(gpointer user_data)
+{
+    HbReloadWatch* watch = user_data;
+    watch->debounce_source = 0;
+    hb_reload_apply(watch->app, watch->path);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_config_changed(GFileMonitor* monitor,
+                              GFile* file,
+                              GFile* other_file,
+                              GFileMonitorEvent event_type,
+                              gpointer user_data)
+{
+    HbReloadWatch* watch = user_data;
+    switch (event_type)
+    {
+    case G_FILE_MONITOR_EVENT_CHANGED:
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+    case G_FILE_MONITOR_EVENT_RENAMED:
+        g_clear_handle_id(&watch->debounce_source, g_source_remove);
+        watch->debounce_source = g_timeout_add(HB_RELOAD_DEBOUNCE_MS, on_reload_debounced, watch);
+        break;
+    default:
+        break;
+    }
+}
+
+void hb_reload_watch(GtkApplication* app, const gchar* path)
+{
+    if (!app || !path) return;
+
+    GFile* file = g_file_new_for_path(path);
+    GError* error = NULL;
+    GFileMonitor* monitor = g_file_monitor_file(file, G_FILE_MONITOR_WATCH_MOVES, NULL, &error);
+    g_object_unref(file);
+    if (!monitor)
+    {
+        if (error)
+        {
+            g_warning("Cannot watch %s for changes: %s", path, error->message);
+            g_error_free(error);
+        }
+        return;
+    }
+
+    HbReloadWatch* watch = g_new0(HbReloadWatch, 1);
+    watch->app = app;
+    watch->path = g_strdup(path);
+    watch->monitor = monitor;
+    g_signal_connect(monitor, "changed", G_CALLBACK(on_config_changed), watch);
+
+    g_object_set_data_full(G_OBJECT(app), "hb-config-watch", watch, hb_reload_watch_free);
+}
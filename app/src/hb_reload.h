@@ -0,0 +1,17 @@
+#ifndef HB_RELOAD_H
+#define HB_RELOAD_H
+
+#include <gtk/gtk.h>
+
+// ---------------- Config hot-reload ----------------
+
+// Watch the config file at path. When it changes, it is re-parsed and the running windows are
+// reconciled with it by title: changed windows are updated in place (see hb_window_apply_cfg()),
+// new entries get windows and windows whose entries were removed are closed. Unchanged windows
+// keep their pages. Replaces any previous watch on app.
+void hb_reload_watch(GtkApplication* app, const gchar* path);
+
+// Re-read path and reconcile immediately (what the watch does after a change).
+void hb_reload_apply(GtkApplication* app, const gchar* path);
+
+#endif // HB_RELOAD_H
@@ -0,0 +1,216 @@
+#include "hb_remote.h"
+#include "hb_window.h"
+#include "hb_reload.h"
+#include <webkit/webkit.h>
+
+static guint hb_remote_windows_idle = 0;
+
+typedef void (*HbRemoteWindowFunc)(HbWindow* win, gpointer data);
+
+// Apply func to every window titled title; returns how many there were
+static guint hb_remote_for_windows(GtkApplication* app, const gchar* title, HbRemoteWindowFunc func, gpointer data)
+{
+    // Copy: closing a window removes it from the application's list
+    GList* windows = g_list_copy(gtk_application_get_windows(app));
+    guint n = 0;
+    for (GList* l = windows; l; l = l->next)
+    {
+        HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+        if (!win || g_strcmp0(win->cfg.title, title) != 0) continue;
+        func(win, data);
+        n++;
+    }
+    g_list_free(windows);
+    return n;
+}
+
+static void hb_remote_close(HbWindow* win, gpointer data)
+{
+    gtk_window_destroy(win->window);
+}
+
+static void hb_remote_reload(HbWindow* win, gpointer data)
+{
+    webkit_web_view_reload(WEBKIT_WEB_VIEW(win->web_view));
+}
+
+static void hb_remote_navigate(HbWindow* win, gpointer data)
+{
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->web_view), data);
+}
+
+static void hb_remote_open_config(GtkApplication* app, const gchar* path)
+{
+    g_object_set_data_full(G_OBJECT(app), "hb-config-path", g_strdup(path), g_free);
+    hb_reload_apply(app, path);
+    hb_reload_watch(app, path);
+}
+
+// Newest windows come first in the application's list
+static GVariant* hb_remote_window_titles(GtkApplication* app)
+{
+    GVariantBuilder titles;
+    g_variant_builder_init(&titles, G_VARIANT_TYPE_STRING_ARRAY);
+    for (GList* l = g_list_last(gtk_application_get_windows(app)); l; l = l->prev)
+    {
+        HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+        if (win) g_variant_builder_add(&titles, "s", win->cfg.title);
+    }
+    return g_variant_builder_end(&titles);
+}
+
+static gboolean on_update_windows_state(gpointer user_data)
+{
+    GtkApplication* app = GTK_APPLICATION(user_data);
+    hb_remote_windows_idle = 0;
+    GAction* action = g_action_map_lookup_action(G_ACTION_MAP(app), "windows");
+    if (action) g_simple_action_set_state(G_SIMPLE_ACTION(action), hb_remote_window_titles(app));
+    return G_SOURCE_REMOVE;
+}
+
+// Windows are added before hb_create_window() attaches their HbWindow: update once it's done
+static void on_windows_changed(GtkApplication* app, GtkWindow* window, gpointer user_data)
+{
+    if (hb_remote_windows_idle) return;
+    hb_remote_windows_idle = g_idle_add(on_update_windows_state, app);
+}
+
+static void on_open_config(GSimpleAction* action, GVariant* parameter, gpointer user_data)
+{
+    hb_remote_open_config(GTK_APPLICATION(user_data), g_variant_get_string(parameter, NULL));
+}
+
+static void on_reload_config(GSimpleAction* action, GVariant* parameter, gpointer user_data)
+{
+    const gchar* path = g_object_get_data(G_OBJECT(user_data), "hb-config-path");
+    if (path) hb_reload_apply(GTK_APPLICATION(user_data), path);
+}
+
+static void on_close_window(GSimpleAction* action, GVariant* parameter, gpointer user_data)
+{
+    const gchar* title = g_variant_get_string(parameter, NULL);
+    if (hb_remote_for_windows(GTK_APPLICATION(user_data), title, hb_remote_close, NULL) == 0)
+    {
+        g_warning("close-window: no window titled '%s'", title);
+    }
+}
+
+static void on_reload_window(GSimpleAction* action, GVariant* parameter, gpointer user_data)
+{
+    const gchar* title = g_variant_get_string(parameter, NULL);
+    if (hb_remote_for_windows(GTK_APPLICATION(user_data), title, hb_remote_reload, NULL) == 0)
+    {
+        g_warning("reload-window: no window titled '%s'", title);
+    }
+}
+
+static void on_navigate_window(GSimpleAction* action, GVariant* parameter, gpointer user_data)
+{
+    const gchar* title;
+    const gchar* uri;
+    g_variant_get(parameter, "(&s&s)", &title, &uri);
+    if (hb_remote_for_windows(GTK_APPLICATION(user_data), title, hb_remote_navigate, (gpointer)uri) == 0)
+    {
+        g_warning("navigate-window: no window titled '%s'", title);
+    }
+}
+
+void hb_remote_install(GtkApplication* app)
+{
+    if (!app || g_action_map_lookup_action(G_ACTION_MAP(app), "windows")) return;
+
+    static const GActionEntry entries[] = {
+        {"open-config", on_open_config, "s", NULL, NULL},
+        {"reload-config", on_reload_config, NULL, NULL, NULL},
+        {"close-window", on_close_window, "s", NULL, NULL},
+        {"reload-window", on_reload_window, "s", NULL, NULL},
+        {"navigate-window", on_navigate_window, "(ss)", NULL, NULL},
+    };
+    g_action_map_add_action_entries(G_ACTION_MAP(app), entries, G_N_ELEMENTS(entries), app);
+
+    // Read-only: without a "change-state" handler, requests to change it are ignored
+    GSimpleAction* windows = g_simple_action_new_stateful("windows", NULL, hb_remote_window_titles(app));
+    g_simple_action_set_enabled(windows, FALSE);
+    g_action_map_add_action(G_ACTION_MAP(app), G_ACTION(windows));
+    g_object_unref(windows);
+
+    g_signal_connect(app, "window-added", G_CALLBACK(on_windows_changed), NULL);
+    g_signal_connect(app, "window-removed", G_CALLBACK(on_windows_changed), NULL);
+}
+
+static int hb_remote_usage(GApplicationCommandLine* cmdline)
+{
+    g_application_command_line_printerr(cmdline,
+                                        "Usage: hudbox --remote COMMAND [ARGS]\n\n"
+                                        "Commands:\n"
+                                        "  list                   Print id, title and URI of every window.\n"
+                                        "  open CONFIG            Switch to CONFIG (windows are matched by title).\n"
+                                        "  reload                 Re-read the current config file.\n"
+                                        "  reload-window TITLE    Reload the page of the window(s) titled TITLE.\n"
+                                        "  close TITLE            Close the window(s) titled TITLE.\n"
+                                        "  navigate TITLE URI     Load URI in the window(s) titled TITLE.\n");
+    return 2;
+}
+
+static int hb_remote_windows_done(GApplicationCommandLine* cmdline, const gchar* title, guint n)
+{
+    if (n > 0) return 0;
+    g_application_command_line_printerr(cmdline, "No window titled '%s'\n", title);
+    return 1;
+}
+
+int hb_remote_run(GtkApplication* app, GApplicationCommandLine* cmdline, gchar** args)
+{
+    guint n_args = args ? g_strv_length(args) : 0;
+    if (n_args == 0) return hb_remote_usage(cmdline);
+    const gchar* cmd = args[0];
+
+    if (g_strcmp0(cmd, "list") == 0 && n_args == 1)
+    {
+        for (GList* l = g_list_last(gtk_application_get_windows(app)); l; l = l->prev)
+        {
+            HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+            if (!win) continue;
+            const gchar* uri = webkit_web_view_get_uri(WEBKIT_WEB_VIEW(win->web_view));
+            g_application_command_line_print(cmdline, "%u\t%s\t%s\n", win->id, win->cfg.title, uri ? uri : "");
+        }
+        return 0;
+    }
+    if (g_strcmp0(cmd, "open") == 0 && n_args == 2)
+    {
+        // Relative to the directory hudbox --remote was run from
+        GFile* file = g_application_command_line_create_file_for_arg(cmdline, args[1]);
+        gchar* path = g_file_get_path(file);
+        g_object_unref(file);
+        if (!path || !g_file_test(path, G_FILE_TEST_IS_REGULAR))
+        {
+            g_application_command_line_printerr(cmdline, "Cannot open config %s\n", args[1]);
+            g_free(path);
+            return 1;
+        }
+        hb_remote_open_config(app, path);
+        g_free(path);
+        return 0;
+    }
+    if (g_strcmp0(cmd, "reload") == 0 && n_args == 1)
+    {
+        g_action_group_activate_action(G_ACTION_GROUP(app), "reload-config", NULL);
+        return 0;
+    }
+    if (g_strcmp0(cmd, "reload-window") == 0 && n_args == 2)
+    {
+        return hb_remote_windows_done(cmdline, args[1],
+                                      hb_remote_for_windows(app, args[1], hb_remote_reload, NULL));
+    }
+    if (g_strcmp0(cmd, "close") == 0 && n_args == 2)
+    {
+        return hb_remote_windows_done(cmdline, args[1],
+                                      hb_remote_for_windows(app, args[1], hb_remote_close, NULL));
+    }
+    if (g_strcmp0(cmd, "navigate") == 0 && n_args == 3)
+    {
+        return hb_remote_windows_done(cmdline, args[1],
+                                      hb_remote_for_windows(app, args[1], hb_remote_navigate, args[2]));
+    }
+    return hb_remote_usage(cmdline);
+}
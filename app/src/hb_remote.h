@@ -0,0 +1,26 @@
+#ifndef HB_REMOTE_H
+#define HB_REMOTE_H
+
+#include <gtk/gtk.h>
+
+// ---------------- Remote control ----------------
+//
+// Application actions, exported on the session bus with the application (org.gtk.Actions on
+// /me/stegall/hudbox) and used by `hudbox --remote`:
+//   open-config (s)      switch the running instance to another config file (reconciled by title,
+//                        like a hot reload) and watch that file from now on
+//   reload-config        re-read the current config file
+//   close-window (s)     close the windows with that title
+//   reload-window (s)    reload the current page of the windows with that title
+//   navigate-window (ss) load a URI in the windows with that title (until they reload their
+//                        configured address)
+//   windows              stateful, state "as": titles of the open windows, in creation order
+
+// Add the actions to app. The current config path is read from the "hb-config-path" app data.
+void hb_remote_install(GtkApplication* app);
+
+// Run `hudbox --remote COMMAND [ARGS...]` (args: everything after --remote) inside the primary
+// instance. Output goes to the invoking terminal; returns its exit status.
+int hb_remote_run(GtkApplication* app, GApplicationCommandLine* cmdline, gchar** args);
+
+#endif // HB_REMOTE_H
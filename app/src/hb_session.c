@@ -0,0 +1,131 @@
+#include "hb_session.h"
+#include <glib/gstdio.h>
+
+struct HbSession
+{
+    gchar* path;
+    GKeyFile* keys; // one group per window title
+};
+
+void hb_session_entry_free(HbSessionEntry* entry)
+{
+    if (!entry) return;
+    g_free(entry->address);
+    if (entry->state) g_bytes_unref(entry->state);
+    g_free(entry);
+}
+
+// Group names can't hold '[', ']' or control characters; keep the rest of the title readable
+static gchar* hb_session_group(const gchar* title)
+{
+    return g_uri_escape_string(title, "!$&'()*+,;=:@/ ", TRUE);
+}
+
+HbSession* hb_session_load(const gchar* path)
+{
+    HbSession* session = g_new0(HbSession, 1);
+    session->path = g_strdup(path);
+    session->keys = g_key_file_new();
+
+    GError* error = NULL;
+    if (!g_key_file_load_from_file(session->keys, path, G_KEY_FILE_NONE, &error))
+    {
+        if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+        {
+            g_warning("Ignoring saved session %s: %s", path, error->message);
+        }
+        g_error_free(error);
+        g_key_file_free(session->keys);
+        session->keys = g_key_file_new();
+    }
+    return session;
+}
+
+void hb_session_free(HbSession* session)
+{
+    if (!session) return;
+    g_key_file_free(session->keys);
+    g_free(session->path);
+    g_free(session);
+}
+
+HbSessionEntry* hb_session_lookup(HbSession* session, const gchar* title)
+{
+    if (!session || !title || !*title) return NULL;
+    gchar* group = hb_session_group(title);
+    if (!g_key_file_has_group(session->keys, group))
+    {
+        g_free(group);
+        return NULL;
+    }
+
+    HbSessionEntry* entry = g_new0(HbSessionEntry, 1);
+    entry->address = g_key_file_get_string(session->keys, group, "address", NULL);
+    gchar* state = g_key_file_get_string(session->keys, group, "state", NULL);
+    if (state && *state)
+    {
+        gsize len = 0;
+        guchar* data = g_base64_decode(state, &len);
+        entry->state = g_bytes_new_take(data, len);
+    }
+    g_free(state);
+    // Missing keys read as 0
+    entry->width = g_key_file_get_integer(session->keys, group, "width", NULL);
+    entry->height = g_key_file_get_integer(session->keys, group, "height", NULL);
+    entry->cfg_width = g_key_file_get_integer(session->keys, group, "config_width", NULL);
+    entry->cfg_height = g_key_file_get_integer(session->keys, group, "config_height", NULL);
+    entry->saved = g_key_file_get_int64(session->keys, group, "saved", NULL);
+    g_free(group);
+    return entry;
+}
+
+void hb_session_set(HbSession* session, const gchar* title, const HbSessionEntry* entry)
+{
+    if (!session || !title || !*title || !entry) return;
+    gchar* group = hb_session_group(title);
+
+    g_key_file_remove_group(session->keys, group, NULL);
+    if (entry->address) g_key_file_set_string(session->keys, group, "address", entry->address);
+    if (entry->state)
+    {
+        gsize len = 0;
+        gconstpointer data = g_bytes_get_data(entry->state, &len);
+        gchar* state = g_base64_encode(data, len);
+        g_key_file_set_string(session->keys, group, "state", state);
+        g_free(state);
+    }
+    g_key_file_set_integer(session->keys, group, "width", entry->width);
+    g_key_file_set_integer(session->keys, group, "height", entry->height);
+    g_key_file_set_integer(session->keys, group, "config_width", entry->cfg_width);
+    g_key_file_set_integer(session->keys, group, "config_height", entry->cfg_height);
+    g_key_file_set_int64(session->keys, group, "saved", g_get_real_time() / G_USEC_PER_SEC);
+    g_free(group);
+}
+
+void hb_session_remove(HbSession* session, const gchar* title)
+{
+    if (!session || !title || !*title) return;
+    gchar* group = hb_session_group(title);
+    g_key_file_remove_group(session->keys, group, NULL);
+    g_free(group);
+}
+
+gboolean hb_session_save(HbSession* session, gint64 max_age_s, GError** error)
+{
+    if (!session) return FALSE;
+
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    gchar** groups = g_key_file_get_groups(session->keys, NULL);
+    for (gchar** group = groups; *group; group++)
+    {
+        gint64 saved = g_key_file_get_int64(session->keys, *group, "saved", NULL);
+        if (now - saved > max_age_s) g_key_file_remove_group(session->keys, *group, NULL);
+    }
+    g_strfreev(groups);
+
+    gchar* dir = g_path_get_dirname(session->path);
+    g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+    // Written to a temporary file and renamed over the old one
+    return g_key_file_save_to_file(session->keys, session->path, error);
+}
@@ -0,0 +1,42 @@
+#ifndef HB_SESSION_H
+#define HB_SESSION_H
+
+#include <glib.h>
+
+// ---------------- Saved window sessions ----------------
+//
+// Per-window state kept across restarts, keyed by window title, in a key file. Windows with
+// the same title share one entry (the last one saved wins).
+
+typedef struct
+{
+    gchar* address;    // configured address when saved; state only applies to the same one
+    GBytes* state;     // serialized web view session state (history, scroll positions); may be NULL
+    gint width;        // window size when saved
+    gint height;
+    gint cfg_width;    // configured size when saved; the saved size only applies while it's unchanged
+    gint cfg_height;
+    gint64 saved;      // wall-clock time of the save, in seconds
+} HbSessionEntry;
+
+void hb_session_entry_free(HbSessionEntry* entry);
+
+typedef struct HbSession HbSession;
+
+// Read the store at path. A missing or unreadable file gives an empty store saving to path.
+HbSession* hb_session_load(const gchar* path);
+void hb_session_free(HbSession* session);
+
+// Copy of the entry for title, or NULL. Free with hb_session_entry_free().
+HbSessionEntry* hb_session_lookup(HbSession* session, const gchar* title);
+
+// Replace the entry for title (entry->saved is set to the current time).
+void hb_session_set(HbSession* session, const gchar* title, const HbSessionEntry* entry);
+
+// Forget the entry for title, if any.
+void hb_session_remove(HbSession* session, const gchar* title);
+
+// Drop entries saved more than max_age_s seconds ago, then write the file atomically.
+gboolean hb_session_save(HbSession* session, gint64 max_age_s, GError** error);
+
+#endif // HB_SESSION_H
@@ -0,0 +1,144 @@
+#include "hb_startup.h"
+#include "hb_window.h"
+
+// Key of the running startup on the application
+#define HB_STARTUP_KEY "hb-startup"
+
+typedef struct
+{
+    GtkApplication* app;
+    HbConfigSet* set;
+    GPtrArray* cfgs;      // HbWindowCfg* into set, sorted by descending priority
+    guint next;           // index of the next config to create
+    guint idle_source;
+    GQueue pending;       // HbWindow* created but not loading yet, in priority order
+    guint in_flight;      // loads started and not finished
+    guint max_concurrent; // 0 = unlimited
+} HbStartup;
+
+static void hb_startup_pump(HbStartup* st);
+
+static gint hb_cfg_priority_cmp(gconstpointer a, gconstpointer b)
+{
+    const HbWindowCfg* ca = *(HbWindowCfg* const*)a;
+    const HbWindowCfg* cb = *(HbWindowCfg* const*)b;
+    // descending; g_ptr_array_sort() is stable so equal priorities keep config order
+    return (cb->priority > ca->priority) - (cb->priority < ca->priority);
+}
+
+static void hb_startup_maybe_free(HbStartup* st)
+{
+    if (st->next < st->cfgs->len || st->in_flight > 0 || !g_queue_is_empty(&st->pending)) return;
+    g_clear_handle_id(&st->idle_source, g_source_remove);
+    g_object_set_data(G_OBJECT(st->app), HB_STARTUP_KEY, NULL);
+    g_ptr_array_free(st->cfgs, TRUE);
+    hb_config_set_free(st->set);
+    g_object_unref(st->app);
+    g_free(st);
+}
+
+static void on_window_load_done(HbWindow* win, gboolean finished, gpointer user_data)
+{
+    HbStartup* st = user_data;
+    // Either it was loading, or it went away while still waiting for a slot
+    if (!g_queue_remove(&st->pending, win) && st->in_flight > 0)
+    {
+        st->in_flight--;
+    }
+    hb_startup_pump(st);
+}
+
+static void hb_startup_pump(HbStartup* st)
+{
+    while (!g_queue_is_empty(&st->pending) &&
+        (st->max_concurrent == 0 || st->in_flight < st->max_concurrent))
+    {
+        HbWindow* win = g_queue_pop_head(&st->pending);
+        st->in_flight++;
+        hb_window_load(win);
+    }
+    hb_startup_maybe_free(st);
+}
+
+// Queue win for a load slot behind every waiting window of the same or higher priority
+static void hb_startup_enqueue(HbStartup* st, HbWindow* win)
+{
+    GList* l = st->pending.head;
+    while (l && ((HbWindow*)l->data)->cfg.priority >= win->cfg.priority) l = l->next;
+    g_queue_insert_before(&st->pending, l, win);
+    hb_window_set_load_done_func(win, on_window_load_done, st);
+}
+
+static void hb_startup_create_next(HbStartup* st)
+{
+    HbWindowCfg* cfg = g_ptr_array_index(st->cfgs, st->next);
+    st->next++;
+
+    hb_startup_enqueue(st, hb_create_window_full(st->app, cfg, FALSE));
+}
+
+static gboolean on_startup_idle(gpointer user_data)
+{
+    HbStartup* st = user_data;
+
+    hb_startup_create_next(st);
+    gboolean more = st->next < st->cfgs->len;
+    if (!more) st->idle_source = 0;
+
+    // May free st once the last window is created and every load has finished
+    hb_startup_pump(st);
+    return more ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+void hb_startup_run(GtkApplication* app, HbConfigSet* set, guint max_concurrent_loads)
+{
+    if (!set) return;
+
+    HbStartup* st = g_new0(HbStartup, 1);
+    st->app = g_object_ref(app);
+    st->set = set;
+    st->cfgs = g_ptr_array_sized_new(set->n_windows);
+    for (guint i = 0; i < set->n_windows; i++) g_ptr_array_add(st->cfgs, &set->windows[i]);
+    st->max_concurrent = max_concurrent_loads;
+    g_queue_init(&st->pending);
+
+    g_ptr_array_sort(st->cfgs, hb_cfg_priority_cmp);
+    g_object_set_data(G_OBJECT(app), HB_STARTUP_KEY, st);
+
+    // The highest-priority group appears right away...
+    gint top = ((HbWindowCfg*)g_ptr_array_index(st->cfgs, 0))->priority;
+    while (st->next < st->cfgs->len &&
+        ((HbWindowCfg*)g_ptr_array_index(st->cfgs, st->next))->priority == top)
+    {
+        hb_startup_create_next(st);
+    }
+
+    // ...everything else is created in later main-loop iterations, after input and painting
+    if (st->next < st->cfgs->len)
+    {
+        st->idle_source = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, on_startup_idle, st, NULL);
+    }
+
+    hb_startup_pump(st);
+}
+
+void hb_startup_flush(GtkApplication* app)
+{
+    HbStartup* st = g_object_get_data(G_OBJECT(app), HB_STARTUP_KEY);
+    if (!st || st->next >= st->cfgs->len) return;
+
+    g_clear_handle_id(&st->idle_source, g_source_remove);
+    while (st->next < st->cfgs->len) hb_startup_create_next(st);
+    hb_startup_pump(st);
+}
+
+HbWindow* hb_startup_create_window(GtkApplication* app, const HbWindowCfg* cfg)
+{
+    HbStartup* st = g_object_get_data(G_OBJECT(app), HB_STARTUP_KEY);
+    if (!st) return hb_create_window(app, cfg);
+
+    HbWindow* win = hb_create_window_full(app, cfg, FALSE);
+    hb_startup_enqueue(st, win);
+    hb_startup_pump(st);
+    return win;
+}
@@ -0,0 +1,25 @@
+#ifndef HB_STARTUP_H
+#define HB_STARTUP_H
+
+#include <gtk/gtk.h>
+#include "hb_config.h"
+#include "hb_window.h"
+
+// ---------------- Staggered startup ----------------
+
+// Create windows for the entries of set (ownership taken) in descending priority.
+// Windows sharing the highest priority are created immediately; the rest are created one per
+// idle slice so the first windows can paint. At most max_concurrent_loads pages load at the same
+// time (0 = no limit), handed out in priority order as earlier loads finish.
+void hb_startup_run(GtkApplication* app, HbConfigSet* set, guint max_concurrent_loads);
+
+// Create the windows of a running startup that are still waiting for their idle slice right away,
+// so that every configured window exists; their loads keep waiting for a slot. Does nothing once
+// the startup is over.
+void hb_startup_flush(GtkApplication* app);
+
+// Create a window for cfg. While a startup is running, its load queues behind the startup's by
+// priority and counts against max_concurrent_loads; otherwise it starts loading right away.
+HbWindow* hb_startup_create_window(GtkApplication* app, const HbWindowCfg* cfg);
+
+#endif // HB_STARTUP_H
@@ -0,0 +1,223 @@
+#include "hb_trace.h"
+#include <json-glib/json-glib.h>
+
+typedef struct
+{
+    gchar* name;
+    gchar phase; // 'X' complete, 'i' instant, 'M' metadata (track name)
+    guint track;
+    gint64 ts;   // microseconds since hb_trace_open()
+    gint64 dur;
+} HbTraceEvent;
+
+static GMutex hb_trace_lock;
+static gchar* hb_trace_path = NULL;
+static GArray* hb_trace_events = NULL;
+static gint64 hb_trace_origin = 0;
+static guint hb_trace_next_track = HB_TRACE_TRACK_MAIN + 1;
+static guint hb_trace_max_events = HB_TRACE_MAX_EVENTS;
+static guint64 hb_trace_dropped = 0;
+
+// Read without the lock: a stale answer only drops or records one extra event
+static volatile gint hb_trace_enabled = 0;
+
+static void hb_trace_event_clear(gpointer data)
+{
+    HbTraceEvent* ev = data;
+    g_free(ev->name);
+}
+
+// Caller holds hb_trace_lock
+static void hb_trace_push(gchar phase, guint track, const gchar* name, gint64 start_us, gint64 dur_us)
+{
+    if (!hb_trace_events) return;
+    // A long-running HUD keeps producing load and paint events; keep the earliest ones
+    if (phase != 'M' && hb_trace_events->len >= hb_trace_max_events)
+    {
+        if (hb_trace_dropped++ == 0)
+        {
+            g_warning("Trace buffer is full (%u events); dropping later events", hb_trace_max_events);
+        }
+        return;
+    }
+    HbTraceEvent ev = {
+        .name = g_strdup(name),
+        .phase = phase,
+        .track = track,
+        .ts = start_us - hb_trace_origin,
+        .dur = dur_us,
+    };
+    g_array_append_val(hb_trace_events, ev);
+}
+
+gboolean hb_trace_open(const gchar* path)
+{
+    if (!path || !*path) return FALSE;
+    g_mutex_lock(&hb_trace_lock);
+    if (hb_trace_events)
+    {
+        g_mutex_unlock(&hb_trace_lock);
+        return FALSE;
+    }
+    hb_trace_path = g_strdup(path);
+    hb_trace_events = g_array_new(FALSE, FALSE, sizeof(HbTraceEvent));
+    g_array_set_clear_func(hb_trace_events, hb_trace_event_clear);
+    hb_trace_origin = g_get_monotonic_time();
+    hb_trace_next_track = HB_TRACE_TRACK_MAIN + 1;
+    hb_trace_dropped = 0;
+    hb_trace_push('M', HB_TRACE_TRACK_MAIN, "startup", hb_trace_origin, 0);
+    g_atomic_int_set(&hb_trace_enabled, 1);
+    g_mutex_unlock(&hb_trace_lock);
+    return TRUE;
+}
+
+gboolean hb_trace_is_enabled(void)
+{
+    return g_atomic_int_get(&hb_trace_enabled) != 0;
+}
+
+void hb_trace_set_max_events(guint max_events)
+{
+    g_mutex_lock(&hb_trace_lock);
+    hb_trace_max_events = max_events;
+    g_mutex_unlock(&hb_trace_lock);
+}
+
+gint64 hb_trace_now(void)
+{
+    return g_get_monotonic_time();
+}
+
+guint hb_trace_new_track(const gchar* name)
+{
+    if (!hb_trace_is_enabled()) return 0;
+    g_mutex_lock(&hb_trace_lock);
+    guint track = hb_trace_next_track++;
+    hb_trace_push('M', track, name ? name : "track", hb_trace_origin, 0);
+    g_mutex_unlock(&hb_trace_lock);
+    return track;
+}
+
+void hb_trace_complete(guint track, const gchar* name, gint64 start_us, gint64 end_us)
+{
+    if (!hb_trace_is_enabled()) return;
+    g_mutex_lock(&hb_trace_lock);
+    hb_trace_push('X', track, name, start_us, MAX(end_us - start_us, 0));
+    g_mutex_unlock(&hb_trace_lock);
+}
+
+void hb_trace_span(guint track, const gchar* name, gint64 start_us)
+{
+    hb_trace_complete(track, name, start_us, hb_trace_now());
+}
+
+void hb_trace_instant(guint track, const gchar* name)
+{
+    if (!hb_trace_is_enabled()) return;
+    g_mutex_lock(&hb_trace_lock);
+    hb_trace_push('i', track, name, hb_trace_now(), 0);
+    g_mutex_unlock(&hb_trace_lock);
+}
+
+static JsonNode* hb_trace_build(GArray* events)
+{
+    JsonBuilder* b = json_builder_new();
+    json_builder_begin_object(b);
+    json_builder_set_member_name(b, "displayTimeUnit");
+    json_builder_add_string_value(b, "ms");
+    json_builder_set_member_name(b, "traceEvents");
+    json_builder_begin_array(b);
+
+    for (guint i = 0; i < events->len; i++)
+    {
+        const HbTraceEvent* ev = &g_array_index(events, HbTraceEvent, i);
+        gchar ph[2] = {ev->phase, '\0'};
+
+        json_builder_begin_object(b);
+        json_builder_set_member_name(b, "ph");
+        json_builder_add_string_value(b, ph);
+        json_builder_set_member_name(b, "pid");
+        json_builder_add_int_value(b, 1);
+        json_builder_set_member_name(b, "tid");
+        json_builder_add_int_value(b, ev->track);
+
+        if (ev->phase == 'M')
+        {
+            json_builder_set_member_name(b, "name");
+            json_builder_add_string_value(b, "thread_name");
+            json_builder_set_member_name(b, "args");
+            json_builder_begin_object(b);
+            json_builder_set_member_name(b, "name");
+            json_builder_add_string_value(b, ev->name);
+            json_builder_end_object(b);
+        }
+        else
+        {
+            json_builder_set_member_name(b, "name");
+            json_builder_add_string_value(b, ev->name);
+            json_builder_set_member_name(b, "ts");
+            json_builder_add_int_value(b, ev->ts);
+            if (ev->phase == 'X')
+            {
+                json_builder_set_member_name(b, "dur");
+                json_builder_add_int_value(b, ev->dur);
+            }
+            else
+            {
+                // instant events are scoped to their track
+                json_builder_set_member_name(b, "s");
+                json_builder_add_string_value(b, "t");
+            }
+        }
+        json_builder_end_object(b);
+    }
+
+    json_builder_end_array(b);
+    json_builder_end_object(b);
+
+    JsonNode* root = json_builder_get_root(b);
+    g_object_unref(b);
+    return root;
+}
+
+gboolean hb_trace_close(void)
+{
+    g_mutex_lock(&hb_trace_lock);
+    if (!hb_trace_events)
+    {
+        g_mutex_unlock(&hb_trace_lock);
+        return FALSE;
+    }
+    g_atomic_int_set(&hb_trace_enabled, 0);
+    GArray* events = hb_trace_events;
+    gchar* path = hb_trace_path;
+    guint64 dropped = hb_trace_dropped;
+    hb_trace_events = NULL;
+    hb_trace_path = NULL;
+    g_mutex_unlock(&hb_trace_lock);
+    if (dropped > 0)
+    {
+        g_message("Trace %s is missing %" G_GUINT64_FORMAT " events past the buffer limit", path, dropped);
+    }
+
+    JsonNode* root = hb_trace_build(events);
+    JsonGenerator* gen = json_generator_new();
+    json_generator_set_root(gen, root);
+
+    GError* error = NULL;
+    gboolean ok = json_generator_to_file(gen, path, &error);
+    if (!ok)
+    {
+        if (error)
+        {
+            g_warning("Failed to write trace to %s: %s", path, error->message);
+            g_error_free(error);
+        }
+    }
+
+    g_object_unref(gen);
+    json_node_unref(root);
+    g_array_free(events, TRUE);
+    g_free(path);
+    return ok;
+}
@@ -0,0 +1,45 @@
+#ifndef HB_TRACE_H
+#define HB_TRACE_H
+
+#include <glib.h>
+
+// ---------------- Startup / load tracing ----------------
+//
+// Records Chrome trace-event JSON ({"traceEvents": [...]}) loadable in chrome://tracing and
+// Perfetto. Events are buffered in memory and written by hb_trace_close(); once the buffer holds
+// its maximum number of events, later ones are dropped (track names are always kept). Every
+// function is a cheap no-op while tracing is disabled and may be called from any thread.
+
+// Track 0 is the main startup track; windows get their own via hb_trace_new_track().
+#define HB_TRACE_TRACK_MAIN 0
+
+// Default bound on buffered events: startup and hours of page loads in a few MiB
+#define HB_TRACE_MAX_EVENTS 100000
+
+// Start recording; the file is written on hb_trace_close(). Returns FALSE if already open.
+gboolean hb_trace_open(const gchar* path);
+
+gboolean hb_trace_is_enabled(void);
+
+// Bound the events buffered by the next hb_trace_open() (default HB_TRACE_MAX_EVENTS).
+void hb_trace_set_max_events(guint max_events);
+
+// Write the trace file and stop recording. Returns FALSE if the file could not be written.
+gboolean hb_trace_close(void);
+
+// Monotonic timestamp in microseconds, suitable for the start/end arguments below.
+gint64 hb_trace_now(void);
+
+// Allocate a new named track (shown as a thread row). Returns 0 while tracing is disabled.
+guint hb_trace_new_track(const gchar* name);
+
+// A span that started at start_us and ends now ("X" complete event).
+void hb_trace_span(guint track, const gchar* name, gint64 start_us);
+
+// A span with explicit start and end timestamps.
+void hb_trace_complete(guint track, const gchar* name, gint64 start_us, gint64 end_us);
+
+// A point-in-time marker ("i" instant event).
+void hb_trace_instant(guint track, const gchar* name);
+
+#endif // HB_TRACE_H
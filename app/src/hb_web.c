@@ -0,0 +1,497 @@
+#include "hb_web.h"
+#include "hb_trace.h"
+#include "hb_cache.h"
+#include "hb_bundle.h"
+#include "hb_filter.h"
+#include "hb_inject.h"
+#include "hb_fetch.h"
+#include <libsoup/soup.h>
+#include <string.h>
+
+#define HB_BUNDLE_SCHEME "hudbox"
+// hbcache://host/path fetches https://host/path, hbcache-http://host/path fetches http://host/path
+#define HB_FETCH_SCHEME "hbcache"
+#define HB_FETCH_HTTP_SCHEME "hbcache-http"
+
+static WebKitWebContext* hb_context = NULL;
+static WebKitNetworkSession* hb_session = NULL;           // persistent profile storage
+static WebKitNetworkSession* hb_ephemeral_session = NULL; // created on first use
+
+// Memory limit (MiB) -> WebKitWebContext* configured with matching memory-pressure settings.
+// Windows without a budget use hb_context.
+static GHashTable* hb_limited_contexts = NULL;
+static HbProcessModel hb_process_model = HB_PROCESS_MODEL_PER_WINDOW;
+
+// Process-group key -> GWeakRef* to the first live view of that group. Views created with
+// "related-view" set to that view share its web process.
+static GHashTable* hb_process_groups = NULL;
+
+// Files served for hudbox:// requests, shared by every context
+static HbBundle* hb_bundle = NULL;
+
+// GET responses shared by every view, and the session fetching them (no cookies, no disk cache)
+static HbFetchCache* hb_fetch_cache = NULL;
+static SoupSession* hb_fetch_session = NULL;
+static guint hb_fetch_ttl_s = 5;
+
+// Views on hb_context and hb_session whose web process is already running (see spare_views)
+static GQueue hb_spare_views = G_QUEUE_INIT;
+// Spares still loading about:blank; only handed out once that load finished
+static GQueue hb_spare_starting = G_QUEUE_INIT;
+static guint hb_spare_target = 0;
+static guint hb_spare_refill = 0;
+
+static void hb_weak_ref_free(gpointer data)
+{
+    GWeakRef* ref = data;
+    g_weak_ref_clear(ref);
+    g_free(ref);
+}
+
+// Emitted right before WebKit launches a new web process for the context
+static void on_initialize_web_process(WebKitWebContext* context, gpointer user_data)
+{
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "web_process_spawn");
+}
+
+static void on_bundle_scheme_request(WebKitURISchemeRequest* request, gpointer user_data)
+{
+    // Keep the path percent-encoded; hb_bundle_resolve() decodes it segment by segment
+    GUri* uri = g_uri_parse(webkit_uri_scheme_request_get_uri(request), G_URI_FLAGS_ENCODED_PATH, NULL);
+    const gchar* mime_type = NULL;
+    GError* error = NULL;
+    GBytes* bytes = hb_bundle_read(hb_bundle,
+                                   uri ? g_uri_get_host(uri) : NULL,
+                                   uri ? g_uri_get_path(uri) : NULL,
+                                   &mime_type,
+                                   &error);
+    if (uri) g_uri_unref(uri);
+    if (!bytes)
+    {
+        webkit_uri_scheme_request_finish_error(request, error);
+        g_error_free(error);
+        return;
+    }
+
+    // The stream reads straight from the file mapping
+    GInputStream* stream = g_memory_input_stream_new_from_bytes(bytes);
+    WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(stream, (gint64)g_bytes_get_size(bytes));
+    webkit_uri_scheme_response_set_content_type(response, mime_type);
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+    g_object_unref(stream);
+    g_bytes_unref(bytes);
+}
+
+static void on_upstream_fetched(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    SoupMessage* msg = soup_session_get_async_result_message(SOUP_SESSION(source), result);
+    gchar* url = user_data;
+    GError* error = NULL;
+    GBytes* body = soup_session_send_and_read_finish(SOUP_SESSION(source), result, &error);
+    if (!body)
+    {
+        hb_fetch_cache_complete(hb_fetch_cache, url, NULL, 0, error);
+        g_error_free(error);
+        g_free(url);
+        return;
+    }
+
+    SoupMessageHeaders* headers = soup_message_get_response_headers(msg);
+    HbFetchResponse* response = g_new0(HbFetchResponse, 1);
+    response->status = soup_message_get_status(msg);
+    response->content_type = g_strdup(soup_message_headers_get_one(headers, "Content-Type"));
+    response->allow_origin = g_strdup(soup_message_headers_get_one(headers, "Access-Control-Allow-Origin"));
+    response->body = body;
+    guint ttl = hb_fetch_ttl(soup_message_headers_get_list(headers, "Cache-Control"), hb_fetch_ttl_s);
+    hb_fetch_cache_complete(hb_fetch_cache, url, response, ttl, NULL);
+    g_free(url);
+}
+
+static void hb_fetch_upstream(HbFetchCache* cache, const gchar* url, gpointer user_data)
+{
+    SoupMessage* msg = soup_message_new(SOUP_METHOD_GET, url);
+    if (!msg)
+    {
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid address %s", url);
+        hb_fetch_cache_complete(cache, url, NULL, 0, error);
+        g_error_free(error);
+        return;
+    }
+    soup_session_send_and_read_async(hb_fetch_session, msg, G_PRIORITY_DEFAULT, NULL, on_upstream_fetched, g_strdup(url));
+    g_object_unref(msg);
+}
+
+static void on_fetch_response(const HbFetchResponse* response, const GError* error, gpointer user_data)
+{
+    WebKitURISchemeRequest* request = user_data;
+    if (!response)
+    {
+        webkit_uri_scheme_request_finish_error(request, (GError*)error);
+        g_object_unref(request);
+        return;
+    }
+
+    GInputStream* stream = g_memory_input_stream_new_from_bytes(response->body);
+    WebKitURISchemeResponse* scheme_response =
+        webkit_uri_scheme_response_new(stream, (gint64)g_bytes_get_size(response->body));
+    webkit_uri_scheme_response_set_status(scheme_response, response->status, NULL);
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    if (response->content_type) soup_message_headers_replace(headers, "Content-Type", response->content_type);
+    // Upstream's CORS policy applies as if the page had fetched it directly: no header, no read
+    if (response->allow_origin)
+    {
+        soup_message_headers_replace(headers, "Access-Control-Allow-Origin", response->allow_origin);
+    }
+    webkit_uri_scheme_response_set_http_headers(scheme_response, headers); // takes the headers
+    webkit_uri_scheme_request_finish_with_response(request, scheme_response);
+    g_object_unref(scheme_response);
+    g_object_unref(stream);
+    g_object_unref(request);
+}
+
+static void on_fetch_scheme_request(WebKitURISchemeRequest* request, gpointer user_data)
+{
+    const gchar* method = webkit_uri_scheme_request_get_http_method(request);
+    if (method && g_ascii_strcasecmp(method, "GET") != 0)
+    {
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "%s only supports GET", HB_FETCH_SCHEME);
+        webkit_uri_scheme_request_finish_error(request, error);
+        g_error_free(error);
+        return;
+    }
+
+    // Same address with the real scheme; the rest (host, port, path, query) is kept verbatim
+    const gchar* uri = webkit_uri_scheme_request_get_uri(request);
+    const gchar* scheme = webkit_uri_scheme_request_get_scheme(request);
+    gchar* url = g_strconcat(g_strcmp0(scheme, HB_FETCH_HTTP_SCHEME) == 0 ? "http" : "https",
+                             uri + strlen(scheme), NULL);
+    gchar* fragment = strchr(url, '#');
+    if (fragment) *fragment = '\0';
+    hb_fetch_cache_get(hb_fetch_cache, url, on_fetch_response, g_object_ref(request));
+    g_free(url);
+}
+
+static void hb_context_setup(WebKitWebContext* context)
+{
+    // Favor keeping resources around: pages are reloaded often and the disk cache is bounded
+    webkit_web_context_set_cache_model(context, WEBKIT_CACHE_MODEL_WEB_BROWSER);
+
+    // Local bundles behave like a secure origin that may be fetched cross-origin
+    webkit_web_context_register_uri_scheme(context, HB_BUNDLE_SCHEME, on_bundle_scheme_request, NULL, NULL);
+    WebKitSecurityManager* security = webkit_web_context_get_security_manager(context);
+    webkit_security_manager_register_uri_scheme_as_secure(security, HB_BUNDLE_SCHEME);
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(security, HB_BUNDLE_SCHEME);
+
+    // Shared fetches of remote resources. Only the https-backed scheme is a secure origin: plain-http
+    // content stays subject to mixed-content blocking on https pages
+    const gchar* fetch_schemes[] = {HB_FETCH_SCHEME, HB_FETCH_HTTP_SCHEME};
+    for (gsize i = 0; i < G_N_ELEMENTS(fetch_schemes); i++)
+    {
+        webkit_web_context_register_uri_scheme(context, fetch_schemes[i], on_fetch_scheme_request, NULL, NULL);
+        webkit_security_manager_register_uri_scheme_as_cors_enabled(security, fetch_schemes[i]);
+    }
+    webkit_security_manager_register_uri_scheme_as_secure(security, HB_FETCH_SCHEME);
+    if (hb_trace_is_enabled())
+    {
+        g_signal_connect(context, "initialize-web-process-extensions", G_CALLBACK(on_initialize_web_process), NULL);
+    }
+}
+
+static void hb_spare_views_update(void);
+
+static void hb_spare_drop(WebKitWebView* view)
+{
+    g_signal_handlers_disconnect_by_data(view, &hb_spare_starting);
+    g_object_unref(view);
+}
+
+static void on_spare_load_changed(WebKitWebView* view, WebKitLoadEvent event, gpointer user_data)
+{
+    if (event != WEBKIT_LOAD_FINISHED || !g_queue_remove(&hb_spare_starting, view)) return;
+    // A window connects its own handlers only after this, so it never sees the blank load
+    g_signal_handlers_disconnect_by_data(view, &hb_spare_starting);
+    g_queue_push_tail(&hb_spare_views, view);
+    hb_spare_views_update();
+}
+
+static void on_spare_terminated(WebKitWebView* view, WebKitWebProcessTerminationReason reason, gpointer user_data)
+{
+    if (!g_queue_remove(&hb_spare_starting, view)) return;
+    hb_spare_drop(view);
+    hb_spare_views_update();
+}
+
+// Start one spare per idle callback, at low priority so windows being created come first
+static gboolean on_spare_refill(gpointer user_data)
+{
+    if (hb_spare_views.length + hb_spare_starting.length >= hb_spare_target)
+    {
+        hb_spare_refill = 0;
+        return G_SOURCE_REMOVE;
+    }
+    gint64 t_spare = hb_trace_now();
+    WebKitWebView* view = WEBKIT_WEB_VIEW(g_object_ref_sink(g_object_new(WEBKIT_TYPE_WEB_VIEW,
+                                                                         "web-context", hb_context,
+                                                                         "network-session", hb_session,
+                                                                         NULL)));
+    // Its history before the blank load, to put back when the view is handed out (see below)
+    g_object_set_data_full(G_OBJECT(view), "hb-empty-session", webkit_web_view_get_session_state(view),
+                           (GDestroyNotify)webkit_web_view_session_state_unref);
+    g_signal_connect(view, "load-changed", G_CALLBACK(on_spare_load_changed), &hb_spare_starting);
+    g_signal_connect(view, "web-process-terminated", G_CALLBACK(on_spare_terminated), &hb_spare_starting);
+    // WebKit launches the web process on the first load
+    webkit_web_view_load_uri(view, "about:blank");
+    g_queue_push_tail(&hb_spare_starting, view);
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "spare_view", t_spare);
+    return G_SOURCE_CONTINUE;
+}
+
+static void hb_spare_views_update(void)
+{
+    // Spares still starting go first, then the ready ones
+    while (hb_spare_starting.length > 0 && hb_spare_views.length + hb_spare_starting.length > hb_spare_target)
+    {
+        hb_spare_drop(g_queue_pop_tail(&hb_spare_starting));
+    }
+    while (hb_spare_views.length > hb_spare_target)
+    {
+        g_object_unref(g_queue_pop_tail(&hb_spare_views));
+    }
+    if (hb_spare_views.length + hb_spare_starting.length < hb_spare_target && !hb_spare_refill)
+    {
+        hb_spare_refill = g_idle_add_full(G_PRIORITY_LOW, on_spare_refill, NULL, NULL);
+    }
+}
+
+void hb_web_prepare(void)
+{
+    if (hb_context) return;
+    gint64 t_context = hb_trace_now();
+    hb_context = webkit_web_context_new();
+    hb_context_setup(hb_context);
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "web_context_new", t_context);
+}
+
+void hb_web_init(const HbAppCfg* app_cfg)
+{
+    if (app_cfg)
+    {
+        hb_process_model = app_cfg->process_model;
+        hb_inject_set_global((const gchar* const*)app_cfg->user_css, (const gchar* const*)app_cfg->user_js);
+        hb_spare_target = app_cfg->spare_views;
+    }
+    if (hb_session)
+    {
+        if (app_cfg)
+        {
+            gchar* bundle_root = hb_app_cfg_get_bundle_root(app_cfg);
+            hb_bundle_set_root(hb_bundle, bundle_root);
+            g_free(bundle_root);
+            hb_spare_views_update();
+        }
+        return;
+    }
+
+    hb_web_prepare();
+    gint64 t_init = hb_trace_now();
+    gchar* bundle_root = hb_app_cfg_get_bundle_root(app_cfg);
+    guint bundle_cache_mb = app_cfg ? app_cfg->bundle_cache_mb : 16;
+    hb_bundle = hb_bundle_new(bundle_root, (guint64)bundle_cache_mb * 1024 * 1024);
+    g_free(bundle_root);
+
+    guint shared_cache_mb = app_cfg ? app_cfg->shared_cache_mb : 16;
+    hb_fetch_ttl_s = shared_cache_mb > 0 ? (app_cfg ? app_cfg->shared_cache_ttl : 5) : 0;
+    hb_fetch_cache = hb_fetch_cache_new((guint64)shared_cache_mb * 1024 * 1024, hb_fetch_upstream, NULL);
+    hb_fetch_session = soup_session_new_with_options("user-agent", "HudBox", NULL);
+
+    // Persistent website data and HTTP disk cache for the configured profile
+    gchar* data_dir = hb_app_cfg_get_data_dir(app_cfg);
+    gchar* cache_dir = hb_app_cfg_get_cache_dir(app_cfg);
+    if (app_cfg && app_cfg->max_cache_mb > 0)
+    {
+        // WebKit sizes its cache from free disk space; bound it before the network process opens it
+        guint64 removed = hb_cache_prune(cache_dir, (guint64)app_cfg->max_cache_mb * 1024 * 1024);
+        if (removed > 0)
+        {
+            g_message("Pruned %" G_GUINT64_FORMAT " KiB from disk cache %s", removed / 1024, cache_dir);
+        }
+    }
+    hb_session = webkit_network_session_new(data_dir, cache_dir);
+
+    // Compiled filters live with the profile's data: pruning the disk cache must not drop them
+    if (app_cfg && app_cfg->content_filters)
+    {
+        gchar* store_dir = g_build_filename(data_dir, "content-filters", NULL);
+        hb_filter_init((const gchar* const*)app_cfg->content_filters, store_dir);
+        g_free(store_dir);
+    }
+    g_free(data_dir);
+    g_free(cache_dir);
+
+    hb_process_groups = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, hb_weak_ref_free);
+    hb_limited_contexts = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    hb_spare_views_update();
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "web_context_init", t_init);
+}
+
+WebKitWebContext* hb_web_get_context(void)
+{
+    hb_web_init(NULL);
+    return hb_context;
+}
+
+WebKitNetworkSession* hb_web_get_network_session(void)
+{
+    hb_web_init(NULL);
+    return hb_session;
+}
+
+// Prefetch the host of an http(s) address, unless it is already in hosts
+static void hb_prefetch_address(GHashTable* hosts, const gchar* address)
+{
+    GUri* uri = g_uri_parse(address, G_URI_FLAGS_NONE, NULL);
+    if (!uri) return;
+    const gchar* scheme = g_uri_get_scheme(uri);
+    const gchar* host = g_uri_get_host(uri);
+    if (host && *host && (g_ascii_strcasecmp(scheme, "http") == 0 || g_ascii_strcasecmp(scheme, "https") == 0))
+    {
+        gchar* key = g_ascii_strdown(host, -1);
+        if (g_hash_table_add(hosts, key))
+        {
+            // Resolver cache is per process: both sessions' loads benefit
+            webkit_network_session_prefetch_dns(hb_session, key);
+        }
+    }
+    g_uri_unref(uri);
+}
+
+void hb_web_get_fetch_stats(HbFetchStats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    hb_fetch_cache_get_stats(hb_fetch_cache, stats);
+}
+
+void hb_web_prefetch_dns(const HbConfigSet* set)
+{
+    if (!set) return;
+    hb_web_init(NULL);
+
+    gint64 t_prefetch = hb_trace_now();
+    GHashTable* hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (guint i = 0; i < set->n_windows; i++)
+    {
+        hb_prefetch_address(hosts, set->windows[i].address);
+        // A carousel preloads its second page right away
+        for (gchar** a = set->windows[i].addresses; a && *a; a++) hb_prefetch_address(hosts, *a);
+    }
+    g_hash_table_unref(hosts);
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "prefetch_dns", t_prefetch);
+}
+
+static WebKitNetworkSession* hb_session_for(const HbWindowCfg* cfg)
+{
+    if (!cfg->ephemeral) return hb_session;
+    if (!hb_ephemeral_session) hb_ephemeral_session = webkit_network_session_new_ephemeral();
+    return hb_ephemeral_session;
+}
+
+// Web processes of a context share its memory-pressure settings, so each distinct budget gets
+// its own context. WebKit kills a process once it reaches the limit (kill threshold 1.0); the
+// window notices through "web-process-terminated" and recycles its view.
+static WebKitWebContext* hb_context_for_limit(guint memory_limit_mb)
+{
+    if (memory_limit_mb == 0) return hb_context;
+
+    WebKitWebContext* ctx = g_hash_table_lookup(hb_limited_contexts, GUINT_TO_POINTER(memory_limit_mb));
+    if (ctx) return ctx;
+
+    WebKitMemoryPressureSettings* mps = webkit_memory_pressure_settings_new();
+    webkit_memory_pressure_settings_set_memory_limit(mps, memory_limit_mb);
+    webkit_memory_pressure_settings_set_kill_threshold(mps, 1.0);
+    ctx = WEBKIT_WEB_CONTEXT(g_object_new(WEBKIT_TYPE_WEB_CONTEXT,
+                                          "memory-pressure-settings", mps,
+                                          NULL));
+    webkit_memory_pressure_settings_free(mps);
+    hb_context_setup(ctx);
+
+    g_hash_table_insert(hb_limited_contexts, GUINT_TO_POINTER(memory_limit_mb), ctx);
+    return ctx;
+}
+
+// Key of the process group a window belongs to, or NULL when it should get its own process.
+// Related views share context and network session, so memory budget and storage are part of the key.
+static gchar* hb_process_group_key(const HbWindowCfg* cfg)
+{
+    const gchar* storage = cfg->ephemeral ? "eph" : "per";
+    switch (hb_process_model)
+    {
+    case HB_PROCESS_MODEL_SHARED:
+        return g_strdup_printf("%u|%s|*", cfg->memory_limit_mb, storage);
+    case HB_PROCESS_MODEL_PER_ORIGIN:
+        {
+            // Addresses without an origin (about:, data:) fall back to their own process
+            gchar* origin = hb_address_origin(cfg->address);
+            if (!origin) return NULL;
+            gchar* key = g_strdup_printf("%u|%s|%s", cfg->memory_limit_mb, storage, origin);
+            g_free(origin);
+            return key;
+        }
+    case HB_PROCESS_MODEL_PER_WINDOW:
+    default:
+        return NULL;
+    }
+}
+
+GtkWidget* hb_web_create_view(const HbWindowCfg* cfg)
+{
+    hb_web_init(NULL);
+
+    gchar* key = hb_process_group_key(cfg);
+    WebKitWebView* related = NULL;
+    if (key)
+    {
+        GWeakRef* ref = g_hash_table_lookup(hb_process_groups, key);
+        if (ref) related = g_weak_ref_get(ref);
+    }
+
+    GtkWidget* view;
+    if (related)
+    {
+        // Context and network session are inherited from the related view
+        view = GTK_WIDGET(g_object_new(WEBKIT_TYPE_WEB_VIEW,
+                                       "related-view", related,
+                                       NULL));
+        g_object_unref(related); // only compared from here on
+    }
+    else if (cfg->memory_limit_mb == 0 && !cfg->ephemeral && !g_queue_is_empty(&hb_spare_views))
+    {
+        // Same context and session as a new view would get, with its web process already up;
+        // the reference we held becomes the caller's floating one
+        view = GTK_WIDGET(g_queue_pop_head(&hb_spare_views));
+        g_object_force_floating(G_OBJECT(view));
+        // Forget about:blank, so it isn't a back entry of the page nor saved with the session
+        WebKitWebViewSessionState* empty = g_object_steal_data(G_OBJECT(view), "hb-empty-session");
+        webkit_web_view_restore_session_state(WEBKIT_WEB_VIEW(view), empty);
+        webkit_web_view_session_state_unref(empty);
+        hb_trace_instant(HB_TRACE_TRACK_MAIN, "spare_view_taken");
+        hb_spare_views_update();
+    }
+    else
+    {
+        view = GTK_WIDGET(g_object_new(WEBKIT_TYPE_WEB_VIEW,
+                                       "web-context", hb_context_for_limit(cfg->memory_limit_mb),
+                                       "network-session", hb_session_for(cfg),
+                                       NULL));
+    }
+    if (key && !related)
+    {
+        // First live view of its group becomes the group's anchor
+        GWeakRef* ref = g_new0(GWeakRef, 1);
+        g_weak_ref_init(ref, view);
+        g_hash_table_replace(hb_process_groups, g_strdup(key), ref);
+    }
+
+    g_free(key);
+    return view;
+}
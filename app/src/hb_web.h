@@ -0,0 +1,43 @@
+#ifndef HB_WEB_H
+#define HB_WEB_H
+
+#include <gtk/gtk.h>
+#include <webkit/webkit.h>
+#include "hb_config.h"
+#include "hb_fetch.h"
+
+// ---------------- Shared WebKit state ----------------
+
+// Create the web context and network session shared by every HUD window. The session stores
+// website data and the HTTP disk cache in the profile directories of app_cfg (the cache is pruned
+// to max_cache_mb first), and every context serves hudbox://<bundle>/<path> from the bundle root
+// and hbcache://<host>/<path> (hbcache-http:// for plain http) through one shared fetch cache.
+// Safe to call more than once; later calls only update the process model used for newly created
+// views, the bundle root and the number of spare views.
+void hb_web_init(const HbAppCfg* app_cfg);
+
+// Create the shared web context ahead of hb_web_init(), e.g. while the configuration is still
+// being loaded. It doesn't depend on the configuration; hb_web_init() calls it if needed.
+void hb_web_prepare(void);
+
+WebKitWebContext* hb_web_get_context(void);
+// The persistent network session (windows with "ephemeral" use a separate in-memory one).
+WebKitNetworkSession* hb_web_get_network_session(void);
+
+// Counters of the hbcache:// shared fetch cache (all zero before hb_web_init()).
+void hb_web_get_fetch_stats(HbFetchStats* stats);
+
+// Start resolving the host names of every http(s) address in set, in parallel and in the
+// background, so their lookups overlap with window creation instead of delaying the first loads.
+// Each host is resolved once.
+void hb_web_prefetch_dns(const HbConfigSet* set);
+
+// Create a web view on the shared context/session, placed in a web process according to the
+// configured process model. Windows with a memory_limit_mb get a context whose web processes
+// are bounded by that budget. A view that would get a web process of its own on the default
+// context and persistent session is taken from the spare views (app_cfg->spare_views), which are
+// refilled when the main loop is idle. Initializes shared state with defaults if hb_web_init()
+// wasn't called.
+GtkWidget* hb_web_create_view(const HbWindowCfg* cfg);
+
+#endif // HB_WEB_H
@@ -0,0 +1,131 @@
+#include "hb_wheel.h"
+
+// Slot index of timers detached from the wheel because they are due in the current advance
+#define HB_WHEEL_FIRING G_MAXUINT
+
+struct HbWheelTimer
+{
+    guint slot;
+    guint64 rounds; // full turns of the wheel left before the timer is due
+    gboolean removed;
+    HbWheelFunc func;
+    gpointer user_data;
+    GList link;
+};
+
+struct HbWheel
+{
+    GQueue* slots;
+    guint n_slots;
+    guint cursor;
+    guint count;
+};
+
+HbWheel* hb_wheel_new(guint n_slots)
+{
+    HbWheel* wheel = g_new0(HbWheel, 1);
+    wheel->n_slots = MAX(n_slots, 1);
+    wheel->slots = g_new0(GQueue, wheel->n_slots);
+    return wheel;
+}
+
+void hb_wheel_free(HbWheel* wheel)
+{
+    if (!wheel) return;
+    for (guint i = 0; i < wheel->n_slots; i++)
+    {
+        GList* l;
+        while ((l = g_queue_pop_head_link(&wheel->slots[i])) != NULL) g_free(l->data);
+    }
+    g_free(wheel->slots);
+    g_free(wheel);
+}
+
+HbWheelTimer* hb_wheel_add(HbWheel* wheel, guint64 ticks, HbWheelFunc func, gpointer user_data)
+{
+    g_return_val_if_fail(wheel != NULL && func != NULL, NULL);
+    if (ticks < 1) ticks = 1;
+
+    HbWheelTimer* timer = g_new0(HbWheelTimer, 1);
+    timer->slot = (guint)((wheel->cursor + ticks) % wheel->n_slots);
+    timer->rounds = (ticks - 1) / wheel->n_slots;
+    timer->func = func;
+    timer->user_data = user_data;
+    timer->link.data = timer;
+    g_queue_push_tail_link(&wheel->slots[timer->slot], &timer->link);
+    wheel->count++;
+    return timer;
+}
+
+void hb_wheel_remove(HbWheel* wheel, HbWheelTimer* timer)
+{
+    if (!wheel || !timer || timer->removed) return;
+    wheel->count--;
+    if (timer->slot == HB_WHEEL_FIRING)
+    {
+        // Due in the running advance; it is skipped and freed there
+        timer->removed = TRUE;
+        return;
+    }
+    g_queue_unlink(&wheel->slots[timer->slot], &timer->link);
+    g_free(timer);
+}
+
+guint hb_wheel_advance(HbWheel* wheel)
+{
+    if (!wheel) return 0;
+    wheel->cursor = (wheel->cursor + 1) % wheel->n_slots;
+
+    // Detach what is due first, so callbacks can freely add timers (even to this slot)
+    GQueue* slot = &wheel->slots[wheel->cursor];
+    GQueue due = G_QUEUE_INIT;
+    for (GList* l = slot->head; l;)
+    {
+        GList* next = l->next;
+        HbWheelTimer* timer = l->data;
+        if (timer->rounds == 0)
+        {
+            g_queue_unlink(slot, l);
+            g_queue_push_tail_link(&due, l);
+            timer->slot = HB_WHEEL_FIRING;
+        }
+        else
+        {
+            timer->rounds--;
+        }
+        l = next;
+    }
+
+    guint fired = 0;
+    GList* l;
+    while ((l = g_queue_pop_head_link(&due)) != NULL)
+    {
+        HbWheelTimer* timer = l->data;
+        if (!timer->removed)
+        {
+            // The handle is invalid once the callback runs
+            timer->removed = TRUE;
+            wheel->count--;
+            timer->func(timer->user_data);
+            fired++;
+        }
+        g_free(timer);
+    }
+    return fired;
+}
+
+guint hb_wheel_get_count(const HbWheel* wheel)
+{
+    return wheel ? wheel->count : 0;
+}
+
+guint64 hb_wheel_jitter(guint64 ticks, guint percent)
+{
+    guint64 spread = ticks * percent / 100;
+    if (spread > 0 && spread <= G_MAXINT32 / 2)
+    {
+        gint32 offset = g_random_int_range(-(gint32)spread, (gint32)spread + 1);
+        ticks = (guint64)((gint64)ticks + offset);
+    }
+    return MAX(ticks, 1);
+}
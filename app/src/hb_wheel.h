@@ -0,0 +1,34 @@
+#ifndef HB_WHEEL_H
+#define HB_WHEEL_H
+
+#include <glib.h>
+
+// ---------------- Timer wheel ----------------
+
+// Hashed timer wheel: many coarse timers driven by a single periodic tick, instead of one main
+// loop source each. Adding, removing and advancing are O(1) per timer; the caller decides what
+// a tick is by calling hb_wheel_advance().
+typedef struct HbWheel HbWheel;
+typedef struct HbWheelTimer HbWheelTimer;
+
+typedef void (*HbWheelFunc)(gpointer user_data);
+
+HbWheel* hb_wheel_new(guint n_slots);
+void hb_wheel_free(HbWheel* wheel);
+
+// Run func once, on the ticks-th hb_wheel_advance() from now (at least the next one). The
+// returned handle is valid until the timer fires or is removed.
+HbWheelTimer* hb_wheel_add(HbWheel* wheel, guint64 ticks, HbWheelFunc func, gpointer user_data);
+void hb_wheel_remove(HbWheel* wheel, HbWheelTimer* timer);
+
+// Move to the next tick and run the timers that are due. Callbacks may add and remove timers.
+// Returns the number of timers that fired.
+guint hb_wheel_advance(HbWheel* wheel);
+
+// Number of pending timers.
+guint hb_wheel_get_count(const HbWheel* wheel);
+
+// ticks moved by a random amount of up to percent of it in either direction; at least 1.
+guint64 hb_wheel_jitter(guint64 ticks, guint percent);
+
+#endif // HB_WHEEL_H
@@ -1,6 +1,40 @@
 #include "hb_window.h"
+#include "hb_web.h"
+#include "hb_trace.h"
+#include "hb_refresh.h"
+#include "hb_filter.h"
+#include "hb_freeze.h"
+#include "hb_inject.h"
+#include "hb_carousel.h"
+#include "hb_perf.h"
 #include <webkit/webkit.h>
 
+// Seconds between effective frame-rate log lines when reporting is enabled
+#define HB_FPS_REPORT_INTERVAL 5
+
+// Pushed payloads kept per window while they can't be delivered; older ones are dropped
+#define HB_PUSH_MAX_PENDING 256
+
+static gboolean hb_fps_reporting = FALSE;
+static guint hb_window_next_id = 1;
+static gboolean hb_push_enabled = FALSE;
+static HbSession* hb_window_session = NULL;
+
+void hb_window_set_fps_reporting(gboolean enabled)
+{
+    hb_fps_reporting = enabled;
+}
+
+void hb_window_set_push_enabled(gboolean enabled)
+{
+    hb_push_enabled = enabled;
+}
+
+void hb_window_set_session(HbSession* session)
+{
+    hb_window_session = session;
+}
+
 // Called when user starts dragging
 static void on_drag_begin(GtkGestureClick* gesture,
                           gint n_press,
@@ -19,15 +53,595 @@ static void on_drag_begin(GtkGestureClick* gesture,
     }
 }
 
-void hb_create_window(GtkApplication* app, const HbWindowCfg* cfg)
+static void hb_window_notify_load_done(HbWindow* win, gboolean finished)
 {
-    GtkWidget* window = gtk_application_window_new(app);
+    HbWindowLoadFunc func = win->load_done_func;
+    if (!func) return;
+    win->load_done_func = NULL;
+    func(win, finished, win->load_done_data);
+}
+
+void hb_window_set_load_done_func(HbWindow* win, HbWindowLoadFunc func, gpointer user_data)
+{
+    if (!win) return;
+    win->load_done_func = func;
+    win->load_done_data = user_data;
+}
 
-    gtk_window_set_title(GTK_WINDOW(window), cfg->title);
-    gtk_window_set_default_size(GTK_WINDOW(window), cfg->width, cfg->height);
+static void hb_window_free(gpointer data)
+{
+    HbWindow* win = data;
+    if (!win) return;
+    hb_window_notify_load_done(win, FALSE);
+    g_clear_handle_id(&win->recycle_source, g_source_remove);
+    g_clear_handle_id(&win->recycle_idle, g_source_remove);
+    g_clear_handle_id(&win->fps_report_source, g_source_remove);
+    g_clear_pointer(&win->frame_stats, g_free);
+    g_queue_clear_full(&win->push_pending, g_free);
+    hb_refresh_clear(win);
+    hb_freeze_clear(win);
+    hb_carousel_clear(win);
+    hb_perf_clear(win);
+    hb_session_entry_free(win->session);
+    hb_window_cfg_clear(&win->cfg);
+    g_free(win);
+}
 
-    gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
-    gtk_window_set_resizable(GTK_WINDOW(window), TRUE);
+HbWindow* hb_window_from_widget(GtkWidget* widget)
+{
+    if (!widget) return NULL;
+    GtkRoot* root = gtk_widget_get_root(widget);
+    if (!root) return NULL;
+    return g_object_get_data(G_OBJECT(root), "hb-window");
+}
+
+static gboolean on_recycle_idle(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    win->recycle_idle = 0;
+    hb_window_recycle(win, "web process terminated");
+    return G_SOURCE_REMOVE;
+}
+
+static void on_web_process_terminated(WebKitWebView* web_view,
+                                      WebKitWebProcessTerminationReason reason,
+                                      gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (reason == WEBKIT_WEB_PROCESS_TERMINATED_BY_API) return;
+    if (GTK_WIDGET(web_view) != win->web_view)
+    {
+        hb_carousel_preload_terminated(win);
+        return;
+    }
+
+    if (reason == WEBKIT_WEB_PROCESS_EXCEEDED_MEMORY_LIMIT)
+    {
+        g_message("Window '%s' exceeded its %u MiB memory budget", win->cfg.title, win->cfg.memory_limit_mb);
+    }
+    else
+    {
+        g_warning("Web process for window '%s' crashed", win->cfg.title);
+    }
+
+    // Don't tear the view down from inside its own signal emission
+    if (!win->recycle_idle)
+    {
+        win->recycle_idle = g_idle_add(on_recycle_idle, win);
+    }
+}
+
+static void on_load_changed(WebKitWebView* web_view, WebKitLoadEvent load_event, gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (GTK_WIDGET(web_view) != win->web_view)
+    {
+        // The carousel's next page, loading out of sight
+        if (GTK_WIDGET(web_view) == win->carousel_next) hb_carousel_note_preload(win, load_event);
+        return;
+    }
+    switch (load_event)
+    {
+    case WEBKIT_LOAD_STARTED:
+        win->load_started_us = hb_trace_now();
+        win->awaiting_first_paint = FALSE;
+        win->push_subscribed = FALSE; // the new document has to subscribe again
+        hb_freeze_note_activity(win);
+        hb_trace_instant(win->trace_track, "load_started");
+        break;
+    case WEBKIT_LOAD_COMMITTED:
+        // the next frame the window presents is the page's first paint
+        win->awaiting_first_paint = TRUE;
+        hb_trace_instant(win->trace_track, "load_committed");
+        break;
+    case WEBKIT_LOAD_FINISHED:
+        // FINISHED is emitted for failed loads too (after "load-failed")
+        win->load_count++;
+        win->last_load_us = hb_trace_now() - win->load_started_us;
+        hb_trace_span(win->trace_track, "load", win->load_started_us);
+        hb_refresh_note_load(win);
+        hb_window_notify_load_done(win, TRUE);
+        break;
+    default:
+        break;
+    }
+}
+
+static gboolean on_load_failed(WebKitWebView* web_view,
+                               WebKitLoadEvent load_event,
+                               gchar* failing_uri,
+                               GError* error,
+                               gpointer user_data)
+{
+    HbWindow* win = user_data;
+    // Navigations replaced by a newer one aren't failures of the page
+    if (GTK_WIDGET(web_view) == win->web_view && !g_error_matches(error, WEBKIT_NETWORK_ERROR, WEBKIT_NETWORK_ERROR_CANCELLED))
+    {
+        win->load_failures++;
+    }
+    return FALSE; // let WebKit show its error page
+}
+
+// Page-side frame cap: requestAnimationFrame callbacks are batched and delivered at most max_fps
+// times per second, so animation-driven pages stop producing (and the window stops presenting)
+// frames the display doesn't need. CSS animations and video are not affected.
+static const char* hb_raf_throttle_js =
+    "(function () {\n"
+    "  var interval = 1000 / %u;\n"
+    "  var nativeRaf = window.requestAnimationFrame.bind(window);\n"
+    "  var pending = new Map(), nextId = 1, scheduled = false, last = 0;\n"
+    "  function pump(ts) {\n"
+    "    var wait = interval - (ts - last);\n"
+    "    if (wait > 1) { setTimeout(function () { nativeRaf(pump); }, wait); return; }\n"
+    "    scheduled = false; last = ts;\n"
+    "    var cbs = pending; pending = new Map();\n"
+    "    cbs.forEach(function (cb) {\n"
+    "      try { cb(ts); } catch (e) { setTimeout(function () { throw e; }); }\n"
+    "    });\n"
+    "  }\n"
+    "  window.requestAnimationFrame = function (cb) {\n"
+    "    var id = nextId++;\n"
+    "    pending.set(id, cb);\n"
+    "    if (!scheduled) { scheduled = true; nativeRaf(pump); }\n"
+    "    return id;\n"
+    "  };\n"
+    "  window.cancelAnimationFrame = function (id) { pending.delete(id); };\n"
+    "})();\n";
+
+// Page-side push API. hudbox.subscribe(cb) registers a listener (and returns a function removing
+// it); the first subscription tells HudBox through the "hudbox" message handler to start
+// delivering. Batches arrive through __hudboxPush([payload, ...]).
+static const char* hb_push_api_js =
+    "(function () {\n"
+    "  if (window.hudbox) return;\n"
+    "  var listeners = [], subscribed = false;\n"
+    "  window.hudbox = Object.freeze({\n"
+    "    subscribe: function (cb) {\n"
+    "      listeners.push(cb);\n"
+    "      if (!subscribed) {\n"
+    "        subscribed = true;\n"
+    "        window.webkit.messageHandlers.hudbox.postMessage('subscribe');\n"
+    "      }\n"
+    "      return function () {\n"
+    "        var i = listeners.indexOf(cb);\n"
+    "        if (i >= 0) listeners.splice(i, 1);\n"
+    "      };\n"
+    "    }\n"
+    "  });\n"
+    "  Object.defineProperty(window, '__hudboxPush', { value: function (batch) {\n"
+    "    batch.forEach(function (msg) {\n"
+    "      listeners.slice().forEach(function (cb) {\n"
+    "        try { cb(msg); } catch (e) { setTimeout(function () { throw e; }); }\n"
+    "      });\n"
+    "    });\n"
+    "  } });\n"
+    "})();\n";
+
+// Deliver everything queued since the last frame in a single script evaluation
+static gboolean on_push_tick(GtkWidget* widget, GdkFrameClock* clock, gpointer user_data)
+{
+    HbWindow* win = hb_window_from_widget(widget);
+    if (!win) return G_SOURCE_REMOVE;
+    win->push_tick = 0;
+    if (!win->push_subscribed || g_queue_is_empty(&win->push_pending)) return G_SOURCE_REMOVE;
+
+    GString* js = g_string_new("window.__hudboxPush([");
+    gchar* payload;
+    gboolean first = TRUE;
+    while ((payload = g_queue_pop_head(&win->push_pending)) != NULL)
+    {
+        // Payloads are serialized JSON, which is valid JavaScript as is
+        if (!first) g_string_append_c(js, ',');
+        g_string_append(js, payload);
+        first = FALSE;
+        g_free(payload);
+    }
+    g_string_append(js, "]);");
+    webkit_web_view_evaluate_javascript(WEBKIT_WEB_VIEW(win->web_view), js->str, (gssize)js->len,
+                                        NULL, NULL, NULL, NULL, NULL);
+    g_string_free(js, TRUE);
+    return G_SOURCE_REMOVE;
+}
+
+static void hb_window_schedule_push(HbWindow* win)
+{
+    if (win->push_tick || !win->push_subscribed || g_queue_is_empty(&win->push_pending)) return;
+    win->push_tick = gtk_widget_add_tick_callback(GTK_WIDGET(win->window), on_push_tick, NULL, NULL);
+}
+
+void hb_window_push(HbWindow* win, const gchar* payload)
+{
+    if (!win || !payload) return;
+    g_queue_push_tail(&win->push_pending, g_strdup(payload));
+    while (win->push_pending.length > HB_PUSH_MAX_PENDING)
+    {
+        g_free(g_queue_pop_head(&win->push_pending));
+    }
+    hb_freeze_note_activity(win);
+    hb_window_schedule_push(win);
+}
+
+static void on_push_script_message(WebKitUserContentManager* ucm, JSCValue* value, gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (!jsc_value_is_string(value)) return;
+    gchar* msg = jsc_value_to_string(value);
+    if (g_strcmp0(msg, "subscribe") == 0 &&
+        ucm != webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(win->web_view)))
+    {
+        // The carousel's next page: remembered for when it is shown
+        g_object_set_data(G_OBJECT(ucm), "hb-push-subscribed", GINT_TO_POINTER(TRUE));
+    }
+    else if (g_strcmp0(msg, "subscribe") == 0)
+    {
+        win->push_subscribed = TRUE;
+        hb_window_schedule_push(win);
+    }
+    g_free(msg);
+}
+
+// Content blockers fail a request without telling the embedder, so blocked requests are
+// approximated from the page side: subresource elements firing "error", and fetch()/XHR requests
+// that fail (aborted fetches aside). Genuine network failures count too, and blocked beacons
+// can't be seen at all. The counter runs in a script world of its own, where the page can't post
+// to the "hudboxBlocked" handler; counts are reported in batches.
+#define HB_BLOCKED_WORLD "hudbox-filter"
+
+static const char* hb_blocked_counter_js =
+    "(function () {\n"
+    "  var pending = 0, timer = 0;\n"
+    "  function report() {\n"
+    "    timer = 0;\n"
+    "    window.webkit.messageHandlers.hudboxBlocked.postMessage(pending);\n"
+    "    pending = 0;\n"
+    "  }\n"
+    "  function count() {\n"
+    "    pending++;\n"
+    "    if (!timer) timer = setTimeout(report, 1000);\n"
+    "  }\n"
+    "  window.addEventListener('error', function (e) {\n"
+    "    var t = e.target;\n"
+    "    if (!t || t === window || !(t.src || t.href)) return;\n"
+    "    count();\n"
+    "  }, true);\n"
+    "  // Node the page-world wrappers report failed requests on; they take it out of the document\n"
+    "  // before any page script runs, so the page itself can't reach it\n"
+    "  var root = document.documentElement;\n"
+    "  if (!root) return;\n"
+    "  var channel = document.createElement('hudbox-blocked');\n"
+    "  channel.addEventListener('hudbox-failed', count);\n"
+    "  root.appendChild(channel);\n"
+    "})();\n";
+
+// Page world: fetch() and XMLHttpRequest live there, out of reach of the counter's world
+static const char* hb_blocked_requests_js =
+    "(function () {\n"
+    "  var root = document.documentElement;\n"
+    "  var channel = root && root.lastElementChild;\n"
+    "  if (!channel || channel.localName !== 'hudbox-blocked') return;\n"
+    "  root.removeChild(channel);\n"
+    "  function failed() { channel.dispatchEvent(new Event('hudbox-failed')); }\n"
+    "  var nativeFetch = window.fetch;\n"
+    "  if (nativeFetch) {\n"
+    "    window.fetch = function () {\n"
+    "      var p = nativeFetch.apply(this, arguments);\n"
+    "      p.catch(function (e) { if (!e || e.name !== 'AbortError') failed(); });\n"
+    "      return p;\n"
+    "    };\n"
+    "  }\n"
+    "  var send = XMLHttpRequest.prototype.send;\n"
+    "  XMLHttpRequest.prototype.send = function () {\n"
+    "    this.addEventListener('error', failed);\n"
+    "    return send.apply(this, arguments);\n"
+    "  };\n"
+    "})();\n";
+
+static void on_blocked_script_message(WebKitUserContentManager* ucm, JSCValue* value, gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (!jsc_value_is_number(value)) return;
+    gint32 n = jsc_value_to_int32(value);
+    if (n > 0) win->blocked_requests += (guint)n;
+}
+
+GtkWidget* hb_window_build_view(HbWindow* win)
+{
+    const HbWindowCfg* cfg = &win->cfg;
+
+    // WebView on the shared context (conditionally make page/window transparent based on config)
+    GtkWidget* web_view = hb_web_create_view(cfg);
+
+    if (cfg->transparent)
+    {
+        // Force page background to be transparent; one sheet shared by every transparent view
+        static WebKitUserStyleSheet* sheet = NULL;
+        if (!sheet)
+        {
+            sheet = webkit_user_style_sheet_new(
+                "html, body {\n"
+                "  background: transparent !important;\n"
+                "  background-color: transparent !important;\n"
+                "}\n",
+                WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+                WEBKIT_USER_STYLE_LEVEL_USER,
+                NULL, NULL);
+        }
+        WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view));
+        webkit_user_content_manager_add_style_sheet(ucm, sheet);
+
+        // Transparent WebView surface to let window show through
+        GdkRGBA transparent = (GdkRGBA){0, 0, 0, 0};
+        webkit_web_view_set_background_color(WEBKIT_WEB_VIEW(web_view), &transparent);
+    }
+
+    // Configured style sheets and scripts, read once and shared between views
+    hb_inject_apply(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view)), cfg);
+
+    if (cfg->max_fps > 0)
+    {
+        gchar* js = g_strdup_printf(hb_raf_throttle_js, cfg->max_fps);
+        WebKitUserScript* script = webkit_user_script_new(
+            js,
+            WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+            WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+            NULL, NULL);
+        WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view));
+        webkit_user_content_manager_add_script(ucm, script);
+        webkit_user_script_unref(script);
+        g_free(js);
+    }
+
+    if (hb_push_enabled)
+    {
+        WebKitUserScript* script = webkit_user_script_new(
+            hb_push_api_js,
+            WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+            WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+            NULL, NULL);
+        WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view));
+        webkit_user_content_manager_add_script(ucm, script);
+        webkit_user_script_unref(script);
+        webkit_user_content_manager_register_script_message_handler(ucm, "hudbox", NULL);
+        g_signal_connect(ucm, "script-message-received::hudbox", G_CALLBACK(on_push_script_message), win);
+    }
+
+    if (hb_filter_is_enabled())
+    {
+        WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view));
+        hb_filter_attach(ucm);
+        // The counter goes first: it sets up the node the page-world script picks up
+        WebKitUserScript* script = webkit_user_script_new_for_world(
+            hb_blocked_counter_js,
+            WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+            WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+            HB_BLOCKED_WORLD,
+            NULL, NULL);
+        webkit_user_content_manager_add_script(ucm, script);
+        webkit_user_script_unref(script);
+        script = webkit_user_script_new(
+            hb_blocked_requests_js,
+            WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+            WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+            NULL, NULL);
+        webkit_user_content_manager_add_script(ucm, script);
+        webkit_user_script_unref(script);
+        webkit_user_content_manager_register_script_message_handler(ucm, "hudboxBlocked", HB_BLOCKED_WORLD);
+        g_signal_connect(ucm, "script-message-received::hudboxBlocked", G_CALLBACK(on_blocked_script_message), win);
+    }
+
+    // Always installed so that "locked" can be toggled on a running window
+    GtkGesture* drag = gtk_gesture_click_new();
+    gtk_event_controller_set_propagation_phase(GTK_EVENT_CONTROLLER(drag),
+                                               cfg->locked ? GTK_PHASE_NONE : GTK_PHASE_BUBBLE);
+    gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(drag), GDK_BUTTON_PRIMARY);
+    g_signal_connect(drag, "pressed", G_CALLBACK(on_drag_begin), win->window);
+    gtk_widget_add_controller(web_view, GTK_EVENT_CONTROLLER(drag));
+    win->drag = GTK_EVENT_CONTROLLER(drag);
+
+    g_signal_connect(web_view, "web-process-terminated", G_CALLBACK(on_web_process_terminated), win);
+    g_signal_connect(web_view, "load-changed", G_CALLBACK(on_load_changed), win);
+    g_signal_connect(web_view, "load-failed", G_CALLBACK(on_load_failed), win);
+
+    return web_view;
+}
+
+// A hidden window's web view is unmapped: WebKit then reports document.visibilityState as
+// "hidden", stops requestAnimationFrame, throttles timers and stops painting. Mapping it again
+// resumes the page on the next frame.
+static void hb_window_set_hidden(HbWindow* win, gboolean hidden)
+{
+    if (win->hidden == hidden) return;
+    win->hidden = hidden;
+    if (win->web_view) gtk_widget_set_visible(win->web_view, !hidden);
+}
+
+static void on_toplevel_state_changed(GdkToplevel* toplevel, GParamSpec* pspec, gpointer user_data)
+{
+    HbWindow* win = hb_window_from_widget(GTK_WIDGET(user_data));
+    if (!win || !win->cfg.throttle_when_hidden) return;
+    GdkToplevelState state = gdk_toplevel_get_state(toplevel);
+
+    GdkToplevelState hidden_mask = GDK_TOPLEVEL_STATE_MINIMIZED;
+#if GTK_CHECK_VERSION(4, 12, 0)
+    // Set by compositors that report occlusion (e.g. xdg_toplevel "suspended" on Wayland)
+    hidden_mask |= GDK_TOPLEVEL_STATE_SUSPENDED;
+#endif
+    hb_window_set_hidden(win, (state & hidden_mask) != 0);
+}
+
+static void on_after_paint(GdkFrameClock* clock, gpointer user_data)
+{
+    HbWindow* win = hb_window_from_widget(GTK_WIDGET(user_data));
+    if (!win) return;
+    if (win->frame_stats)
+    {
+        hb_frame_stats_add(win->frame_stats, gdk_frame_clock_get_frame_time(clock));
+    }
+    if (win->awaiting_first_paint)
+    {
+        win->awaiting_first_paint = FALSE;
+        hb_trace_span(win->trace_track, "first_paint", win->load_started_us);
+    }
+}
+
+static gboolean on_fps_report(gpointer user_data)
+{
+    HbWindow* win = user_data;
+    gdouble fps = hb_frame_stats_fps(win->frame_stats, g_get_monotonic_time(),
+                                     HB_FPS_REPORT_INTERVAL * G_USEC_PER_SEC);
+    if (win->cfg.max_fps > 0)
+    {
+        g_message("fps: window '%s' %.1f fps (max_fps %u)", win->cfg.title, fps, win->cfg.max_fps);
+    }
+    else
+    {
+        g_message("fps: window '%s' %.1f fps", win->cfg.title, fps);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// Count presented frames (and spot the first paint for the trace) from the window's frame clock
+static void hb_window_connect_frame_clock(HbWindow* win)
+{
+    GdkFrameClock* clock = gtk_widget_get_frame_clock(GTK_WIDGET(win->window));
+    if (!clock) return; // connected on realize
+    if (g_signal_handler_find(clock, G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA, 0, 0, NULL, on_after_paint,
+                              win->window))
+    {
+        return;
+    }
+    // Bound to the window's lifetime: the frame clock may outlive the HbWindow
+    g_signal_connect_object(clock, "after-paint", G_CALLBACK(on_after_paint), win->window, 0);
+}
+
+void hb_window_watch_frames(HbWindow* win, gboolean enabled)
+{
+    if (!win) return;
+    if (enabled)
+    {
+        if (!win->frame_stats) win->frame_stats = g_new0(HbFrameStats, 1);
+        hb_window_connect_frame_clock(win);
+    }
+    else if (!hb_fps_reporting)
+    {
+        g_clear_pointer(&win->frame_stats, g_free);
+    }
+}
+
+void hb_window_set_content(HbWindow* win, GtkWidget* content)
+{
+    if (!win) return;
+    if (win->perf_overlay)
+    {
+        gtk_overlay_set_child(GTK_OVERLAY(win->perf_overlay), content);
+    }
+    else
+    {
+        gtk_window_set_child(win->window, content);
+    }
+}
+
+static void on_window_realize(GtkWidget* widget, gpointer user_data)
+{
+    HbWindow* win = user_data;
+
+    // Bound to the window's lifetime: the surface may outlive the HbWindow
+    GdkSurface* surface = gtk_native_get_surface(GTK_NATIVE(widget));
+    if (surface && GDK_IS_TOPLEVEL(surface))
+    {
+        g_signal_connect_object(surface, "notify::state", G_CALLBACK(on_toplevel_state_changed), widget, 0);
+    }
+
+    if (win->frame_stats || hb_trace_is_enabled())
+    {
+        hb_window_connect_frame_clock(win);
+    }
+}
+
+static void on_window_unmap(GtkWidget* widget, gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (!win->cfg.throttle_when_hidden) return;
+    hb_window_set_hidden(win, TRUE);
+}
+
+static void on_window_map(GtkWidget* widget, gpointer user_data)
+{
+    HbWindow* win = user_data;
+    if (!win->cfg.throttle_when_hidden) return;
+    GdkSurface* surface = gtk_native_get_surface(GTK_NATIVE(widget));
+    gboolean minimized = surface && GDK_IS_TOPLEVEL(surface) &&
+        (gdk_toplevel_get_state(GDK_TOPLEVEL(surface)) & GDK_TOPLEVEL_STATE_MINIMIZED);
+    hb_window_set_hidden(win, minimized);
+}
+
+void hb_window_recycle(HbWindow* win, const gchar* reason)
+{
+    if (!win) return;
+
+    win->recycle_count++;
+    g_message("Recycling view of window '%s' (%s, #%u)", win->cfg.title, reason ? reason : "requested",
+              win->recycle_count);
+
+    hb_freeze_thaw(win);
+    GtkWidget* old_view = win->web_view;
+    g_signal_handlers_disconnect_by_data(old_view, win);
+    g_signal_handlers_disconnect_by_data(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(old_view)), win);
+    win->push_subscribed = FALSE;
+    // Rebuilt with the current settings by hb_window_load()
+    hb_carousel_drop_preload(win);
+
+    win->web_view = hb_window_build_view(win);
+    gtk_widget_set_visible(win->web_view, !win->hidden);
+    if (!win->load_deferred) hb_window_load(win);
+
+    // Replacing the child destroys the old view and releases its share of the web process
+    hb_window_set_content(win, win->web_view);
+}
+
+static gboolean on_recycle_interval(gpointer user_data)
+{
+    hb_window_recycle(user_data, "recycle interval");
+    return G_SOURCE_CONTINUE;
+}
+
+static void hb_window_schedule_recycle(HbWindow* win)
+{
+    g_clear_handle_id(&win->recycle_source, g_source_remove);
+    if (win->cfg.recycle_interval > 0)
+    {
+        win->recycle_source = g_timeout_add_seconds(win->cfg.recycle_interval, on_recycle_interval, win);
+    }
+}
+
+// Properties of the GtkWindow itself that can change at any time
+static void hb_window_apply_window_props(HbWindow* win)
+{
+    const HbWindowCfg* cfg = &win->cfg;
+    GtkWidget* window = GTK_WIDGET(win->window);
+
+    gtk_window_set_title(win->window, cfg->title);
+    gtk_window_set_default_size(win->window, cfg->width, cfg->height);
 
     // Clamp and apply opacity
     gdouble opacity = cfg->opacity;
@@ -35,45 +649,190 @@ void hb_create_window(GtkApplication* app, const HbWindowCfg* cfg)
     if (opacity > 1.0) opacity = 1.0;
     gtk_widget_set_opacity(window, opacity);
 
-    // WebView (conditionally make page/window transparent based on config)
-    GtkWidget* web_view = webkit_web_view_new();
-
+    // Mark the GTK window as transparent via CSS class
     if (cfg->transparent)
     {
-        // Mark the GTK window as transparent via CSS class
         gtk_widget_add_css_class(window, "hb-transparent");
+    }
+    else
+    {
+        gtk_widget_remove_css_class(window, "hb-transparent");
+    }
 
-        // Force page background to be transparent
-        const char* css_page_transparent =
-            "html, body {\n"
-            "  background: transparent !important;\n"
-            "  background-color: transparent !important;\n"
-            "}\n";
-        WebKitUserStyleSheet* sheet = webkit_user_style_sheet_new(
-            css_page_transparent,
-            WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
-            WEBKIT_USER_STYLE_LEVEL_USER,
-            NULL, NULL);
-        WebKitUserContentManager* ucm = webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(web_view));
-        webkit_user_content_manager_add_style_sheet(ucm, sheet);
-        g_object_unref(sheet);
+    if (win->drag)
+    {
+        gtk_event_controller_set_propagation_phase(win->drag, cfg->locked ? GTK_PHASE_NONE : GTK_PHASE_BUBBLE);
+    }
+    if (!cfg->throttle_when_hidden)
+    {
+        hb_window_set_hidden(win, FALSE);
+    }
+}
 
-        // Transparent WebView surface to let window show through
-        GdkRGBA transparent = (GdkRGBA){0, 0, 0, 0};
-        webkit_web_view_set_background_color(WEBKIT_WEB_VIEW(web_view), &transparent);
+void hb_window_apply_cfg(HbWindow* win, const HbWindowCfg* cfg)
+{
+    if (!win || !cfg) return;
+
+    HbCfgChange changes = hb_window_cfg_diff(&win->cfg, cfg);
+    if (changes == HB_CFG_CHANGE_NONE) return;
+
+    hb_window_cfg_clear(&win->cfg);
+    hb_window_cfg_copy(cfg, &win->cfg);
+
+    if (changes & (HB_CFG_CHANGE_WINDOW | HB_CFG_CHANGE_VIEW))
+    {
+        hb_window_apply_window_props(win);
+        hb_perf_update(win);
+    }
+    if (changes & HB_CFG_CHANGE_SCHEDULE)
+    {
+        hb_window_schedule_recycle(win);
+        hb_refresh_schedule(win);
+        hb_freeze_schedule(win);
+        hb_carousel_schedule(win);
+    }
+    if (changes & HB_CFG_CHANGE_ADDRESS)
+    {
+        win->carousel_index = 0;
+    }
+
+    if (changes & HB_CFG_CHANGE_VIEW)
+    {
+        // Rebuilding also loads the (possibly new) address
+        hb_window_recycle(win, "configuration changed");
+    }
+    else if ((changes & HB_CFG_CHANGE_ADDRESS) && !win->load_deferred)
+    {
+        hb_window_load(win);
+    }
+}
+
+// Go back to the saved history entry instead of loading the address. FALSE if there's nothing
+// (usable) to restore; the saved state is used once either way.
+static gboolean hb_window_restore_session(HbWindow* win)
+{
+    HbSessionEntry* entry = win->session;
+    win->session = NULL;
+    gboolean restored = FALSE;
+    if (entry->state && g_strcmp0(entry->address, win->cfg.address) == 0)
+    {
+        WebKitWebView* view = WEBKIT_WEB_VIEW(win->web_view);
+        WebKitWebViewSessionState* state = webkit_web_view_session_state_new(entry->state);
+        if (state)
+        {
+            webkit_web_view_restore_session_state(view, state);
+            webkit_web_view_session_state_unref(state);
+            WebKitBackForwardListItem* item =
+                webkit_back_forward_list_get_current_item(webkit_web_view_get_back_forward_list(view));
+            if (item)
+            {
+                webkit_web_view_go_to_back_forward_list_item(view, item);
+                restored = TRUE;
+            }
+        }
+    }
+    hb_session_entry_free(entry);
+    return restored;
+}
+
+void hb_window_load(HbWindow* win)
+{
+    if (!win || !win->web_view) return;
+    win->load_deferred = FALSE;
+    if (win->cfg.addresses)
+    {
+        // Saved history belongs to whichever page was shown; a carousel starts from its first page
+        g_clear_pointer(&win->session, hb_session_entry_free);
+        hb_carousel_load(win);
+        return;
+    }
+    if (win->session && hb_window_restore_session(win)) return;
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(win->web_view), win->cfg.address);
+}
+
+void hb_window_save_session(HbWindow* win)
+{
+    // A window that hasn't restored yet would overwrite its saved state with an empty one
+    if (!win || !hb_window_session || win->session) return;
+    if (win->cfg.ephemeral)
+    {
+        // Nothing about an ephemeral window goes to disk, nor stays there from before
+        hb_session_remove(hb_window_session, win->cfg.title);
+        return;
+    }
+
+    HbSessionEntry entry = {0};
+    entry.address = win->cfg.address;
+    WebKitWebViewSessionState* state = webkit_web_view_get_session_state(WEBKIT_WEB_VIEW(win->web_view));
+    entry.state = webkit_web_view_session_state_serialize(state);
+    webkit_web_view_session_state_unref(state);
+    if (gtk_widget_get_mapped(GTK_WIDGET(win->window)))
+    {
+        entry.width = gtk_widget_get_width(GTK_WIDGET(win->window));
+        entry.height = gtk_widget_get_height(GTK_WIDGET(win->window));
+    }
+    else
+    {
+        gtk_window_get_default_size(win->window, &entry.width, &entry.height);
     }
+    entry.cfg_width = win->cfg.width;
+    entry.cfg_height = win->cfg.height;
+    hb_session_set(hb_window_session, win->cfg.title, &entry);
+    g_bytes_unref(entry.state);
+}
+
+HbWindow* hb_create_window(GtkApplication* app, const HbWindowCfg* cfg)
+{
+    return hb_create_window_full(app, cfg, TRUE);
+}
+
+HbWindow* hb_create_window_full(GtkApplication* app, const HbWindowCfg* cfg, gboolean load)
+{
+    gint64 t_create = hb_trace_now();
+    GtkWidget* window = gtk_application_window_new(app);
+
+    HbWindow* win = g_new0(HbWindow, 1);
+    win->window = GTK_WINDOW(window);
+    win->id = hb_window_next_id++;
+    win->trace_track = hb_trace_new_track(cfg->title);
+    hb_window_cfg_copy(cfg, &win->cfg);
+    g_object_set_data_full(G_OBJECT(window), "hb-window", win, hb_window_free);
 
-    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(web_view), cfg->address);
+    gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
+    gtk_window_set_resizable(GTK_WINDOW(window), TRUE);
+    hb_window_apply_window_props(win);
+
+    // A size the user gave the window last time wins over the configured one, unless that changed.
+    // Ephemeral windows start fresh, like their website data
+    win->session = cfg->ephemeral ? NULL : hb_session_lookup(hb_window_session, cfg->title);
+    if (win->session && win->session->cfg_width == cfg->width && win->session->cfg_height == cfg->height &&
+        win->session->width > 0 && win->session->height > 0)
+    {
+        gtk_window_set_default_size(GTK_WINDOW(window), win->session->width, win->session->height);
+    }
+
+    win->web_view = hb_window_build_view(win);
+    win->load_deferred = !load;
+    if (load) hb_window_load(win);
 
-    if (!cfg->locked)
+    hb_window_schedule_recycle(win);
+    hb_refresh_schedule(win);
+    hb_freeze_schedule(win);
+    hb_carousel_schedule(win);
+
+    if (hb_fps_reporting)
     {
-        GtkGesture* drag = gtk_gesture_click_new();
-        gtk_event_controller_set_propagation_phase(GTK_EVENT_CONTROLLER(drag), GTK_PHASE_BUBBLE);
-        gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(drag), GDK_BUTTON_PRIMARY);
-        g_signal_connect(drag, "pressed", G_CALLBACK(on_drag_begin), window);
-        gtk_widget_add_controller(web_view, GTK_EVENT_CONTROLLER(drag));
+        hb_window_watch_frames(win, TRUE);
+        win->fps_report_source = g_timeout_add_seconds(HB_FPS_REPORT_INTERVAL, on_fps_report, win);
     }
 
-    gtk_window_set_child(GTK_WINDOW(window), web_view);
+    g_signal_connect(window, "realize", G_CALLBACK(on_window_realize), win);
+    g_signal_connect(window, "map", G_CALLBACK(on_window_map), win);
+    g_signal_connect(window, "unmap", G_CALLBACK(on_window_unmap), win);
+
+    hb_window_set_content(win, win->web_view);
+    hb_perf_update(win);
     gtk_window_present(GTK_WINDOW(window));
+    hb_trace_span(win->trace_track, "create_window", t_create);
+    return win;
 }
@@ -3,8 +3,118 @@
 
 #include <gtk/gtk.h>
 #include "hb_config.h"
+#include "hb_fps.h"
+#include "hb_wheel.h"
+#include "hb_session.h"
+
+typedef struct HbWindow HbWindow;
+
+// Called once per registration: when the window's first load finishes (finished = TRUE), or when
+// the window goes away before that (finished = FALSE).
+typedef void (*HbWindowLoadFunc)(HbWindow* win, gboolean finished, gpointer user_data);
+
+// Per-window runtime state. Owned by the GtkWindow and freed when it is destroyed.
+struct HbWindow
+{
+    GtkWindow* window;
+    GtkWidget* web_view;
+    GtkEventController* drag; // drag-to-move gesture on the web view; idle while locked
+    HbWindowCfg cfg; // private copy of the configuration the window was created from
+    guint recycle_source; // periodic recycle timer (recycle_interval)
+    guint recycle_idle;   // pending recycle after the web process went away
+    guint recycle_count;
+    gboolean hidden; // minimized/occluded: the web view is unmapped so WebKit throttles the page
+    HbFrameStats* frame_stats; // presented frames; only allocated while frame-rate reporting is on
+    guint fps_report_source;
+    HbWindowLoadFunc load_done_func;
+    gpointer load_done_data;
+    gboolean load_deferred;        // created without loading; the address waits for hb_window_load()
+    guint trace_track;             // per-window track in the --trace output
+    gint64 load_started_us;        // monotonic time the current load started
+    gboolean awaiting_first_paint; // load committed, no frame presented yet
+    GQueue push_pending;      // pushed JSON payloads (gchar*) not yet delivered to the page
+    guint push_tick;          // tick callback flushing push_pending on the next frame
+    gboolean push_subscribed; // the current page called hudbox.subscribe()
+    HbWheelTimer* refresh_timer;  // next refresh_interval check (see hb_refresh.h)
+    GCancellable* refresh_check;  // conditional request in flight
+    gchar* refresh_etag;          // validators of the last loaded page
+    gchar* refresh_last_modified;
+    guint freeze_source;           // next freeze_after idle check (see hb_freeze.h)
+    gint64 last_activity_us;       // last input, page load or push
+    GCancellable* freeze_snapshot; // snapshot in flight
+    GtkWidget* frozen;             // snapshot shown in place of the web view; NULL while live
+    gboolean freeze_watching;      // input controllers installed
+    GtkWidget* carousel_next;           // carousel: view preloading the next page (owned, not in the window)
+    GtkEventController* carousel_drag;  // its drag gesture
+    guint carousel_index;               // index in cfg.addresses of the page shown
+    guint carousel_source;              // next page change (see hb_carousel.h)
+    gboolean carousel_ready;            // the next page finished loading
+    gboolean carousel_due;              // dwell elapsed while it was still loading
+    GtkWidget* perf_overlay; // GtkOverlay between the window and its content; NULL without the performance overlay
+    GtkWidget* perf_label;   // statistics shown over the page (see hb_perf.h)
+    guint perf_source;       // next overlay refresh
+    gint perf_resources;     // resources loaded by the current page; -1 = not counted yet
+    HbSessionEntry* session; // saved state to restore on the first load; NULL once used
+    guint id;                // unique per process, in creation order
+    guint load_count;        // page loads finished (including failed ones)
+    guint load_failures;     // loads that ended in "load-failed"
+    gint64 last_load_us;     // duration of the last finished load; 0 = none yet
+    guint blocked_requests;  // subresources that failed to load while content filters are active
+};
 
 // Create and present a window according to the given configuration.
-void hb_create_window(GtkApplication* app, const HbWindowCfg* cfg);
+HbWindow* hb_create_window(GtkApplication* app, const HbWindowCfg* cfg);
+
+// Like hb_create_window(), but only starts loading the address when load is TRUE; otherwise the
+// window stays blank until hb_window_load() is called (config changes applied meanwhile don't
+// load it either).
+HbWindow* hb_create_window_full(GtkApplication* app, const HbWindowCfg* cfg, gboolean load);
+
+// Start loading the configured address.
+void hb_window_load(HbWindow* win);
+
+// Reconfigure a running window. Window properties are updated in place; the page is reloaded only
+// when the address changed, and the view is rebuilt only for settings baked into it.
+void hb_window_apply_cfg(HbWindow* win, const HbWindowCfg* cfg);
+
+// Register func to be told when the window's next load finishes (see HbWindowLoadFunc).
+void hb_window_set_load_done_func(HbWindow* win, HbWindowLoadFunc func, gpointer user_data);
+
+// Return the HbWindow attached to a window created by hb_create_window(), or NULL.
+HbWindow* hb_window_from_widget(GtkWidget* widget);
+
+// Log every window's effective frame rate periodically (windows created after this call).
+void hb_window_set_fps_reporting(gboolean enabled);
+
+// Record the window's presented frames in frame_stats (enabled), or stop unless frame-rate
+// reporting needs them.
+void hb_window_watch_frames(HbWindow* win, gboolean enabled);
+
+// Make content (the web view or a snapshot standing in for it) what the window shows.
+void hb_window_set_content(HbWindow* win, GtkWidget* content);
+
+// Expose the hudbox.subscribe() push API to pages of windows created after this call.
+void hb_window_set_push_enabled(gboolean enabled);
+
+// Queue a JSON payload for the page's hudbox.subscribe() listeners. Payloads are delivered in
+// one batch per frame once the page has subscribed; while nobody listens (or the window isn't
+// drawing) only the most recent ones are kept.
+void hb_window_push(HbWindow* win, const gchar* payload);
+
+// Restore saved state (window size now, page history and position on the first load) for windows
+// created after this call, from entries matching their title. NULL stops restoring. Not owned.
+void hb_window_set_session(HbSession* session);
+
+// Record the window's page history and position and its size in the session set with
+// hb_window_set_session() (in memory; see hb_session_save()).
+void hb_window_save_session(HbWindow* win);
+
+// Build a configured web view for the window, with its signal handlers, without loading or
+// showing it; win->drag is set to its drag gesture.
+GtkWidget* hb_window_build_view(HbWindow* win);
+
+// Replace the window's web view with a fresh one (new web process when the process model allows)
+// and reload the configured address. The GtkWindow, its geometry and settings are kept.
+void hb_window_recycle(HbWindow* win, const gchar* reason);
 
 #endif // HB_WINDOW_H
@@ -1,62 +1,330 @@
 #include <gtk/gtk.h>
 #include <glib.h>
+#include <glib-unix.h>
+#include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "hb_css.h"
 #include "hb_config.h"
 #include "hb_window.h"
+#include "hb_perf.h"
+#include "hb_web.h"
+#include "hb_proc.h"
+#include "hb_startup.h"
+#include "hb_trace.h"
+#include "hb_reload.h"
+#include "hb_push.h"
+#include "hb_metrics.h"
+#include "hb_remote.h"
+#include "hb_session.h"
 
 #ifndef HUDBOX_VERSION
 #define HUDBOX_VERSION "0.0.0"
 #endif
 
-static void activate(GtkApplication* app, gpointer user_data)
+// Saved window sessions not updated for this long are dropped
+#define HB_SESSION_MAX_AGE_S (30 * 24 * 60 * 60)
+
+// Time main() handed control to GApplication, for the gtk_init trace span
+static gint64 hb_run_started_us = 0;
+
+// SIGTERM/SIGINT (service stop, reboot, Ctrl+C): quit through the main loop so that shutdown
+// work (session save, trace file) still happens
+static gboolean on_quit_signal(gpointer user_data)
 {
-    // Ensure GTK toplevel backgrounds are fully transparent via CSS
-    hb_install_transparent_css();
+    g_application_quit(G_APPLICATION(user_data));
+    return G_SOURCE_CONTINUE;
+}
 
-    // If a config path was supplied on the command line, it is stored on the app object
-    const gchar* cmd_cfg_path = (const gchar*)g_object_get_data(G_OBJECT(app), "hb-config-path");
+static void on_startup(GApplication* gapp, gpointer user_data)
+{
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "gtk_init", hb_run_started_us);
+    hb_remote_install(GTK_APPLICATION(gapp));
+    g_unix_signal_add(SIGTERM, on_quit_signal, gapp);
+    g_unix_signal_add(SIGINT, on_quit_signal, gapp);
+}
 
-    GPtrArray* cfgs = NULL;
+// Route a pushed message to its window (by title), or to every window
+static void on_push_message(const gchar* window, const gchar* payload, gpointer user_data)
+{
+    GtkApplication* app = GTK_APPLICATION(user_data);
+    for (GList* l = gtk_application_get_windows(app); l; l = l->next)
+    {
+        HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+        if (win && (!window || g_strcmp0(win->cfg.title, window) == 0)) hb_window_push(win, payload);
+    }
+}
 
-    if (cmd_cfg_path && *cmd_cfg_path)
+static void hb_start_push_server(GtkApplication* app, const gchar* path)
+{
+    GError* error = NULL;
+    HbPushServer* server = hb_push_server_new(path, on_push_message, app, &error);
+    if (!server)
     {
-        // Load ONLY from the provided path; do not create a default file here
-        cfgs = hb_load_configs_from_json(cmd_cfg_path);
+        g_warning("Cannot listen for push messages on %s: %s", path, error->message);
+        g_error_free(error);
+        return;
     }
-    else
+    hb_window_set_push_enabled(TRUE);
+    g_object_set_data_full(G_OBJECT(app), "hb-push-server", server, (GDestroyNotify)hb_push_server_free);
+}
+
+static void on_metrics_collect(GString* out, gpointer user_data)
+{
+    GtkApplication* app = GTK_APPLICATION(user_data);
+    GList* windows = gtk_application_get_windows(app);
+
+    static const struct
+    {
+        const gchar* name;
+        const gchar* type;
+        const gchar* help;
+    } window_metrics[] = {
+        {"hudbox_window_info", "gauge", "Window and the URI it currently shows (always 1)."},
+        {"hudbox_window_loads_total", "counter", "Page loads finished, including failed ones."},
+        {"hudbox_window_load_failures_total", "counter", "Page loads that failed."},
+        {"hudbox_window_last_load_duration_seconds", "gauge", "Duration of the last finished page load."},
+        {"hudbox_window_recycles_total", "counter", "Times the window's web view was replaced."},
+        {"hudbox_window_blocked_requests_total", "counter",
+         "Approximation of requests blocked by content filters: failed subresource, fetch and XHR loads."},
+    };
+    // One family at a time, as the exposition format expects
+    for (guint m = 0; m < G_N_ELEMENTS(window_metrics); m++)
     {
-        // Try to load ~/.hudbox.json (create a default one if it doesn't exist)
-        const gchar* home = g_get_home_dir();
-        gchar* path = home ? g_build_filename(home, ".hudbox.json", NULL) : NULL;
-        if (path)
+        hb_metrics_append_header(out, window_metrics[m].name, window_metrics[m].type, window_metrics[m].help);
+        for (GList* l = windows; l; l = l->next)
         {
-            hb_ensure_default_config_exists(path);
-            cfgs = hb_load_configs_from_json(path);
-            g_free(path);
+            HbWindow* win = hb_window_from_widget(GTK_WIDGET(l->data));
+            if (!win) continue;
+            gchar id[16];
+            g_snprintf(id, sizeof(id), "%u", win->id);
+            const gchar* uri = win->web_view ? webkit_web_view_get_uri(WEBKIT_WEB_VIEW(win->web_view)) : NULL;
+            const gchar* labels[] = {"id", id, "window", win->cfg.title, m == 0 ? "uri" : NULL, uri ? uri : "", NULL};
+            gdouble values[] = {1, win->load_count, win->load_failures, win->last_load_us / 1e6, win->recycle_count,
+                                 win->blocked_requests};
+            hb_metrics_append_sample(out, window_metrics[m].name, labels, values[m]);
         }
     }
 
-    if (cfgs && cfgs->len > 0)
+    // Web, network and helper processes started by WebKit
+    GPtrArray* procs = hb_proc_list_descendants();
+    hb_metrics_append_header(out, "hudbox_process_resident_memory_bytes", "gauge",
+                             "Resident memory of each process HudBox spawned.");
+    for (guint i = 0; i < procs->len; i++)
     {
-        for (guint i = 0; i < cfgs->len; i++)
-        {
-            HbWindowCfg* cfg = (HbWindowCfg*)g_ptr_array_index(cfgs, i);
-            hb_create_window(app, cfg);
-            hb_window_cfg_clear(cfg);
-            // free container struct itself; strings already cleared
-            // freed by array free func, but we already clear strings to avoid leaks
-        }
-        g_ptr_array_free(cfgs, TRUE);
+        HbProcInfo* info = g_ptr_array_index(procs, i);
+        gchar pid[16];
+        g_snprintf(pid, sizeof(pid), "%d", info->pid);
+        const gchar* labels[] = {"pid", pid, "name", info->name, NULL};
+        hb_metrics_append_sample(out, "hudbox_process_resident_memory_bytes", labels, info->rss_kb * 1024.0);
+    }
+    hb_metrics_append_header(out, "hudbox_process_cpu_seconds_total", "counter",
+                             "User and system CPU time of each process HudBox spawned.");
+    for (guint i = 0; i < procs->len; i++)
+    {
+        HbProcInfo* info = g_ptr_array_index(procs, i);
+        if (!hb_proc_read_cpu(info)) continue;
+        gchar pid[16];
+        g_snprintf(pid, sizeof(pid), "%d", info->pid);
+        const gchar* labels[] = {"pid", pid, "name", info->name, NULL};
+        hb_metrics_append_sample(out, "hudbox_process_cpu_seconds_total", labels, info->cpu_seconds);
+    }
+    g_ptr_array_free(procs, TRUE);
+
+    // hbcache:// requests of every window
+    HbFetchStats fetch;
+    hb_web_get_fetch_stats(&fetch);
+    static const struct
+    {
+        const gchar* name;
+        const gchar* type;
+        const gchar* help;
+    } fetch_metrics[] = {
+        {"hudbox_shared_cache_hits_total", "counter", "hbcache:// requests answered from the cache."},
+        {"hudbox_shared_cache_misses_total", "counter", "hbcache:// requests fetched upstream."},
+        {"hudbox_shared_cache_coalesced_total", "counter", "hbcache:// requests that joined a fetch already in flight."},
+        {"hudbox_shared_cache_entries", "gauge", "Responses in the cache."},
+        {"hudbox_shared_cache_bytes", "gauge", "Size of the cached response bodies."},
+    };
+    gdouble fetch_values[] = {fetch.hits, fetch.misses, fetch.coalesced, fetch.entries, fetch.bytes};
+    for (guint m = 0; m < G_N_ELEMENTS(fetch_metrics); m++)
+    {
+        hb_metrics_append_header(out, fetch_metrics[m].name, fetch_metrics[m].type, fetch_metrics[m].help);
+        hb_metrics_append_sample(out, fetch_metrics[m].name, NULL, fetch_values[m]);
+    }
+
+    hb_metrics_append_latency(out);
+}
+
+static void hb_start_metrics_server(GtkApplication* app, const gchar* socket_path, guint port)
+{
+    GError* error = NULL;
+    HbMetricsServer* server = hb_metrics_server_new(socket_path, port, on_metrics_collect, app, &error);
+    if (!server)
+    {
+        g_warning("Cannot serve metrics: %s", error->message);
+        g_error_free(error);
         return;
     }
+    hb_metrics_start_latency_probe();
+    g_object_set_data_full(G_OBJECT(app), "hb-metrics-server", server, (GDestroyNotify)hb_metrics_server_free);
+}
 
-    // Fallback: single default window if no config present/parsed
-    HbWindowCfg def;
-    hb_window_cfg_init_defaults(&def);
-    hb_create_window(app, &def);
-    hb_window_cfg_clear(&def);
+// Record every open window and write the session file
+static void hb_save_session(GtkApplication* app)
+{
+    HbSession* session = g_object_get_data(G_OBJECT(app), "hb-session");
+    if (!session) return;
+    for (GList* l = gtk_application_get_windows(app); l; l = l->next)
+    {
+        hb_window_save_session(hb_window_from_widget(GTK_WIDGET(l->data)));
+    }
+    GError* error = NULL;
+    if (!hb_session_save(session, HB_SESSION_MAX_AGE_S, &error))
+    {
+        g_warning("Cannot save session: %s", error->message);
+        g_error_free(error);
+    }
+}
+
+static gboolean on_session_autosave(gpointer user_data)
+{
+    hb_save_session(GTK_APPLICATION(user_data));
+    return G_SOURCE_CONTINUE;
+}
+
+// Closing the last window quits: remember each window as it goes
+static void on_session_window_removed(GtkApplication* app, GtkWindow* window, gpointer user_data)
+{
+    hb_window_save_session(hb_window_from_widget(GTK_WIDGET(window)));
+}
+
+static void on_session_shutdown(GApplication* gapp, gpointer user_data)
+{
+    hb_save_session(GTK_APPLICATION(gapp));
+}
+
+static void hb_start_session(GtkApplication* app, const HbAppCfg* app_cfg)
+{
+    gchar* data_dir = hb_app_cfg_get_data_dir(app_cfg);
+    gchar* path = g_build_filename(data_dir, "session.ini", NULL);
+    HbSession* session = hb_session_load(path);
+    g_free(path);
+    g_free(data_dir);
+
+    hb_window_set_session(session);
+    g_object_set_data_full(G_OBJECT(app), "hb-session", session, (GDestroyNotify)hb_session_free);
+    g_signal_connect(app, "window-removed", G_CALLBACK(on_session_window_removed), NULL);
+    g_signal_connect(app, "shutdown", G_CALLBACK(on_session_shutdown), NULL);
+    if (app_cfg->session_save_interval > 0)
+    {
+        g_timeout_add_seconds(app_cfg->session_save_interval, on_session_autosave, app);
+    }
+}
+
+typedef struct
+{
+    GtkApplication* app;
+    gchar* path;
+    gint64 started_us;
+} HbActivation;
+
+// Second half of startup, once the config has been read and parsed off the main thread
+static void on_configs_loaded(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    HbActivation* activation = user_data;
+    GtkApplication* app = activation->app;
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "config_load", activation->started_us);
+
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    GError* error = NULL;
+    HbConfigSet* set = hb_load_configs_finish(result, &app_cfg, &error);
+    if (!set)
+    {
+        g_warning("Cannot load config: %s", error->message);
+        g_error_free(error);
+    }
+    hb_config_set_log_errors(set, activation->path);
+    hb_reload_watch(app, activation->path);
+
+    // One web context and network session for every window; process model from config
+    hb_web_init(&app_cfg);
+    // Host lookups run while the servers start and windows are being built
+    hb_web_prefetch_dns(set);
+
+    // Before any window exists: views only get the push API when the server is up
+    if (app_cfg.push_socket && !g_object_get_data(G_OBJECT(app), "hb-push-server"))
+    {
+        hb_start_push_server(app, app_cfg.push_socket);
+    }
+    if ((app_cfg.metrics_socket || app_cfg.metrics_port > 0) &&
+        !g_object_get_data(G_OBJECT(app), "hb-metrics-server"))
+    {
+        hb_start_metrics_server(app, app_cfg.metrics_socket, app_cfg.metrics_port);
+    }
+    // Before any window exists: saved sizes and pages are picked up as windows are created
+    if (app_cfg.restore_session && !g_object_get_data(G_OBJECT(app), "hb-session"))
+    {
+        hb_start_session(app, &app_cfg);
+    }
+
+    guint max_concurrent_loads = app_cfg.max_concurrent_loads;
+    hb_app_cfg_clear(&app_cfg);
+
+    if (set)
+    {
+        // Highest priority first; the rest follow in idle slices with bounded concurrent loads
+        hb_startup_run(app, set, max_concurrent_loads);
+    }
+    else
+    {
+        // Fallback: single default window if no config present/parsed
+        HbWindowCfg def;
+        hb_window_cfg_init_defaults(&def);
+        hb_create_window(app, &def);
+        hb_window_cfg_clear(&def);
+    }
+
+    // Windows now keep the application running
+    g_application_release(G_APPLICATION(app));
+    g_free(activation->path);
+    g_free(activation);
+}
+
+static void activate(GtkApplication* app, gpointer user_data)
+{
+    // Windows are created once per instance; later invocations use the remote-control actions
+    if (g_object_get_data(G_OBJECT(app), "hb-activated")) return;
+    g_object_set_data(G_OBJECT(app), "hb-activated", GINT_TO_POINTER(TRUE));
+
+    // If a config path was supplied on the command line, it is stored on the app object;
+    // otherwise use ~/.hudbox.json, creating a default one if it doesn't exist
+    const gchar* cmd_cfg_path = (const gchar*)g_object_get_data(G_OBJECT(app), "hb-config-path");
+    gboolean create_default = !(cmd_cfg_path && *cmd_cfg_path);
+    if (create_default)
+    {
+        // Current config for the reload-config action
+        g_object_set_data_full(G_OBJECT(app), "hb-config-path",
+                               g_build_filename(g_get_home_dir(), ".hudbox.json", NULL), g_free);
+    }
+
+    // Read and parse on a worker thread while this thread does the config-independent setup;
+    // the hold keeps the application alive until the windows exist
+    HbActivation* activation = g_new0(HbActivation, 1);
+    activation->app = app;
+    activation->path = g_strdup(g_object_get_data(G_OBJECT(app), "hb-config-path"));
+    activation->started_us = hb_trace_now();
+    g_application_hold(G_APPLICATION(app));
+    hb_load_configs_async(activation->path, create_default, NULL, on_configs_loaded, activation);
+
+    // Ensure GTK toplevel backgrounds are fully transparent via CSS
+    gint64 t_css = hb_trace_now();
+    hb_install_transparent_css();
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "install_transparent_css", t_css);
+
+    hb_web_prepare();
 }
 
 // Handle command-line arguments to accept an optional config path without triggering
@@ -68,6 +336,24 @@ static int on_command_line(GApplication* gapp, GApplicationCommandLine* cmdline,
     int argc = 0;
     char** argv = g_application_command_line_get_arguments(cmdline, &argc);
 
+    // --remote: everything after it is a command for the running instance
+    for (int i = 1; i < argc; i++)
+    {
+        if (g_strcmp0(argv[i], "--remote") != 0) continue;
+        int status;
+        if (g_object_get_data(G_OBJECT(app), "hb-activated"))
+        {
+            status = hb_remote_run(app, cmdline, argv + i + 1);
+        }
+        else
+        {
+            g_application_command_line_printerr(cmdline, "HudBox is not running\n");
+            status = 1;
+        }
+        g_strfreev(argv);
+        return status;
+    }
+
     // Handle --help/-h and --version: print info and exit without activating GUI
     for (int i = 1; i < argc; i++)
     {
@@ -75,16 +361,27 @@ static int on_command_line(GApplication* gapp, GApplicationCommandLine* cmdline,
         {
             const char* prog = (argc > 0 && argv[0]) ? argv[0] : "hudbox";
             g_print("HudBox %s\n", HUDBOX_VERSION);
-            g_print("Usage: %s [--help] [--version] [config.json]\n\n", prog);
+            g_print("Usage: %s [--help] [--version] [--memory-report[=SECONDS]] [--show-fps] [--perf-overlay]\n"
+                    "       [--trace=FILE] [config.json]\n"
+                    "       %s --remote COMMAND [ARGS]\n\n", prog, prog);
             g_print("Options:\n");
             g_print("  --help, -h     Show this help message and exit.\n");
-            g_print("  --version      Print the HudBox version and exit.\n\n");
+            g_print("  --version      Print the HudBox version and exit.\n");
+            g_print("  --memory-report[=SECONDS]\n");
+            g_print("                 Periodically log the RSS of every WebKit process (default: 10s).\n");
+            g_print("  --show-fps     Periodically log each window's effective frame rate.\n");
+            g_print("  --perf-overlay Show frame rate, load and memory statistics over every window.\n");
+            g_print("  --trace=FILE   Write a Chrome/Perfetto trace of startup and page loads to FILE on exit.\n");
+            g_print("  --remote COMMAND [ARGS]\n");
+            g_print("                 Control the running instance: list, open CONFIG, reload,\n");
+            g_print("                 reload-window TITLE, close TITLE, navigate TITLE URI.\n\n");
             g_print("Arguments:\n");
             g_print("  config.json    Path to a JSON config file. If omitted, HudBox uses ~/.hudbox.json\n");
             g_print("                 (creating a default file if it does not exist).\n\n");
             g_print("Examples:\n");
             g_print("  %s                # Use ~/.hudbox.json (create if missing)\n", prog);
             g_print("  %s myhud.json     # Load windows from myhud.json\n", prog);
+            g_print("  %s --remote navigate Notes https://example.com\n", prog);
             g_strfreev(argv);
             return 0;
         }
@@ -97,9 +394,64 @@ static int on_command_line(GApplication* gapp, GApplicationCommandLine* cmdline,
     }
 
     const char* cfg_path = NULL;
-    if (argc > 1 && argv[1] && argv[1][0] != '-')
+    for (int i = 1; i < argc; i++)
+    {
+        if (!argv[i]) continue;
+        if (g_strcmp0(argv[i], "--memory-report") == 0)
+        {
+            hb_proc_start_memory_report(10);
+        }
+        else if (g_str_has_prefix(argv[i], "--memory-report="))
+        {
+            guint64 secs = g_ascii_strtoull(argv[i] + strlen("--memory-report="), NULL, 10);
+            hb_proc_start_memory_report((guint)secs);
+        }
+        else if (g_str_has_prefix(argv[i], "--trace="))
+        {
+            // Opened in main() so that GTK initialization is captured
+        }
+        else if (g_strcmp0(argv[i], "--show-fps") == 0)
+        {
+            hb_window_set_fps_reporting(TRUE);
+        }
+        else if (g_strcmp0(argv[i], "--perf-overlay") == 0)
+        {
+            hb_perf_set_overlay_all(TRUE);
+        }
+        else if (argv[i][0] == '-')
+        {
+            g_printerr("Ignoring unknown option %s\n", argv[i]);
+        }
+        else if (!cfg_path)
+        {
+            cfg_path = argv[i];
+        }
+    }
+
+    if (g_object_get_data(G_OBJECT(app), "hb-activated"))
     {
-        cfg_path = argv[1];
+        // Another invocation while running: switch configs instead of duplicating every window
+        if (cfg_path)
+        {
+            GFile* file = g_application_command_line_create_file_for_arg(cmdline, cfg_path);
+            gchar* path = g_file_get_path(file);
+            g_object_unref(file);
+            // NULL for arguments that aren't local files (e.g. URIs)
+            if (!path)
+            {
+                g_application_command_line_printerr(cmdline, "Cannot open config %s: not a local file\n", cfg_path);
+                g_strfreev(argv);
+                return 1;
+            }
+            g_action_group_activate_action(G_ACTION_GROUP(app), "open-config", g_variant_new_string(path));
+            g_free(path);
+        }
+        else
+        {
+            g_application_command_line_printerr(cmdline, "HudBox is already running; see --remote\n");
+        }
+        g_strfreev(argv);
+        return 0;
     }
 
     if (cfg_path)
@@ -117,15 +469,27 @@ static int on_command_line(GApplication* gapp, GApplicationCommandLine* cmdline,
 
 int main(int argc, char** argv)
 {
+    // --trace must be known before GApplication runs startup (GTK init)
+    for (int i = 1; i < argc; i++)
+    {
+        if (argv[i] && g_str_has_prefix(argv[i], "--trace="))
+        {
+            hb_trace_open(argv[i] + strlen("--trace="));
+        }
+    }
+    hb_run_started_us = hb_trace_now();
+
     GtkApplication* app = gtk_application_new(
         "me.stegall.hudbox",
         G_APPLICATION_DEFAULT_FLAGS | G_APPLICATION_HANDLES_COMMAND_LINE);
 
     // Handle command-line to accept optional config path without triggering file-open errors
     g_signal_connect(app, "command-line", G_CALLBACK(on_command_line), NULL);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
 
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+    hb_trace_close();
     return status;
 }
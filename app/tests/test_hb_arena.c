@@ -0,0 +1,62 @@
+#include <glib.h>
+#include <string.h>
+#include "../src/hb_arena.h"
+
+static void test_alloc(void)
+{
+    HbArena* arena = hb_arena_new(256);
+
+    // Zeroed and aligned, across several blocks
+    for (guint i = 0; i < 100; i++)
+    {
+        guint8* p = hb_arena_alloc(arena, 1 + i % 13);
+        g_assert_nonnull(p);
+        g_assert_cmpuint(GPOINTER_TO_SIZE(p) % (2 * sizeof(gpointer)), ==, 0);
+        for (guint j = 0; j < 1 + i % 13; j++) g_assert_cmpuint(p[j], ==, 0);
+        memset(p, 0xff, 1 + i % 13);
+    }
+
+    // Larger than a block
+    guint8* big = hb_arena_alloc(arena, 4096);
+    g_assert_nonnull(big);
+    memset(big, 0xff, 4096);
+    g_assert_cmpuint(hb_arena_get_used(arena), >=, 4096 + 100);
+
+    gint* ints = hb_arena_new0(arena, gint, 4);
+    g_assert_cmpint(ints[3], ==, 0);
+
+    hb_arena_free(arena);
+}
+
+static void test_strings(void)
+{
+    HbArena* arena = hb_arena_new(0);
+
+    gchar* a = hb_arena_strdup(arena, "hello");
+    gchar* b = hb_arena_strdup(arena, "hello");
+    g_assert_cmpstr(a, ==, "hello");
+    g_assert_true(a != b);
+    g_assert_null(hb_arena_strdup(arena, NULL));
+
+    gchar* buf = g_strdup("title");
+    gchar* i1 = hb_arena_intern(arena, buf);
+    gchar* i2 = hb_arena_intern(arena, "title");
+    g_assert_true(i1 == i2);
+    g_assert_true(i1 != buf);
+    g_free(buf);
+    g_assert_cmpstr(i1, ==, "title");
+    g_assert_true(hb_arena_intern(arena, "other") != i1);
+    g_assert_null(hb_arena_intern(arena, NULL));
+
+    hb_arena_free(arena);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_arena/alloc", test_alloc);
+    g_test_add_func("/hb_arena/strings", test_strings);
+
+    return g_test_run();
+}
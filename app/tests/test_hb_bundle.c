@@ -0,0 +1,174 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/hb_bundle.h"
+
+static void test_resolve(void)
+{
+    gchar* p = hb_bundle_resolve("/srv", "status", "/index.html");
+    g_assert_cmpstr(p, ==, "/srv/status/index.html");
+    g_free(p);
+
+    p = hb_bundle_resolve("/srv", "status", "/");
+    g_assert_cmpstr(p, ==, "/srv/status/index.html");
+    g_free(p);
+
+    p = hb_bundle_resolve("/srv", "status", "");
+    g_assert_cmpstr(p, ==, "/srv/status/index.html");
+    g_free(p);
+
+    p = hb_bundle_resolve("/srv", "status", "/assets//./my%20app.js");
+    g_assert_cmpstr(p, ==, "/srv/status/assets/my app.js");
+    g_free(p);
+
+    // Anything that could leave the bundle directory is rejected
+    g_assert_null(hb_bundle_resolve("/srv", "status", "/../secret"));
+    g_assert_null(hb_bundle_resolve("/srv", "status", "/a/%2e%2e/%2E%2E/secret"));
+    g_assert_null(hb_bundle_resolve("/srv", "status", "/a%2Fb"));
+    g_assert_null(hb_bundle_resolve("/srv", "status", "/a%00b"));
+    g_assert_null(hb_bundle_resolve("/srv", "..", "/index.html"));
+    g_assert_null(hb_bundle_resolve("/srv", "", "/index.html"));
+    g_assert_null(hb_bundle_resolve("/srv", NULL, "/index.html"));
+}
+
+static void test_mime_type(void)
+{
+    g_assert_cmpstr(hb_bundle_mime_type("index.html"), ==, "text/html");
+    g_assert_cmpstr(hb_bundle_mime_type("/a/app.MJS"), ==, "text/javascript");
+    g_assert_cmpstr(hb_bundle_mime_type("style.css"), ==, "text/css");
+    g_assert_cmpstr(hb_bundle_mime_type("module.wasm"), ==, "application/wasm");
+    g_assert_cmpstr(hb_bundle_mime_type("font.woff2"), ==, "font/woff2");
+    g_assert_cmpstr(hb_bundle_mime_type("/a.d/README"), ==, "application/octet-stream");
+    g_assert_cmpstr(hb_bundle_mime_type(NULL), ==, "application/octet-stream");
+}
+
+static void test_read(void)
+{
+    gchar* root = g_dir_make_tmp("hb_bundle_test_XXXXXX", NULL);
+    g_assert_nonnull(root);
+    gchar* dir = g_build_filename(root, "status", "docs", NULL);
+    g_assert_cmpint(g_mkdir_with_parents(dir, 0700), ==, 0);
+    gchar* index = g_build_filename(root, "status", "index.html", NULL);
+    gchar* docs_index = g_build_filename(dir, "index.html", NULL);
+    g_assert_true(g_file_set_contents(index, "<p>hi</p>", -1, NULL));
+    g_assert_true(g_file_set_contents(docs_index, "docs", -1, NULL));
+
+    HbBundle* bundle = hb_bundle_new(root, 1024 * 1024);
+
+    const gchar* mime = NULL;
+    GError* error = NULL;
+    GBytes* a = hb_bundle_read(bundle, "status", "/", &mime, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(a);
+    g_assert_cmpstr(mime, ==, "text/html");
+    g_assert_cmpmem(g_bytes_get_data(a, NULL), g_bytes_get_size(a), "<p>hi</p>", 9);
+
+    // Unchanged files come from the cache
+    GBytes* b = hb_bundle_read(bundle, "status", "/index.html", NULL, NULL);
+    g_assert_true(g_bytes_get_data(a, NULL) == g_bytes_get_data(b, NULL));
+    g_bytes_unref(b);
+
+    // Directories serve their index.html
+    GBytes* d = hb_bundle_read(bundle, "status", "/docs", NULL, NULL);
+    g_assert_nonnull(d);
+    g_assert_cmpmem(g_bytes_get_data(d, NULL), g_bytes_get_size(d), "docs", 4);
+    g_bytes_unref(d);
+
+    g_assert_null(hb_bundle_read(bundle, "status", "/missing.js", NULL, &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+    g_clear_error(&error);
+    g_assert_null(hb_bundle_read(bundle, "status", "/../status/index.html", NULL, &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_PERM);
+    g_clear_error(&error);
+
+    // A rewritten file is mapped again (size differs, so this doesn't depend on mtime granularity)
+    g_assert_true(g_file_set_contents(index, "<p>changed</p>", -1, NULL));
+    GBytes* c = hb_bundle_read(bundle, "status", "/index.html", NULL, NULL);
+    g_assert_cmpmem(g_bytes_get_data(c, NULL), g_bytes_get_size(c), "<p>changed</p>", 14);
+    g_bytes_unref(c);
+    // Earlier responses keep their own mapping of the replaced file
+    g_assert_cmpmem(g_bytes_get_data(a, NULL), g_bytes_get_size(a), "<p>hi</p>", 9);
+    g_bytes_unref(a);
+
+    hb_bundle_free(bundle);
+    g_unlink(docs_index);
+    g_unlink(index);
+    g_rmdir(dir);
+    gchar* status = g_build_filename(root, "status", NULL);
+    g_rmdir(status);
+    g_rmdir(root);
+    g_free(status);
+    g_free(docs_index);
+    g_free(index);
+    g_free(dir);
+    g_free(root);
+}
+
+static void test_read_symlinks(void)
+{
+    gchar* root = g_dir_make_tmp("hb_bundle_test_XXXXXX", NULL);
+    gchar* outside_dir = g_dir_make_tmp("hb_bundle_outside_XXXXXX", NULL);
+    g_assert_nonnull(root);
+    g_assert_nonnull(outside_dir);
+    gchar* status = g_build_filename(root, "status", NULL);
+    g_assert_cmpint(g_mkdir(status, 0700), ==, 0);
+    gchar* index = g_build_filename(status, "index.html", NULL);
+    gchar* outside = g_build_filename(outside_dir, "secret.txt", NULL);
+    g_assert_true(g_file_set_contents(index, "<p>hi</p>", -1, NULL));
+    g_assert_true(g_file_set_contents(outside, "secret", -1, NULL));
+
+    gchar* inner_link = g_build_filename(status, "home.html", NULL);
+    gchar* file_link = g_build_filename(status, "secret.txt", NULL);
+    gchar* dir_link = g_build_filename(status, "up", NULL);
+    g_assert_cmpint(symlink("index.html", inner_link), ==, 0);
+    g_assert_cmpint(symlink(outside, file_link), ==, 0);
+    g_assert_cmpint(symlink(outside_dir, dir_link), ==, 0);
+
+    HbBundle* bundle = hb_bundle_new(root, 1024 * 1024);
+    GError* error = NULL;
+
+    // Links within the root are followed
+    GBytes* a = hb_bundle_read(bundle, "status", "/home.html", NULL, &error);
+    g_assert_no_error(error);
+    g_assert_cmpmem(g_bytes_get_data(a, NULL), g_bytes_get_size(a), "<p>hi</p>", 9);
+    g_bytes_unref(a);
+
+    // Links leaving it are not, whether they name the file or a directory on the way
+    g_assert_null(hb_bundle_read(bundle, "status", "/secret.txt", NULL, &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_PERM);
+    g_clear_error(&error);
+    g_assert_null(hb_bundle_read(bundle, "status", "/up/secret.txt", NULL, &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_PERM);
+    g_clear_error(&error);
+
+    hb_bundle_free(bundle);
+    g_unlink(dir_link);
+    g_unlink(file_link);
+    g_unlink(inner_link);
+    g_unlink(index);
+    g_unlink(outside);
+    g_rmdir(status);
+    g_rmdir(root);
+    g_rmdir(outside_dir);
+    g_free(dir_link);
+    g_free(file_link);
+    g_free(inner_link);
+    g_free(outside);
+    g_free(index);
+    g_free(status);
+    g_free(outside_dir);
+    g_free(root);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_bundle/resolve", test_resolve);
+    g_test_add_func("/hb_bundle/mime_type", test_mime_type);
+    g_test_add_func("/hb_bundle/read", test_read);
+    g_test_add_func("/hb_bundle/read_symlinks", test_read_symlinks);
+
+    return g_test_run();
+}
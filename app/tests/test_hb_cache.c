@@ -0,0 +1,97 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "../src/hb_cache.h"
+
+static void write_file(const gchar* path, gsize size, gint64 mtime)
+{
+    gchar* data = g_malloc0(size);
+    g_assert_true(g_file_set_contents(path, data, (gssize)size, NULL));
+    g_free(data);
+
+    struct timeval times[2] = {{(time_t)mtime, 0}, {(time_t)mtime, 0}};
+    g_assert_cmpint(utimes(path, times), ==, 0);
+}
+
+static void test_size_and_prune(void)
+{
+    gchar* root = g_dir_make_tmp("hb_cache_test_XXXXXX", NULL);
+    g_assert_nonnull(root);
+    gchar* version = g_build_filename(root, "WebKitCache", "Version 16", NULL);
+    gchar* records = g_build_filename(version, "Records", "ab12", NULL);
+    gchar* blobs = g_build_filename(version, "Blobs", NULL);
+    g_assert_cmpint(g_mkdir_with_parents(records, 0700), ==, 0);
+    g_assert_cmpint(g_mkdir_with_parents(blobs, 0700), ==, 0);
+
+    // Older than every entry, but not cache entries: never pruned or counted
+    gchar* salt = g_build_filename(version, "salt", NULL);
+    gchar* hsts = g_build_filename(root, "hsts-storage.sqlite", NULL);
+    write_file(salt, 8, 500);
+    write_file(hsts, 4096, 500);
+
+    gchar* oldest = g_build_filename(records, "a", NULL);
+    gchar* middle = g_build_filename(blobs, "b", NULL);
+    gchar* middle_link = g_build_filename(records, "b-blob", NULL);
+    gchar* newest = g_build_filename(records, "c", NULL);
+    write_file(oldest, 4096, 1000);
+    write_file(middle, 4096, 2000);
+    g_assert_cmpint(link(middle, middle_link), ==, 0);
+    write_file(newest, 4096, 3000);
+
+    // The hard-linked blob counts once
+    g_assert_cmpuint(hb_cache_dir_size(root), ==, 3 * 4096);
+
+    // Under budget: nothing happens
+    g_assert_cmpuint(hb_cache_prune(root, 3 * 4096), ==, 0);
+
+    // Over budget: oldest entries go first, the blob with both its links
+    g_assert_cmpuint(hb_cache_prune(root, 5000), ==, 2 * 4096);
+    g_assert_false(g_file_test(oldest, G_FILE_TEST_EXISTS));
+    g_assert_false(g_file_test(middle, G_FILE_TEST_EXISTS));
+    g_assert_false(g_file_test(middle_link, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(newest, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(salt, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(hsts, G_FILE_TEST_EXISTS));
+    g_assert_cmpuint(hb_cache_dir_size(root), ==, 4096);
+
+    g_unlink(newest);
+    g_unlink(salt);
+    g_unlink(hsts);
+    g_rmdir(records);
+    gchar* records_dir = g_path_get_dirname(records);
+    g_rmdir(records_dir);
+    g_rmdir(blobs);
+    g_rmdir(version);
+    gchar* webkit_dir = g_path_get_dirname(version);
+    g_rmdir(webkit_dir);
+    g_rmdir(root);
+    g_free(webkit_dir);
+    g_free(records_dir);
+    g_free(oldest);
+    g_free(middle);
+    g_free(middle_link);
+    g_free(newest);
+    g_free(salt);
+    g_free(hsts);
+    g_free(records);
+    g_free(blobs);
+    g_free(version);
+    g_free(root);
+}
+
+static void test_missing_dir(void)
+{
+    g_assert_cmpuint(hb_cache_dir_size("/nonexistent/hudbox-cache"), ==, 0);
+    g_assert_cmpuint(hb_cache_prune("/nonexistent/hudbox-cache", 0), ==, 0);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_cache/size_and_prune", test_size_and_prune);
+    g_test_add_func("/hb_cache/missing_dir", test_missing_dir);
+
+    return g_test_run();
+}
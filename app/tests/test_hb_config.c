@@ -1,5 +1,6 @@
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <string.h>
 #include <unistd.h>
 #include "../src/hb_config.h"
 
@@ -17,10 +18,43 @@ static void test_init_defaults(void)
     g_assert_false(cfg.locked);
     g_assert_cmpfloat(cfg.opacity, ==, 0.9);
     g_assert_false(cfg.transparent);
+    g_assert_cmpuint(cfg.memory_limit_mb, ==, 0);
+    g_assert_cmpuint(cfg.recycle_interval, ==, 0);
+    g_assert_cmpuint(cfg.refresh_interval, ==, 0);
+    g_assert_cmpuint(cfg.freeze_after, ==, 0);
+    g_assert_null(cfg.addresses);
+    g_assert_cmpuint(cfg.dwell, ==, 30);
+    g_assert_true(cfg.throttle_when_hidden);
+    g_assert_false(cfg.perf_overlay);
 
     hb_window_cfg_clear(&cfg);
 }
 
+static void test_copy(void)
+{
+    HbWindowCfg src = {0};
+    hb_window_cfg_init_defaults(&src);
+    src.memory_limit_mb = 256;
+    const gchar* css[] = {"/a.css", NULL};
+    src.user_css = g_strdupv((gchar**)css);
+
+    HbWindowCfg dst = {0};
+    hb_window_cfg_copy(&src, &dst);
+    g_assert_cmpstr(dst.title, ==, src.title);
+    g_assert_true(dst.title != src.title);
+    g_assert_cmpstr(dst.address, ==, src.address);
+    g_assert_true(dst.address != src.address);
+    g_assert_cmpuint(dst.memory_limit_mb, ==, 256);
+    g_assert_true(dst.user_css != src.user_css);
+    g_assert_cmpstr(dst.user_css[0], ==, "/a.css");
+    g_assert_null(dst.user_js);
+
+    hb_window_cfg_clear(&src);
+    g_assert_null(src.user_css);
+    g_assert_cmpstr(dst.title, ==, "HudBox");
+    hb_window_cfg_clear(&dst);
+}
+
 static void test_clear(void)
 {
     HbWindowCfg cfg = {0};
@@ -64,22 +98,15 @@ static void test_write_default_and_load(void)
     gboolean ok = hb_write_default_config(path);
     g_assert_true(ok);
 
-    GPtrArray* arr = hb_load_configs_from_json(path);
-    g_assert_nonnull(arr);
-    g_assert_cmpuint(arr->len, ==, 1);
+    HbConfigSet* set = hb_load_configs_from_json(path);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 1);
 
-    HbWindowCfg* cfg = (HbWindowCfg*)arr->pdata[0];
+    HbWindowCfg* cfg = &set->windows[0];
     g_assert_nonnull(cfg);
     g_assert_cmpstr(cfg->title, ==, "HudBox");
 
-    // cleanup
-    for (guint i = 0; i < arr->len; i++)
-    {
-        HbWindowCfg* c = arr->pdata[i];
-        hb_window_cfg_clear(c);
-        g_free(c);
-    }
-    g_ptr_array_free(arr, FALSE);
+    hb_config_set_free(set);
     g_unlink(path);
     g_free(path);
 }
@@ -100,11 +127,11 @@ static void test_load_from_object_and_array(void)
     gchar* path1 = write_temp_file(obj_json);
     g_assert_nonnull(path1);
 
-    GPtrArray* arr1 = hb_load_configs_from_json(path1);
-    g_assert_nonnull(arr1);
-    g_assert_cmpuint(arr1->len, ==, 1);
+    HbConfigSet* set1 = hb_load_configs_from_json(path1);
+    g_assert_nonnull(set1);
+    g_assert_cmpuint(set1->n_windows, ==, 1);
 
-    HbWindowCfg* c1 = arr1->pdata[0];
+    HbWindowCfg* c1 = &set1->windows[0];
     g_assert_cmpstr(c1->title, ==, "T");
     g_assert_cmpstr(c1->address, ==, "http://example.com");
     g_assert_cmpint(c1->width, ==, 1024);
@@ -113,53 +140,441 @@ static void test_load_from_object_and_array(void)
     g_assert_cmpfloat(c1->opacity, ==, 1.0f);
     g_assert_true(c1->transparent);
 
-    for (guint i = 0; i < arr1->len; i++)
-    {
-        HbWindowCfg* c = arr1->pdata[i];
-        hb_window_cfg_clear(c);
-        g_free(c);
-    }
-    g_ptr_array_free(arr1, FALSE);
+    hb_config_set_free(set1);
     g_unlink(path1);
     g_free(path1);
 
     const gchar* arr_json =
         "[\n"
-        "  { \"title\": \"A\", \"address\": \"a\", \"opacity\": -0.5 },\n"
-        "  { \"title\": \"B\", \"address\": \"b\", \"opacity\": 0.5 }\n"
+        "  { \"title\": \"A\", \"address\": \"a\", \"opacity\": -0.5, \"memory_limit_mb\": -1 },\n"
+        "  { \"title\": \"B\", \"address\": \"b\", \"opacity\": 0.5, \"memory_limit_mb\": 512, \"recycle_interval\": 3600, \"refresh_interval\": 30, \"freeze_after\": 120 }\n"
         "]\n";
 
     gchar* path2 = write_temp_file(arr_json);
     g_assert_nonnull(path2);
 
-    GPtrArray* arr2 = hb_load_configs_from_json(path2);
-    g_assert_nonnull(arr2);
-    g_assert_cmpuint(arr2->len, ==, 2);
+    HbConfigSet* set2 = hb_load_configs_from_json(path2);
+    g_assert_nonnull(set2);
+    g_assert_cmpuint(set2->n_windows, ==, 2);
 
-    HbWindowCfg* cA = arr2->pdata[0];
-    HbWindowCfg* cB = arr2->pdata[1];
+    HbWindowCfg* cA = &set2->windows[0];
+    HbWindowCfg* cB = &set2->windows[1];
     g_assert_cmpfloat(cA->opacity, ==, 0.0f); // clamped
     g_assert_cmpfloat(cB->opacity, ==, 0.5f);
+    g_assert_cmpuint(cA->memory_limit_mb, ==, 0); // negative means unlimited
+    g_assert_cmpuint(cB->memory_limit_mb, ==, 512);
+    g_assert_cmpuint(cB->recycle_interval, ==, 3600);
+    g_assert_cmpuint(cA->refresh_interval, ==, 0);
+    g_assert_cmpuint(cB->refresh_interval, ==, 30);
+    g_assert_cmpuint(cA->freeze_after, ==, 0);
+    g_assert_cmpuint(cB->freeze_after, ==, 120);
 
-    for (guint i = 0; i < arr2->len; i++)
-    {
-        HbWindowCfg* c = arr2->pdata[i];
-        hb_window_cfg_clear(c);
-        g_free(c);
-    }
-    g_ptr_array_free(arr2, FALSE);
+    hb_config_set_free(set2);
     g_unlink(path2);
     g_free(path2);
 }
 
+static void test_load_interns_strings(void)
+{
+    const gchar* json =
+        "[\n"
+        "  { \"title\": \"Tile\", \"address\": \"https://wall.example/tile\" },\n"
+        "  { \"title\": \"Tile\", \"address\": \"https://wall.example/tile\" },\n"
+        "  { \"title\": \"Other\" },\n"
+        "  42\n"
+        "]\n";
+
+    gchar* path = write_temp_file(json);
+    g_assert_nonnull(path);
+
+    HbConfigSet* set = hb_load_configs_from_json(path);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 3); // non-objects are skipped
+    g_assert_cmpstr(set->windows[0].title, ==, "Tile");
+    g_assert_true(set->windows[0].title == set->windows[1].title);
+    g_assert_true(set->windows[0].address == set->windows[1].address);
+    g_assert_cmpstr(set->windows[2].address, ==, "https://swstegall.github.io/HudBox/");
+
+    // Copies are independent of the set
+    HbWindowCfg copy;
+    hb_window_cfg_copy(&set->windows[2], &copy);
+    hb_config_set_free(set);
+    g_assert_cmpstr(copy.title, ==, "Other");
+    hb_window_cfg_clear(&copy);
+
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_diff(void)
+{
+    HbWindowCfg a = {0};
+    HbWindowCfg b = {0};
+    hb_window_cfg_init_defaults(&a);
+    hb_window_cfg_init_defaults(&b);
+
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_NONE);
+
+    b.priority = 99; // startup-only
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_NONE);
+
+    b.opacity = 0.5;
+    b.width = 1024;
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_WINDOW);
+
+    g_free(b.address);
+    b.address = g_strdup("https://example.com/other");
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_WINDOW | HB_CFG_CHANGE_ADDRESS);
+
+    hb_window_cfg_clear(&b);
+    hb_window_cfg_copy(&a, &b);
+    b.refresh_interval = 30;
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_SCHEDULE);
+    b.refresh_interval = a.refresh_interval;
+    b.perf_overlay = TRUE;
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_WINDOW);
+    b.perf_overlay = a.perf_overlay;
+    b.freeze_after = 60;
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_SCHEDULE);
+
+    b.recycle_interval = 60;
+    b.transparent = TRUE;
+    HbCfgChange c = hb_window_cfg_diff(&a, &b);
+    g_assert_true(c & HB_CFG_CHANGE_SCHEDULE);
+    g_assert_true(c & HB_CFG_CHANGE_VIEW);
+
+    // Injected files are baked into the view; an empty list equals none
+    hb_window_cfg_clear(&b);
+    hb_window_cfg_copy(&a, &b);
+    const gchar* none[] = {NULL};
+    b.user_js = g_strdupv((gchar**)none);
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_NONE);
+    const gchar* js[] = {"/hide-ads.js", NULL};
+    g_strfreev(b.user_js);
+    b.user_js = g_strdupv((gchar**)js);
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_VIEW);
+
+    // A different carousel starts over and may start or stop page changes
+    hb_window_cfg_clear(&b);
+    hb_window_cfg_copy(&a, &b);
+    b.dwell = 10;
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_SCHEDULE);
+    const gchar* pages[] = {"https://example.com/a", "https://example.com/b", NULL};
+    b.addresses = g_strdupv((gchar**)pages);
+    g_assert_cmpint(hb_window_cfg_diff(&a, &b), ==, HB_CFG_CHANGE_SCHEDULE | HB_CFG_CHANGE_ADDRESS);
+
+    hb_window_cfg_clear(&a);
+    hb_window_cfg_clear(&b);
+}
+
+static void test_load_carousel(void)
+{
+    gchar* path = write_temp_file(
+        "[ { \"title\": \"Wall\", \"addresses\": [\"https://a.example\", \"https://b.example\", \"https://c.example\"], \"dwell\": 20 },\n"
+        "  { \"title\": \"Plain\", \"address\": \"https://d.example\" } ]");
+    g_assert_nonnull(path);
+
+    HbConfigSet* set = hb_load_configs_from_json(path);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_errors, ==, 0);
+    const HbWindowCfg* wall = &set->windows[0];
+    g_assert_cmpuint(g_strv_length(wall->addresses), ==, 3);
+    g_assert_cmpstr(wall->addresses[2], ==, "https://c.example");
+    g_assert_cmpstr(wall->address, ==, "https://a.example");
+    g_assert_cmpuint(wall->dwell, ==, 20);
+    g_assert_null(set->windows[1].addresses);
+    g_assert_cmpuint(set->windows[1].dwell, ==, 30);
+
+    HbWindowCfg copy = {0};
+    hb_window_cfg_copy(wall, &copy);
+    g_assert_true(copy.addresses != wall->addresses);
+    g_assert_cmpint(hb_window_cfg_diff(wall, &copy), ==, HB_CFG_CHANGE_NONE);
+    hb_window_cfg_clear(&copy);
+    g_assert_null(copy.addresses);
+
+    hb_config_set_free(set);
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_process_model_from_string(void)
+{
+    HbProcessModel model = HB_PROCESS_MODEL_PER_WINDOW;
+    g_assert_true(hb_process_model_from_string("shared", &model));
+    g_assert_cmpint(model, ==, HB_PROCESS_MODEL_SHARED);
+    g_assert_true(hb_process_model_from_string("per-origin", &model));
+    g_assert_cmpint(model, ==, HB_PROCESS_MODEL_PER_ORIGIN);
+    g_assert_true(hb_process_model_from_string("per-window", &model));
+    g_assert_cmpint(model, ==, HB_PROCESS_MODEL_PER_WINDOW);
+    g_assert_false(hb_process_model_from_string("bogus", &model));
+    g_assert_cmpint(model, ==, HB_PROCESS_MODEL_PER_WINDOW);
+}
+
+static void test_address_origin(void)
+{
+    gchar* o = hb_address_origin("https://Example.com/a/b?c=d");
+    g_assert_cmpstr(o, ==, "https://example.com");
+    g_free(o);
+
+    o = hb_address_origin("http://localhost:8080/status");
+    g_assert_cmpstr(o, ==, "http://localhost:8080");
+    g_free(o);
+
+    g_assert_null(hb_address_origin("about:blank"));
+    g_assert_null(hb_address_origin("not a uri"));
+    g_assert_null(hb_address_origin(NULL));
+}
+
+static void test_load_content_filters_string(void)
+{
+    gchar* path = write_temp_file("{ \"content_filters\": \"/etc/hudbox/ads.json\", \"windows\": [{ \"title\": \"A\" }] }");
+    g_assert_nonnull(path);
+
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    HbConfigSet* set = hb_load_configs_from_json_full(path, &app_cfg, NULL);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(g_strv_length(app_cfg.content_filters), ==, 1);
+    g_assert_cmpstr(app_cfg.content_filters[0], ==, "/etc/hudbox/ads.json");
+    hb_app_cfg_clear(&app_cfg);
+    g_assert_null(app_cfg.content_filters);
+
+    hb_config_set_free(set);
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_load_top_level_object(void)
+{
+    const gchar* json =
+        "{\n"
+        "  \"process_model\": \"per-origin\",\n"
+        "  \"max_concurrent_loads\": 5,\n"
+        "  \"spare_views\": 2,\n"
+        "  \"push_socket\": \"/tmp/hudbox.sock\",\n"
+        "  \"content_filters\": [\"/etc/hudbox/ads.json\", 7, \"\", \"trackers.json\"],\n"
+        "  \"user_css\": \"/etc/hudbox/slim.css\",\n"
+        "  \"metrics\": { \"port\": 9464 },\n"
+        "  \"bundles\": { \"root\": \"/srv/hud\", \"cache_mb\": 4 },\n"
+        "  \"storage\": { \"profile\": \"wall\", \"cache_dir\": \"/tmp/hb-cache\", \"max_cache_mb\": 64 },\n"
+        "  \"windows\": [\n"
+        "    { \"title\": \"A\", \"address\": \"https://a.example\", \"ephemeral\": true,\n"
+        "      \"user_css\": [\"a.css\", \"b.css\"], \"user_js\": \"a.js\" },\n"
+        "    { \"title\": \"B\", \"address\": \"https://b.example\", \"priority\": 10 }\n"
+        "  ]\n"
+        "}\n";
+
+    gchar* path = write_temp_file(json);
+    g_assert_nonnull(path);
+
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    g_assert_cmpint(app_cfg.process_model, ==, HB_PROCESS_MODEL_PER_WINDOW);
+    g_assert_cmpuint(app_cfg.max_concurrent_loads, ==, 3);
+    g_assert_cmpuint(app_cfg.spare_views, ==, 0);
+    g_assert_cmpstr(app_cfg.profile, ==, "default");
+    g_assert_cmpuint(app_cfg.max_cache_mb, ==, 256);
+    g_assert_null(app_cfg.bundle_root);
+    g_assert_cmpuint(app_cfg.bundle_cache_mb, ==, 16);
+    g_assert_null(app_cfg.push_socket);
+    g_assert_null(app_cfg.content_filters);
+    g_assert_null(app_cfg.metrics_socket);
+    g_assert_cmpuint(app_cfg.metrics_port, ==, 0);
+
+    HbConfigSet* set = hb_load_configs_from_json_full(path, &app_cfg, NULL);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 2);
+    g_assert_cmpint(app_cfg.process_model, ==, HB_PROCESS_MODEL_PER_ORIGIN);
+    g_assert_cmpuint(app_cfg.max_concurrent_loads, ==, 5);
+    g_assert_cmpuint(app_cfg.spare_views, ==, 2);
+    g_assert_cmpstr(set->windows[1].title, ==, "B");
+    g_assert_cmpint(set->windows[0].priority, ==, 0);
+    g_assert_cmpint(set->windows[1].priority, ==, 10);
+    g_assert_true(set->windows[0].ephemeral);
+    g_assert_false(set->windows[1].ephemeral);
+
+    g_assert_cmpstr(app_cfg.profile, ==, "wall");
+    g_assert_cmpuint(app_cfg.max_cache_mb, ==, 64);
+    gchar* cache_dir = hb_app_cfg_get_cache_dir(&app_cfg);
+    g_assert_cmpstr(cache_dir, ==, "/tmp/hb-cache");
+    g_free(cache_dir);
+    gchar* data_dir = hb_app_cfg_get_data_dir(&app_cfg);
+    gchar* expected = g_build_filename(g_get_user_data_dir(), "hudbox", "wall", NULL);
+    g_assert_cmpstr(data_dir, ==, expected);
+    g_free(expected);
+    g_free(data_dir);
+    g_assert_cmpuint(app_cfg.bundle_cache_mb, ==, 4);
+    g_assert_cmpstr(app_cfg.push_socket, ==, "/tmp/hudbox.sock");
+    // Non-string and empty entries are skipped
+    g_assert_nonnull(app_cfg.content_filters);
+    g_assert_cmpuint(g_strv_length(app_cfg.content_filters), ==, 2);
+    g_assert_cmpstr(app_cfg.content_filters[0], ==, "/etc/hudbox/ads.json");
+    g_assert_cmpstr(app_cfg.content_filters[1], ==, "trackers.json");
+    g_assert_cmpuint(g_strv_length(app_cfg.user_css), ==, 1);
+    g_assert_cmpstr(app_cfg.user_css[0], ==, "/etc/hudbox/slim.css");
+    g_assert_null(app_cfg.user_js);
+    g_assert_cmpuint(g_strv_length(set->windows[0].user_css), ==, 2);
+    g_assert_cmpstr(set->windows[0].user_css[1], ==, "b.css");
+    g_assert_cmpuint(g_strv_length(set->windows[0].user_js), ==, 1);
+    g_assert_cmpstr(set->windows[0].user_js[0], ==, "a.js");
+    g_assert_null(set->windows[1].user_css);
+    g_assert_null(app_cfg.metrics_socket);
+    g_assert_cmpuint(app_cfg.metrics_port, ==, 9464);
+    gchar* bundle_root = hb_app_cfg_get_bundle_root(&app_cfg);
+    g_assert_cmpstr(bundle_root, ==, "/srv/hud");
+    g_free(bundle_root);
+    hb_app_cfg_clear(&app_cfg);
+
+    hb_config_set_free(set);
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_load_reports_entry_errors(void)
+{
+    gchar* path = write_temp_file("[ { \"title\": \"A\", \"width\": \"1280\", \"heigth\": 720 }, 42, { \"title\": \"B\" } ]");
+    g_assert_nonnull(path);
+
+    HbConfigSet* set = hb_load_configs_from_json(path);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 2);
+    g_assert_cmpstr(set->windows[0].title, ==, "A");
+    g_assert_cmpint(set->windows[0].width, ==, 800); // wrong type: default kept
+    g_assert_cmpstr(set->windows[1].title, ==, "B");
+
+    g_assert_cmpuint(set->n_errors, ==, 3);
+    g_assert_nonnull(strstr(set->errors[0], "window 1"));
+    g_assert_nonnull(strstr(set->errors[0], "\"width\""));
+    g_assert_nonnull(strstr(set->errors[1], "\"heigth\""));
+    g_assert_nonnull(strstr(set->errors[2], "window 2"));
+
+    hb_config_set_free(set);
+    g_unlink(path);
+    g_free(path);
+}
+
+static void on_async_loaded(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    GAsyncResult** out = user_data;
+    *out = g_object_ref(result);
+}
+
+static GAsyncResult* load_async_and_wait(const gchar* path, gboolean create_default)
+{
+    GAsyncResult* result = NULL;
+    hb_load_configs_async(path, create_default, NULL, on_async_loaded, &result);
+    while (!result) g_main_context_iteration(NULL, TRUE);
+    return result;
+}
+
+static void test_load_async(void)
+{
+    gchar* path = write_temp_file("{ \"process_model\": \"shared\", \"windows\": [{ \"title\": \"A\" }, { \"title\": \"B\" }] }");
+    g_assert_nonnull(path);
+
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    GError* error = NULL;
+    GAsyncResult* result = load_async_and_wait(path, FALSE);
+    HbConfigSet* set = hb_load_configs_finish(result, &app_cfg, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 2);
+    g_assert_cmpstr(set->windows[1].title, ==, "B");
+    g_assert_cmpuint(set->n_errors, ==, 0);
+    g_assert_cmpint(app_cfg.process_model, ==, HB_PROCESS_MODEL_SHARED);
+    g_assert_cmpstr(app_cfg.profile, ==, "default");
+    g_object_unref(result);
+    hb_config_set_free(set);
+    hb_app_cfg_clear(&app_cfg);
+
+    // Missing file: an error, unless the default may be created
+    g_unlink(path);
+    hb_app_cfg_init_defaults(&app_cfg);
+    result = load_async_and_wait(path, FALSE);
+    g_assert_null(hb_load_configs_finish(result, &app_cfg, &error));
+    g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+    g_clear_error(&error);
+    g_assert_cmpint(app_cfg.process_model, ==, HB_PROCESS_MODEL_PER_WINDOW);
+    g_object_unref(result);
+
+    result = load_async_and_wait(path, TRUE);
+    set = hb_load_configs_finish(result, &app_cfg, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(set);
+    g_assert_cmpstr(set->windows[0].title, ==, "HudBox");
+    g_assert_true(g_file_test(path, G_FILE_TEST_EXISTS));
+    g_object_unref(result);
+    hb_config_set_free(set);
+    hb_app_cfg_clear(&app_cfg);
+
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_load_reports_section_errors(void)
+{
+    gchar* path = write_temp_file(
+        "{ \"metrics\": 9090, \"session\": [true], \"storage\": { \"max_cache_mb\": \"64\" },\n"
+        "  \"shared_cache\": { \"ttl\": 30 }, \"spare_views\": \"2\", \"windows\": [{ \"title\": \"A\" }] }");
+    g_assert_nonnull(path);
+
+    HbAppCfg app_cfg;
+    hb_app_cfg_init_defaults(&app_cfg);
+    HbConfigSet* set = hb_load_configs_from_json_full(path, &app_cfg, NULL);
+    g_assert_nonnull(set);
+    g_assert_cmpuint(set->n_windows, ==, 1);
+    // Sections and settings of the wrong type are reported and left at their defaults
+    g_assert_cmpuint(app_cfg.metrics_port, ==, 0);
+    g_assert_false(app_cfg.restore_session);
+    g_assert_cmpuint(app_cfg.max_cache_mb, ==, 256);
+    g_assert_cmpuint(app_cfg.spare_views, ==, 0);
+    g_assert_cmpuint(app_cfg.shared_cache_ttl, ==, 30);
+
+    g_assert_cmpuint(set->n_errors, ==, 4);
+    g_assert_cmpstr(set->errors[0], ==, "\"metrics\" must be an object; using the default");
+    g_assert_cmpstr(set->errors[1], ==, "\"session\" must be an object; using the default");
+    g_assert_cmpstr(set->errors[2], ==, "storage: \"max_cache_mb\" must be an integer; using the default");
+    g_assert_nonnull(strstr(set->errors[3], "\"spare_views\""));
+    hb_config_set_free(set);
+    hb_app_cfg_clear(&app_cfg);
+    g_unlink(path);
+    g_free(path);
+
+    // Without a usable "windows" array there's nothing to show
+    path = write_temp_file("{ \"windows\": { \"title\": \"A\" } }");
+    GError* error = NULL;
+    hb_app_cfg_init_defaults(&app_cfg);
+    GAsyncResult* result = load_async_and_wait(path, FALSE);
+    g_assert_null(hb_load_configs_finish(result, &app_cfg, &error));
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_assert_nonnull(strstr(error->message, "\"windows\" must be an array"));
+    g_error_free(error);
+    g_object_unref(result);
+    hb_app_cfg_clear(&app_cfg);
+    g_unlink(path);
+    g_free(path);
+}
+
 int main(int argc, char** argv)
 {
     g_test_init(&argc, &argv, NULL);
 
     g_test_add_func("/hb_config/init_defaults", test_init_defaults);
     g_test_add_func("/hb_config/clear", test_clear);
+    g_test_add_func("/hb_config/copy", test_copy);
+    g_test_add_func("/hb_config/diff", test_diff);
     g_test_add_func("/hb_config/write_default_and_load", test_write_default_and_load);
     g_test_add_func("/hb_config/load_from_object_and_array", test_load_from_object_and_array);
+    g_test_add_func("/hb_config/load_interns_strings", test_load_interns_strings);
+    g_test_add_func("/hb_config/process_model_from_string", test_process_model_from_string);
+    g_test_add_func("/hb_config/address_origin", test_address_origin);
+    g_test_add_func("/hb_config/load_top_level_object", test_load_top_level_object);
+    g_test_add_func("/hb_config/load_content_filters_string", test_load_content_filters_string);
+    g_test_add_func("/hb_config/load_reports_entry_errors", test_load_reports_entry_errors);
+    g_test_add_func("/hb_config/load_async", test_load_async);
+    g_test_add_func("/hb_config/load_reports_section_errors", test_load_reports_section_errors);
+    g_test_add_func("/hb_config/load_carousel", test_load_carousel);
 
     return g_test_run();
 }
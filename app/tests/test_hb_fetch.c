@@ -0,0 +1,182 @@
+#include <glib.h>
+#include <gio/gio.h>
+#include <string.h>
+#include "../src/hb_fetch.h"
+
+// Upstream fetches are recorded and completed by the test
+static GPtrArray* fetched = NULL;
+static gint64 fake_now = 0;
+
+static void record_fetch(HbFetchCache* cache, const gchar* url, gpointer user_data)
+{
+    g_ptr_array_add(fetched, g_strdup(url));
+}
+
+static gint64 get_fake_now(void)
+{
+    return fake_now;
+}
+
+typedef struct
+{
+    guint calls;
+    guint status;
+    gchar* body;
+    gboolean failed;
+} Result;
+
+static void on_result(const HbFetchResponse* response, const GError* error, gpointer user_data)
+{
+    Result* r = user_data;
+    r->calls++;
+    if (!response)
+    {
+        g_assert_nonnull(error);
+        r->failed = TRUE;
+        return;
+    }
+    r->status = response->status;
+    g_free(r->body);
+    r->body = g_strndup(g_bytes_get_data(response->body, NULL), g_bytes_get_size(response->body));
+}
+
+static HbFetchResponse* make_response(guint status, const gchar* body)
+{
+    HbFetchResponse* response = g_new0(HbFetchResponse, 1);
+    response->status = status;
+    response->content_type = g_strdup("application/json");
+    response->body = g_bytes_new(body, strlen(body));
+    return response;
+}
+
+static HbFetchCache* new_cache(guint64 max_bytes)
+{
+    fetched = g_ptr_array_new_with_free_func(g_free);
+    fake_now = 1000 * G_USEC_PER_SEC;
+    HbFetchCache* cache = hb_fetch_cache_new(max_bytes, record_fetch, NULL);
+    hb_fetch_cache_set_clock(cache, get_fake_now);
+    return cache;
+}
+
+static void free_cache(HbFetchCache* cache)
+{
+    hb_fetch_cache_free(cache);
+    g_ptr_array_unref(fetched);
+    fetched = NULL;
+}
+
+static void test_coalesce_and_hit(void)
+{
+    HbFetchCache* cache = new_cache(1024);
+    Result a = {0}, b = {0}, c = {0};
+
+    // Two windows ask while the first fetch is in flight: one upstream request
+    hb_fetch_cache_get(cache, "https://example.com/status.json", on_result, &a);
+    hb_fetch_cache_get(cache, "https://example.com/status.json", on_result, &b);
+    g_assert_cmpuint(fetched->len, ==, 1);
+    g_assert_cmpuint(a.calls, ==, 0);
+
+    hb_fetch_cache_complete(cache, "https://example.com/status.json", make_response(200, "{\"ok\":1}"), 10, NULL);
+    g_assert_cmpuint(a.calls, ==, 1);
+    g_assert_cmpuint(b.calls, ==, 1);
+    g_assert_cmpstr(a.body, ==, "{\"ok\":1}");
+    g_assert_cmpstr(b.body, ==, "{\"ok\":1}");
+
+    // A repeat within the TTL is served from memory
+    hb_fetch_cache_get(cache, "https://example.com/status.json", on_result, &c);
+    g_assert_cmpuint(c.calls, ==, 1);
+    g_assert_cmpstr(c.body, ==, "{\"ok\":1}");
+    g_assert_cmpuint(fetched->len, ==, 1);
+
+    HbFetchStats stats;
+    hb_fetch_cache_get_stats(cache, &stats);
+    g_assert_cmpuint(stats.misses, ==, 1);
+    g_assert_cmpuint(stats.coalesced, ==, 1);
+    g_assert_cmpuint(stats.hits, ==, 1);
+    g_assert_cmpuint(stats.entries, ==, 1);
+    g_assert_cmpuint(stats.bytes, ==, 8);
+
+    g_free(a.body);
+    g_free(b.body);
+    g_free(c.body);
+    free_cache(cache);
+}
+
+static void test_expiry(void)
+{
+    HbFetchCache* cache = new_cache(1024);
+    Result a = {0};
+
+    hb_fetch_cache_get(cache, "https://example.com/a", on_result, &a);
+    hb_fetch_cache_complete(cache, "https://example.com/a", make_response(200, "1"), 5, NULL);
+
+    fake_now += 4 * G_USEC_PER_SEC;
+    hb_fetch_cache_get(cache, "https://example.com/a", on_result, &a);
+    g_assert_cmpuint(fetched->len, ==, 1);
+
+    // Past its TTL: fetched again, and the new response replaces the old one
+    fake_now += 2 * G_USEC_PER_SEC;
+    hb_fetch_cache_get(cache, "https://example.com/a", on_result, &a);
+    g_assert_cmpuint(fetched->len, ==, 2);
+    hb_fetch_cache_complete(cache, "https://example.com/a", make_response(200, "2"), 5, NULL);
+    g_assert_cmpuint(a.calls, ==, 3);
+    g_assert_cmpstr(a.body, ==, "2");
+
+    g_free(a.body);
+    free_cache(cache);
+}
+
+static void test_not_cached(void)
+{
+    HbFetchCache* cache = new_cache(1024);
+    Result a = {0}, b = {0};
+
+    // Errors, non-200 responses and TTL 0 reach the waiting requests but aren't kept
+    hb_fetch_cache_get(cache, "https://example.com/missing", on_result, &a);
+    hb_fetch_cache_complete(cache, "https://example.com/missing", make_response(404, "nope"), 10, NULL);
+    g_assert_cmpuint(a.status, ==, 404);
+    hb_fetch_cache_get(cache, "https://example.com/missing", on_result, &a);
+    g_assert_cmpuint(fetched->len, ==, 2);
+    hb_fetch_cache_complete(cache, "https://example.com/missing", make_response(200, "x"), 0, NULL);
+
+    hb_fetch_cache_get(cache, "https://example.com/down", on_result, &b);
+    GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CONNECTION_REFUSED, "refused");
+    hb_fetch_cache_complete(cache, "https://example.com/down", NULL, 0, error);
+    g_error_free(error);
+    g_assert_true(b.failed);
+
+    HbFetchStats stats;
+    hb_fetch_cache_get_stats(cache, &stats);
+    g_assert_cmpuint(stats.entries, ==, 0);
+    g_assert_cmpuint(stats.misses, ==, 3);
+
+    // Pending requests fail when the cache goes away
+    Result c = {0};
+    hb_fetch_cache_get(cache, "https://example.com/slow", on_result, &c);
+    free_cache(cache);
+    g_assert_true(c.failed);
+    g_free(a.body);
+}
+
+static void test_ttl_from_header(void)
+{
+    g_assert_cmpuint(hb_fetch_ttl(NULL, 5), ==, 5);
+    g_assert_cmpuint(hb_fetch_ttl("public", 5), ==, 5);
+    g_assert_cmpuint(hb_fetch_ttl("public, max-age=60", 5), ==, 60);
+    g_assert_cmpuint(hb_fetch_ttl("Max-Age=0", 5), ==, 0);
+    g_assert_cmpuint(hb_fetch_ttl("max-age=60, no-cache", 5), ==, 0);
+    g_assert_cmpuint(hb_fetch_ttl("no-store", 5), ==, 0);
+    g_assert_cmpuint(hb_fetch_ttl("max-age=abc", 5), ==, 5);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_fetch/coalesce_and_hit", test_coalesce_and_hit);
+    g_test_add_func("/hb_fetch/expiry", test_expiry);
+    g_test_add_func("/hb_fetch/not_cached", test_not_cached);
+    g_test_add_func("/hb_fetch/ttl_from_header", test_ttl_from_header);
+
+    return g_test_run();
+}
@@ -0,0 +1,108 @@
+#include <glib.h>
+#include "../src/hb_fps.h"
+
+static void test_empty(void)
+{
+    HbFrameStats stats;
+    hb_frame_stats_reset(&stats);
+    g_assert_cmpuint(stats.count, ==, 0);
+    g_assert_cmpfloat(hb_frame_stats_fps(&stats, G_USEC_PER_SEC, G_USEC_PER_SEC), ==, 0.0);
+}
+
+static void test_steady_rate(void)
+{
+    HbFrameStats stats;
+    hb_frame_stats_reset(&stats);
+
+    // 30 fps for two seconds
+    gint64 t = 0;
+    for (int i = 0; i < 60; i++)
+    {
+        t += G_USEC_PER_SEC / 30;
+        hb_frame_stats_add(&stats, t);
+    }
+    gdouble fps = hb_frame_stats_fps(&stats, t, G_USEC_PER_SEC);
+    g_assert_cmpfloat_with_epsilon(fps, 30.0, 1.01);
+
+    // Nothing presented during the last second
+    g_assert_cmpfloat(hb_frame_stats_fps(&stats, t + 2 * G_USEC_PER_SEC, G_USEC_PER_SEC), ==, 0.0);
+}
+
+static void test_ring_wraps(void)
+{
+    HbFrameStats stats;
+    hb_frame_stats_reset(&stats);
+
+    // 240 fps for ten seconds: more frames than the ring holds
+    gint64 t = 0;
+    for (int i = 0; i < 2400; i++)
+    {
+        t += G_USEC_PER_SEC / 240;
+        hb_frame_stats_add(&stats, t);
+    }
+    g_assert_cmpuint(stats.count, ==, HB_FRAME_STATS_HISTORY);
+    // A full five-second report interval (--show-fps) is still counted at the real rate
+    gdouble fps = hb_frame_stats_fps(&stats, t, 5 * G_USEC_PER_SEC);
+    g_assert_cmpfloat_with_epsilon(fps, 240.0, 1.01);
+}
+
+static void test_full_rate_interval(void)
+{
+    HbFrameStats stats;
+    hb_frame_stats_reset(&stats);
+
+    // An uncapped window on a 60 Hz display, over one report interval
+    gint64 t = 0;
+    for (int i = 0; i < 300; i++)
+    {
+        t += G_USEC_PER_SEC / 60;
+        hb_frame_stats_add(&stats, t);
+    }
+    gdouble fps = hb_frame_stats_fps(&stats, t, 5 * G_USEC_PER_SEC);
+    g_assert_cmpfloat_with_epsilon(fps, 60.0, 1.01);
+}
+
+static void test_histogram(void)
+{
+    HbFrameStats stats;
+    hb_frame_stats_reset(&stats);
+    guint buckets[HB_FRAME_TIME_BUCKETS];
+    g_assert_cmpuint(hb_frame_stats_histogram(&stats, G_USEC_PER_SEC, G_USEC_PER_SEC, buckets), ==, 0);
+
+    // Ten 16 ms frames, then a 40 ms and a 250 ms stall
+    gint64 t = 0;
+    hb_frame_stats_add(&stats, t);
+    for (int i = 0; i < 10; i++)
+    {
+        t += 16000;
+        hb_frame_stats_add(&stats, t);
+    }
+    t += 40000;
+    hb_frame_stats_add(&stats, t);
+    t += 250000;
+    hb_frame_stats_add(&stats, t);
+
+    g_assert_cmpuint(hb_frame_stats_histogram(&stats, t, G_USEC_PER_SEC, buckets), ==, 12);
+    g_assert_cmpuint(buckets[0], ==, 10);
+    g_assert_cmpuint(buckets[1], ==, 0);
+    g_assert_cmpuint(buckets[2], ==, 1);
+    g_assert_cmpuint(buckets[3], ==, 0);
+    g_assert_cmpuint(buckets[4], ==, 1);
+
+    // Only intervals between frames inside the span count
+    g_assert_cmpuint(hb_frame_stats_histogram(&stats, t, 260000, buckets), ==, 1);
+    g_assert_cmpuint(buckets[4], ==, 1);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_fps/empty", test_empty);
+    g_test_add_func("/hb_fps/steady_rate", test_steady_rate);
+    g_test_add_func("/hb_fps/ring_wraps", test_ring_wraps);
+    g_test_add_func("/hb_fps/full_rate_interval", test_full_rate_interval);
+    g_test_add_func("/hb_fps/histogram", test_histogram);
+
+    return g_test_run();
+}
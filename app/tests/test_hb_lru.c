@@ -0,0 +1,72 @@
+#include <glib.h>
+#include "../src/hb_lru.h"
+
+static guint freed = 0;
+
+static void count_free(gpointer data)
+{
+    freed++;
+    g_free(data);
+}
+
+static void test_insert_lookup_evict(void)
+{
+    freed = 0;
+    HbLru* lru = hb_lru_new(100, count_free);
+
+    g_assert_true(hb_lru_insert(lru, "a", g_strdup("A"), 40));
+    g_assert_true(hb_lru_insert(lru, "b", g_strdup("B"), 40));
+    g_assert_cmpuint(hb_lru_get_count(lru), ==, 2);
+    g_assert_cmpuint(hb_lru_get_size(lru), ==, 80);
+
+    // Touch "a" so that "b" becomes the eviction candidate
+    g_assert_cmpstr(hb_lru_lookup(lru, "a"), ==, "A");
+    g_assert_true(hb_lru_insert(lru, "c", g_strdup("C"), 40));
+    g_assert_null(hb_lru_lookup(lru, "b"));
+    g_assert_cmpstr(hb_lru_lookup(lru, "a"), ==, "A");
+    g_assert_cmpstr(hb_lru_lookup(lru, "c"), ==, "C");
+    g_assert_cmpuint(hb_lru_get_size(lru), ==, 80);
+    g_assert_cmpuint(freed, ==, 1);
+
+    hb_lru_free(lru);
+    g_assert_cmpuint(freed, ==, 3);
+}
+
+static void test_replace_and_remove(void)
+{
+    freed = 0;
+    HbLru* lru = hb_lru_new(100, count_free);
+
+    hb_lru_insert(lru, "a", g_strdup("A1"), 10);
+    hb_lru_insert(lru, "a", g_strdup("A2"), 30);
+    g_assert_cmpuint(freed, ==, 1);
+    g_assert_cmpuint(hb_lru_get_count(lru), ==, 1);
+    g_assert_cmpuint(hb_lru_get_size(lru), ==, 30);
+    g_assert_cmpstr(hb_lru_lookup(lru, "a"), ==, "A2");
+
+    g_assert_true(hb_lru_remove(lru, "a"));
+    g_assert_false(hb_lru_remove(lru, "a"));
+    g_assert_cmpuint(hb_lru_get_size(lru), ==, 0);
+    g_assert_cmpuint(freed, ==, 2);
+
+    // Larger than the whole budget: rejected and released, nothing evicted
+    hb_lru_insert(lru, "b", g_strdup("B"), 50);
+    g_assert_false(hb_lru_insert(lru, "huge", g_strdup("H"), 101));
+    g_assert_cmpuint(freed, ==, 3);
+    g_assert_cmpstr(hb_lru_lookup(lru, "b"), ==, "B");
+
+    hb_lru_clear(lru);
+    g_assert_cmpuint(hb_lru_get_count(lru), ==, 0);
+    hb_lru_free(lru);
+    g_assert_cmpuint(freed, ==, 4);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_lru/insert_lookup_evict", test_insert_lookup_evict);
+    g_test_add_func("/hb_lru/replace_and_remove", test_replace_and_remove);
+
+    return g_test_run();
+}
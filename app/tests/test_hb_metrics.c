@@ -0,0 +1,151 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <string.h>
+#include "../src/hb_metrics.h"
+
+static void test_format(void)
+{
+    GString* out = g_string_new(NULL);
+    hb_metrics_append_header(out, "hudbox_test_total", "counter", "A test counter.");
+    const gchar* labels[] = {"window", "Say \"hi\"\\\n", "id", "3", NULL};
+    hb_metrics_append_sample(out, "hudbox_test_total", labels, 42);
+    hb_metrics_append_sample(out, "hudbox_test_total", NULL, 0.25);
+    g_assert_cmpstr(out->str, ==,
+                    "# HELP hudbox_test_total A test counter.\n"
+                    "# TYPE hudbox_test_total counter\n"
+                    "hudbox_test_total{window=\"Say \\\"hi\\\"\\\\\\n\",id=\"3\"} 42\n"
+                    "hudbox_test_total 0.25\n");
+    g_string_free(out, TRUE);
+}
+
+static void test_latency(void)
+{
+    GString* out = g_string_new(NULL);
+    hb_metrics_append_latency(out);
+    g_assert_nonnull(strstr(out->str, "# TYPE hudbox_main_loop_latency_seconds gauge\n"));
+    g_assert_nonnull(strstr(out->str, "hudbox_main_loop_latency_max_seconds 0\n"));
+    g_string_free(out, TRUE);
+}
+
+static void collect(GString* out, gpointer user_data)
+{
+    (*(guint*)user_data)++;
+    hb_metrics_append_sample(out, "hudbox_up", NULL, 1);
+}
+
+static gchar* scrape(const gchar* path, const gchar* request)
+{
+    // Blocking client in a thread; the server runs on the main loop
+    GSocketClient* client = g_socket_client_new();
+    GSocketAddress* address = g_unix_socket_address_new(path);
+    GSocketConnection* conn = g_socket_client_connect(client, G_SOCKET_CONNECTABLE(address), NULL, NULL);
+    g_assert_nonnull(conn);
+
+    GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(conn));
+    g_assert_true(g_output_stream_write_all(out, request, strlen(request), NULL, NULL, NULL));
+
+    GString* response = g_string_new(NULL);
+    GInputStream* in = g_io_stream_get_input_stream(G_IO_STREAM(conn));
+    gchar buf[512];
+    gssize n;
+    while ((n = g_input_stream_read(in, buf, sizeof(buf), NULL, NULL)) > 0)
+    {
+        g_string_append_len(response, buf, n);
+    }
+
+    g_object_unref(conn);
+    g_object_unref(address);
+    g_object_unref(client);
+    return g_string_free(response, FALSE);
+}
+
+static gboolean on_thread_done(gpointer user_data)
+{
+    g_main_loop_quit(user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer scrape_and_quit(gpointer user_data)
+{
+    gpointer* args = user_data;
+    gchar* response = scrape(args[0], args[2]);
+    g_idle_add(on_thread_done, args[1]);
+    return response;
+}
+
+static void test_server(void)
+{
+    gchar* dir = g_dir_make_tmp("hb_metrics_test_XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    gchar* path = g_build_filename(dir, "metrics.sock", NULL);
+
+    guint scrapes = 0;
+    GError* error = NULL;
+    HbMetricsServer* server = hb_metrics_server_new(path, 0, collect, &scrapes, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(server);
+
+    GMainLoop* loop = g_main_loop_new(NULL, FALSE);
+    gpointer args[] = {path, loop, "GET /metrics HTTP/1.1\r\nHost: localhost\r\nAccept: text/plain\r\n\r\n"};
+    GThread* thread = g_thread_new("scrape", scrape_and_quit, args);
+    g_main_loop_run(loop);
+    gchar* response = g_thread_join(thread);
+
+    g_assert_cmpuint(scrapes, ==, 1);
+    g_assert_true(g_str_has_prefix(response, "HTTP/1.0 200 OK\r\n"));
+    g_assert_nonnull(strstr(response, "Content-Type: text/plain; version=0.0.4"));
+    g_assert_true(g_str_has_suffix(response, "\r\n\r\nhudbox_up 1\n"));
+
+    g_free(response);
+    g_main_loop_unref(loop);
+    hb_metrics_server_free(server);
+    g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+    g_rmdir(dir);
+    g_free(path);
+    g_free(dir);
+}
+
+static void test_server_head_limit(void)
+{
+    gchar* dir = g_dir_make_tmp("hb_metrics_test_XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    gchar* path = g_build_filename(dir, "metrics.sock", NULL);
+
+    guint scrapes = 0;
+    GError* error = NULL;
+    HbMetricsServer* server = hb_metrics_server_new(path, 0, collect, &scrapes, &error);
+    g_assert_no_error(error);
+
+    // A request line that never ends: answered once the limit is reached, without waiting for more
+    gchar* request = g_strnfill(HB_METRICS_MAX_REQUEST_HEAD, 'a');
+    GMainLoop* loop = g_main_loop_new(NULL, FALSE);
+    gpointer args[] = {path, loop, request};
+    GThread* thread = g_thread_new("scrape", scrape_and_quit, args);
+    g_main_loop_run(loop);
+    gchar* response = g_thread_join(thread);
+
+    g_assert_cmpuint(scrapes, ==, 0);
+    g_assert_true(g_str_has_prefix(response, "HTTP/1.0 400 Bad Request\r\n"));
+
+    g_free(response);
+    g_free(request);
+    g_main_loop_unref(loop);
+    hb_metrics_server_free(server);
+    g_rmdir(dir);
+    g_free(path);
+    g_free(dir);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_metrics/format", test_format);
+    g_test_add_func("/hb_metrics/latency", test_latency);
+    g_test_add_func("/hb_metrics/server", test_server);
+    g_test_add_func("/hb_metrics/server_head_limit", test_server_head_limit);
+
+    return g_test_run();
+}
@@ -0,0 +1,83 @@
+#include <glib.h>
+#include <unistd.h>
+#include "../src/hb_proc.h"
+
+static void test_parse_status(void)
+{
+    const gchar* status =
+        "Name:\tWebKitWebProces\n"
+        "Umask:\t0022\n"
+        "State:\tS (sleeping)\n"
+        "Pid:\t4242\n"
+        "PPid:\t4200\n"
+        "VmPeak:\t  900000 kB\n"
+        "VmRSS:\t  123456 kB\n"
+        "Threads:\t12\n";
+
+    HbProcInfo info = {0};
+    g_assert_true(hb_proc_parse_status(status, &info));
+    g_assert_cmpstr(info.name, ==, "WebKitWebProces");
+    g_assert_cmpint(info.ppid, ==, 4200);
+    g_assert_cmpuint(info.rss_kb, ==, 123456);
+    g_free(info.name);
+}
+
+static void test_parse_status_missing_fields(void)
+{
+    HbProcInfo info = {0};
+    g_assert_false(hb_proc_parse_status("VmRSS:\t10 kB\n", &info));
+    g_assert_false(hb_proc_parse_status(NULL, &info));
+    g_free(info.name);
+}
+
+static void test_parse_stat(void)
+{
+    // comm with spaces and a ')' of its own
+    const gchar* stat =
+        "4242 (Web Content) (x)) S 4200 4242 4242 0 -1 4194560 1234 0 0 0 150 25 0 0 20 0 12 0 100 "
+        "900000000 30000 18446744073709551615\n";
+    guint64 ticks = 0;
+    g_assert_true(hb_proc_parse_stat(stat, &ticks));
+    g_assert_cmpuint(ticks, ==, 175);
+
+    g_assert_false(hb_proc_parse_stat("4242 (short) S 1 2", &ticks));
+    g_assert_false(hb_proc_parse_stat("garbage", &ticks));
+    g_assert_false(hb_proc_parse_stat(NULL, &ticks));
+}
+
+static void test_read_self(void)
+{
+    HbProcInfo* self = hb_proc_read(getpid());
+    g_assert_nonnull(self);
+    g_assert_cmpint(self->pid, ==, getpid());
+    g_assert_cmpint(self->ppid, ==, getppid());
+    g_assert_cmpuint(self->rss_kb, >, 0);
+    g_assert_true(hb_proc_read_cpu(self));
+    g_assert_cmpfloat(self->cpu_seconds, >=, 0.0);
+    hb_proc_info_free(self);
+}
+
+static void test_list_descendants_excludes_self(void)
+{
+    GPtrArray* procs = hb_proc_list_descendants();
+    g_assert_nonnull(procs);
+    for (guint i = 0; i < procs->len; i++)
+    {
+        HbProcInfo* info = g_ptr_array_index(procs, i);
+        g_assert_cmpint(info->pid, !=, getpid());
+    }
+    g_ptr_array_free(procs, TRUE);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_proc/parse_status", test_parse_status);
+    g_test_add_func("/hb_proc/parse_status_missing_fields", test_parse_status_missing_fields);
+    g_test_add_func("/hb_proc/parse_stat", test_parse_stat);
+    g_test_add_func("/hb_proc/read_self", test_read_self);
+    g_test_add_func("/hb_proc/list_descendants_excludes_self", test_list_descendants_excludes_self);
+
+    return g_test_run();
+}
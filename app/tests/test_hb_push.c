@@ -0,0 +1,118 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <string.h>
+#include "../src/hb_push.h"
+
+static void test_parse_line(void)
+{
+    gchar* window = NULL;
+    gchar* payload = NULL;
+    GError* error = NULL;
+
+    g_assert_true(hb_push_parse_line("{\"window\":\"Status\",\"data\":{\"cpu\":42}}", &window, &payload, &error));
+    g_assert_no_error(error);
+    g_assert_cmpstr(window, ==, "Status");
+    g_assert_cmpstr(payload, ==, "{\"cpu\":42}");
+    g_free(window);
+    g_free(payload);
+
+    // No target: every window; no "data": the whole object
+    g_assert_true(hb_push_parse_line("{\"cpu\":7}", &window, &payload, NULL));
+    g_assert_null(window);
+    g_assert_cmpstr(payload, ==, "{\"cpu\":7}");
+    g_free(payload);
+
+    g_assert_true(hb_push_parse_line("{\"window\":null,\"data\":[1,2]}", &window, &payload, NULL));
+    g_assert_null(window);
+    g_assert_cmpstr(payload, ==, "[1,2]");
+    g_free(payload);
+
+    g_assert_false(hb_push_parse_line("not json", &window, &payload, &error));
+    g_assert_nonnull(error);
+    g_clear_error(&error);
+    g_assert_false(hb_push_parse_line("[1,2,3]", &window, &payload, &error));
+    g_assert_nonnull(error);
+    g_clear_error(&error);
+    g_assert_false(hb_push_parse_line("{\"window\":3,\"data\":1}", &window, &payload, &error));
+    g_assert_nonnull(error);
+    g_clear_error(&error);
+}
+
+typedef struct
+{
+    GPtrArray* received; // "window|payload"
+    GMainLoop* loop;
+} PushState;
+
+static void on_push(const gchar* window, const gchar* payload, gpointer user_data)
+{
+    PushState* state = user_data;
+    g_ptr_array_add(state->received, g_strdup_printf("%s|%s", window ? window : "*", payload));
+    if (state->received->len == 2) g_main_loop_quit(state->loop);
+}
+
+static gboolean on_timeout(gpointer user_data)
+{
+    g_main_loop_quit(user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static void test_socket(void)
+{
+    gchar* dir = g_dir_make_tmp("hb_push_test_XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    gchar* path = g_build_filename(dir, "push.sock", NULL);
+
+    PushState state = {g_ptr_array_new_with_free_func(g_free), g_main_loop_new(NULL, FALSE)};
+    GError* error = NULL;
+    HbPushServer* server = hb_push_server_new(path, on_push, &state, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(server);
+
+    GSocketClient* client = g_socket_client_new();
+    GSocketAddress* address = g_unix_socket_address_new(path);
+    GSocketConnection* conn = g_socket_client_connect(client, G_SOCKET_CONNECTABLE(address), NULL, &error);
+    g_assert_no_error(error);
+
+    const gchar* lines = "{\"window\":\"A\",\"data\":1}\n"
+        "garbage\n"
+        "\n"
+        "{\"data\":{\"b\":true}}\n";
+    GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(conn));
+    g_assert_true(g_output_stream_write_all(out, lines, strlen(lines), NULL, NULL, &error));
+    g_assert_no_error(error);
+
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "push: ignoring malformed message*");
+    guint timeout = g_timeout_add_seconds(5, on_timeout, state.loop);
+    g_main_loop_run(state.loop);
+    g_source_remove(timeout);
+    g_test_assert_expected_messages();
+
+    g_assert_cmpuint(state.received->len, ==, 2);
+    g_assert_cmpstr(state.received->pdata[0], ==, "A|1");
+    g_assert_cmpstr(state.received->pdata[1], ==, "*|{\"b\":true}");
+
+    g_object_unref(conn);
+    g_object_unref(address);
+    g_object_unref(client);
+    hb_push_server_free(server);
+    g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+
+    g_rmdir(dir);
+    g_free(path);
+    g_free(dir);
+    g_main_loop_unref(state.loop);
+    g_ptr_array_free(state.received, TRUE);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_push/parse_line", test_parse_line);
+    g_test_add_func("/hb_push/socket", test_socket);
+
+    return g_test_run();
+}
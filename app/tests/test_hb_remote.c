@@ -0,0 +1,198 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include "../src/hb_remote.h"
+#include "../src/hb_window.h"
+
+static gboolean should_run_webkit_tests(void)
+{
+    const char* flag = g_getenv("HB_ENABLE_WEBKIT_TESTS");
+    return flag && flag[0] != '\0';
+}
+
+static gboolean register_or_skip(GtkApplication* app, const char* why)
+{
+    GError* error = NULL;
+    if (!g_application_register(G_APPLICATION(app), NULL, &error))
+    {
+        g_test_skip(why);
+        if (error) g_error_free(error);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void close_all_windows(GtkApplication* app)
+{
+    GList* wins = g_list_copy(gtk_application_get_windows(app));
+    for (GList* l = wins; l != NULL; l = l->next)
+    {
+        gtk_window_destroy(GTK_WINDOW(l->data));
+    }
+    g_list_free(wins);
+    while (g_main_context_iteration(NULL, FALSE)) {}
+}
+
+// Titles listed by the "windows" action, once its pending update has run
+static gchar** window_titles(GtkApplication* app)
+{
+    while (g_main_context_iteration(NULL, FALSE)) {}
+    GVariant* state = g_action_group_get_action_state(G_ACTION_GROUP(app), "windows");
+    gchar** titles = g_variant_dup_strv(state, NULL);
+    g_variant_unref(state);
+    return titles;
+}
+
+static void assert_parameter_type(GtkApplication* app, const gchar* action, const gchar* type)
+{
+    g_assert_true(g_action_group_has_action(G_ACTION_GROUP(app), action));
+    const GVariantType* actual = g_action_group_get_action_parameter_type(G_ACTION_GROUP(app), action);
+    if (!type)
+    {
+        g_assert_null(actual);
+    }
+    else
+    {
+        g_assert_nonnull(actual);
+        g_assert_true(g_variant_type_equal(actual, G_VARIANT_TYPE(type)));
+    }
+}
+
+static void test_actions_installed(void)
+{
+    if (!gtk_init_check())
+    {
+        g_test_skip("No display; skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.remote.actions", G_APPLICATION_NON_UNIQUE);
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        g_object_unref(app);
+        return;
+    }
+
+    hb_remote_install(app);
+    hb_remote_install(app); // a second install changes nothing
+
+    assert_parameter_type(app, "open-config", "s");
+    assert_parameter_type(app, "reload-config", NULL);
+    assert_parameter_type(app, "close-window", "s");
+    assert_parameter_type(app, "reload-window", "s");
+    assert_parameter_type(app, "navigate-window", "(ss)");
+
+    // Read-only list of titles, empty without windows
+    assert_parameter_type(app, "windows", NULL);
+    g_assert_false(g_action_group_get_action_enabled(G_ACTION_GROUP(app), "windows"));
+    gchar** titles = window_titles(app);
+    g_assert_cmpuint(g_strv_length(titles), ==, 0);
+    g_strfreev(titles);
+
+    g_object_unref(app);
+}
+
+static void test_unknown_window(void)
+{
+    if (!gtk_init_check())
+    {
+        g_test_skip("No display; skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.remote.unknown", G_APPLICATION_NON_UNIQUE);
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        g_object_unref(app);
+        return;
+    }
+    hb_remote_install(app);
+
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "close-window: no window titled 'Nope'");
+    g_action_group_activate_action(G_ACTION_GROUP(app), "close-window", g_variant_new_string("Nope"));
+    g_test_assert_expected_messages();
+
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "reload-window: no window titled 'Nope'");
+    g_action_group_activate_action(G_ACTION_GROUP(app), "reload-window", g_variant_new_string("Nope"));
+    g_test_assert_expected_messages();
+
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "navigate-window: no window titled 'Nope'");
+    g_action_group_activate_action(G_ACTION_GROUP(app), "navigate-window",
+                                   g_variant_new("(ss)", "Nope", "about:blank"));
+    g_test_assert_expected_messages();
+
+    // Without a current config there is nothing to re-read
+    g_action_group_activate_action(G_ACTION_GROUP(app), "reload-config", NULL);
+    gchar** titles = window_titles(app);
+    g_assert_cmpuint(g_strv_length(titles), ==, 0);
+    g_strfreev(titles);
+
+    g_object_unref(app);
+}
+
+static void test_open_config_and_close(void)
+{
+    if (!gtk_init_check() || !should_run_webkit_tests())
+    {
+        g_test_skip("Prereqs not met (display or HB_ENABLE_WEBKIT_TESTS not set); skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.remote.open", G_APPLICATION_NON_UNIQUE);
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        g_object_unref(app);
+        return;
+    }
+    hb_remote_install(app);
+
+    gchar* dir = g_dir_make_tmp("hb_remote_test_XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    gchar* path = g_build_filename(dir, "hudbox.json", NULL);
+    g_assert_true(g_file_set_contents(path,
+                                      "[{\"title\": \"A\", \"address\": \"data:text/html,a\"},"
+                                      " {\"title\": \"B\", \"address\": \"data:text/html,b\"}]",
+                                      -1, NULL));
+
+    g_action_group_activate_action(G_ACTION_GROUP(app), "open-config", g_variant_new_string(path));
+    g_assert_cmpstr(g_object_get_data(G_OBJECT(app), "hb-config-path"), ==, path);
+    gchar** titles = window_titles(app);
+    g_assert_cmpuint(g_strv_length(titles), ==, 2);
+    g_assert_cmpstr(titles[0], ==, "A");
+    g_assert_cmpstr(titles[1], ==, "B");
+    g_strfreev(titles);
+
+    // Re-reading the same file keeps the windows
+    g_action_group_activate_action(G_ACTION_GROUP(app), "reload-config", NULL);
+    titles = window_titles(app);
+    g_assert_cmpuint(g_strv_length(titles), ==, 2);
+    g_strfreev(titles);
+
+    g_action_group_activate_action(G_ACTION_GROUP(app), "close-window", g_variant_new_string("A"));
+    titles = window_titles(app);
+    g_assert_cmpuint(g_strv_length(titles), ==, 1);
+    g_assert_cmpstr(titles[0], ==, "B");
+    g_strfreev(titles);
+
+    close_all_windows(app);
+    g_object_unref(app);
+    g_unlink(path);
+    g_rmdir(dir);
+    g_free(path);
+    g_free(dir);
+}
+
+int main(int argc, char** argv)
+{
+    // Configure WebKit for test environment to avoid sandbox/bwrap issues
+    g_setenv("WEBKIT_DISABLE_SANDBOX", "1", TRUE);
+    g_setenv("WEBKIT_USE_SINGLE_WEB_PROCESS", "1", TRUE);
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_remote/actions_installed", test_actions_installed);
+    g_test_add_func("/hb_remote/unknown_window", test_unknown_window);
+    g_test_add_func("/hb_remote/open_config_and_close", test_open_config_and_close);
+
+    return g_test_run();
+}
@@ -0,0 +1,109 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "../src/hb_session.h"
+
+static gchar* temp_path(void)
+{
+    gchar* dir = g_dir_make_tmp("hb_session_test_XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    gchar* path = g_build_filename(dir, "sub", "session.ini", NULL);
+    g_free(dir);
+    return path;
+}
+
+static void remove_temp(const gchar* path)
+{
+    g_unlink(path);
+    gchar* sub = g_path_get_dirname(path);
+    gchar* dir = g_path_get_dirname(sub);
+    g_rmdir(sub);
+    g_rmdir(dir);
+    g_free(sub);
+    g_free(dir);
+}
+
+static void test_round_trip(void)
+{
+    gchar* path = temp_path();
+
+    // Missing file: empty store
+    HbSession* session = hb_session_load(path);
+    g_assert_null(hb_session_lookup(session, "Status"));
+
+    static const guint8 state[] = {0x00, 0x01, 0xfe, 0xff, '[', ']', '\n'};
+    HbSessionEntry entry = {0};
+    entry.address = "https://status.example.com/";
+    entry.state = g_bytes_new_static(state, sizeof(state));
+    entry.width = 640;
+    entry.height = 200;
+    entry.cfg_width = 800;
+    entry.cfg_height = 600;
+    hb_session_set(session, "Status [main]", &entry);
+    hb_session_set(session, "", &entry); // not storable; ignored
+    g_bytes_unref(entry.state);
+
+    GError* error = NULL;
+    g_assert_true(hb_session_save(session, G_MAXINT64, &error));
+    g_assert_no_error(error);
+    hb_session_free(session);
+
+    session = hb_session_load(path);
+    HbSessionEntry* loaded = hb_session_lookup(session, "Status [main]");
+    g_assert_nonnull(loaded);
+    g_assert_cmpstr(loaded->address, ==, "https://status.example.com/");
+    g_assert_nonnull(loaded->state);
+    gsize len = 0;
+    const guint8* data = g_bytes_get_data(loaded->state, &len);
+    g_assert_cmpmem(data, len, state, sizeof(state));
+    g_assert_cmpint(loaded->width, ==, 640);
+    g_assert_cmpint(loaded->height, ==, 200);
+    g_assert_cmpint(loaded->cfg_width, ==, 800);
+    g_assert_cmpint(loaded->cfg_height, ==, 600);
+    g_assert_cmpint(loaded->saved, >, 0);
+    hb_session_entry_free(loaded);
+    g_assert_null(hb_session_lookup(session, "Status"));
+    g_assert_null(hb_session_lookup(session, ""));
+
+    hb_session_remove(session, "Status [main]");
+    g_assert_null(hb_session_lookup(session, "Status [main]"));
+    entry.state = NULL; // released above
+    hb_session_set(session, "Status [main]", &entry);
+
+    // Everything is older than a negative age
+    g_assert_true(hb_session_save(session, -1, NULL));
+    hb_session_free(session);
+    session = hb_session_load(path);
+    g_assert_null(hb_session_lookup(session, "Status [main]"));
+    hb_session_free(session);
+
+    remove_temp(path);
+    g_free(path);
+}
+
+static void test_invalid_file(void)
+{
+    gchar* path = temp_path();
+    gchar* dir = g_path_get_dirname(path);
+    g_assert_cmpint(g_mkdir_with_parents(dir, 0700), ==, 0);
+    g_assert_true(g_file_set_contents(path, "not a key file\n", -1, NULL));
+    g_free(dir);
+
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "Ignoring saved session*");
+    HbSession* session = hb_session_load(path);
+    g_test_assert_expected_messages();
+    g_assert_null(hb_session_lookup(session, "Status"));
+    hb_session_free(session);
+
+    remove_temp(path);
+    g_free(path);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_session/round_trip", test_round_trip);
+    g_test_add_func("/hb_session/invalid_file", test_invalid_file);
+
+    return g_test_run();
+}
@@ -0,0 +1,121 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <json-glib/json-glib.h>
+#include "../src/hb_trace.h"
+
+static void test_disabled_is_noop(void)
+{
+    g_assert_false(hb_trace_is_enabled());
+    g_assert_cmpuint(hb_trace_new_track("ignored"), ==, 0);
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "ignored");
+    hb_trace_span(HB_TRACE_TRACK_MAIN, "ignored", hb_trace_now());
+    g_assert_false(hb_trace_close());
+}
+
+static JsonObject* find_event(JsonArray* events, const gchar* ph, const gchar* name)
+{
+    for (guint i = 0; i < json_array_get_length(events); i++)
+    {
+        JsonObject* ev = json_array_get_object_element(events, i);
+        if (g_strcmp0(json_object_get_string_member(ev, "ph"), ph) != 0) continue;
+        if (g_strcmp0(ph, "M") == 0)
+        {
+            JsonObject* args = json_object_get_object_member(ev, "args");
+            if (g_strcmp0(json_object_get_string_member(args, "name"), name) == 0) return ev;
+        }
+        else if (g_strcmp0(json_object_get_string_member(ev, "name"), name) == 0)
+        {
+            return ev;
+        }
+    }
+    return NULL;
+}
+
+static void test_write_trace(void)
+{
+    gchar* path = g_build_filename(g_get_tmp_dir(), "hb_trace_test.json", NULL);
+    g_unlink(path);
+
+    g_assert_true(hb_trace_open(path));
+    g_assert_true(hb_trace_is_enabled());
+    g_assert_false(hb_trace_open(path)); // already open
+
+    gint64 start = hb_trace_now();
+    guint track = hb_trace_new_track("Window \"A\"");
+    g_assert_cmpuint(track, >, HB_TRACE_TRACK_MAIN);
+    hb_trace_complete(HB_TRACE_TRACK_MAIN, "config_load", start, start + 1500);
+    hb_trace_instant(track, "load_committed");
+
+    g_assert_true(hb_trace_close());
+    g_assert_false(hb_trace_is_enabled());
+
+    JsonParser* parser = json_parser_new();
+    g_assert_true(json_parser_load_from_file(parser, path, NULL));
+    JsonObject* root = json_node_get_object(json_parser_get_root(parser));
+    JsonArray* events = json_object_get_array_member(root, "traceEvents");
+    g_assert_nonnull(events);
+
+    JsonObject* meta = find_event(events, "M", "Window \"A\"");
+    g_assert_nonnull(meta);
+    g_assert_cmpint(json_object_get_int_member(meta, "tid"), ==, track);
+
+    JsonObject* span = find_event(events, "X", "config_load");
+    g_assert_nonnull(span);
+    g_assert_cmpint(json_object_get_int_member(span, "dur"), ==, 1500);
+    g_assert_cmpint(json_object_get_int_member(span, "tid"), ==, HB_TRACE_TRACK_MAIN);
+    g_assert_cmpint(json_object_get_int_member(span, "ts"), >=, 0);
+
+    JsonObject* instant = find_event(events, "i", "load_committed");
+    g_assert_nonnull(instant);
+    g_assert_cmpint(json_object_get_int_member(instant, "tid"), ==, track);
+
+    g_object_unref(parser);
+    g_unlink(path);
+    g_free(path);
+}
+
+static void test_event_limit(void)
+{
+    gchar* path = g_build_filename(g_get_tmp_dir(), "hb_trace_limit_test.json", NULL);
+    g_unlink(path);
+
+    // The "startup" track name plus two events fit; later events are dropped, track names aren't
+    hb_trace_set_max_events(3);
+    g_assert_true(hb_trace_open(path));
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "first");
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "second");
+    g_test_expect_message(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, "Trace buffer is full*");
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "third");
+    g_test_assert_expected_messages();
+    hb_trace_instant(HB_TRACE_TRACK_MAIN, "fourth");
+    guint track = hb_trace_new_track("late window");
+    g_assert_true(hb_trace_close());
+    hb_trace_set_max_events(HB_TRACE_MAX_EVENTS);
+
+    JsonParser* parser = json_parser_new();
+    g_assert_true(json_parser_load_from_file(parser, path, NULL));
+    JsonArray* events =
+        json_object_get_array_member(json_node_get_object(json_parser_get_root(parser)), "traceEvents");
+    g_assert_cmpuint(json_array_get_length(events), ==, 4);
+    g_assert_nonnull(find_event(events, "i", "second"));
+    g_assert_null(find_event(events, "i", "third"));
+    g_assert_null(find_event(events, "i", "fourth"));
+    JsonObject* meta = find_event(events, "M", "late window");
+    g_assert_nonnull(meta);
+    g_assert_cmpint(json_object_get_int_member(meta, "tid"), ==, track);
+
+    g_object_unref(parser);
+    g_unlink(path);
+    g_free(path);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_trace/disabled_is_noop", test_disabled_is_noop);
+    g_test_add_func("/hb_trace/write_trace", test_write_trace);
+    g_test_add_func("/hb_trace/event_limit", test_event_limit);
+
+    return g_test_run();
+}
@@ -0,0 +1,106 @@
+#include <glib.h>
+#include "../src/hb_wheel.h"
+
+static void count_fire(gpointer user_data)
+{
+    (*(guint*)user_data)++;
+}
+
+static void test_fires_on_time(void)
+{
+    HbWheel* wheel = hb_wheel_new(4);
+    guint a = 0, b = 0, c = 0;
+    hb_wheel_add(wheel, 1, count_fire, &a);
+    hb_wheel_add(wheel, 4, count_fire, &b);
+    hb_wheel_add(wheel, 9, count_fire, &c); // more than two turns of the wheel
+    g_assert_cmpuint(hb_wheel_get_count(wheel), ==, 3);
+
+    for (guint tick = 1; tick <= 10; tick++)
+    {
+        hb_wheel_advance(wheel);
+        g_assert_cmpuint(a, ==, tick >= 1 ? 1 : 0);
+        g_assert_cmpuint(b, ==, tick >= 4 ? 1 : 0);
+        g_assert_cmpuint(c, ==, tick >= 9 ? 1 : 0);
+    }
+    g_assert_cmpuint(hb_wheel_get_count(wheel), ==, 0);
+    hb_wheel_free(wheel);
+}
+
+static void test_remove(void)
+{
+    HbWheel* wheel = hb_wheel_new(4);
+    guint a = 0;
+    HbWheelTimer* t = hb_wheel_add(wheel, 2, count_fire, &a);
+    hb_wheel_add(wheel, 0, count_fire, &a); // clamped to the next tick
+    hb_wheel_remove(wheel, t);
+    g_assert_cmpuint(hb_wheel_get_count(wheel), ==, 1);
+    g_assert_cmpuint(hb_wheel_advance(wheel), ==, 1);
+    g_assert_cmpuint(hb_wheel_advance(wheel), ==, 0);
+    g_assert_cmpuint(a, ==, 1);
+
+    // Pending timers are released with the wheel
+    hb_wheel_add(wheel, 3, count_fire, &a);
+    hb_wheel_free(wheel);
+}
+
+typedef struct
+{
+    HbWheel* wheel;
+    HbWheelTimer* other; // removed from inside the callback
+    guint fired;
+} Rearm;
+
+static void rearm_fire(gpointer user_data)
+{
+    Rearm* r = user_data;
+    r->fired++;
+    if (r->other)
+    {
+        hb_wheel_remove(r->wheel, r->other);
+        r->other = NULL;
+    }
+    // Re-adding a full turn ahead lands in the slot being processed
+    if (r->fired < 3) hb_wheel_add(r->wheel, 4, rearm_fire, r);
+}
+
+static void test_callbacks_modify_wheel(void)
+{
+    HbWheel* wheel = hb_wheel_new(4);
+    guint other_fired = 0;
+    Rearm r = {wheel, NULL, 0};
+    hb_wheel_add(wheel, 1, rearm_fire, &r);
+    r.other = hb_wheel_add(wheel, 1, count_fire, &other_fired);
+
+    g_assert_cmpuint(hb_wheel_advance(wheel), ==, 1);
+    g_assert_cmpuint(other_fired, ==, 0);
+    for (guint i = 0; i < 3; i++) g_assert_cmpuint(hb_wheel_advance(wheel), ==, 0);
+    g_assert_cmpuint(hb_wheel_advance(wheel), ==, 1);
+    for (guint i = 0; i < 4; i++) hb_wheel_advance(wheel);
+    g_assert_cmpuint(r.fired, ==, 3);
+    g_assert_cmpuint(hb_wheel_get_count(wheel), ==, 0);
+    hb_wheel_free(wheel);
+}
+
+static void test_jitter(void)
+{
+    for (guint i = 0; i < 1000; i++)
+    {
+        guint64 v = hb_wheel_jitter(100, 10);
+        g_assert_cmpuint(v, >=, 90);
+        g_assert_cmpuint(v, <=, 110);
+    }
+    g_assert_cmpuint(hb_wheel_jitter(5, 10), ==, 5); // spread rounds down to nothing
+    g_assert_cmpuint(hb_wheel_jitter(0, 10), ==, 1);
+}
+
+int main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/hb_wheel/fires_on_time", test_fires_on_time);
+    g_test_add_func("/hb_wheel/remove", test_remove);
+    g_test_add_func("/hb_wheel/callbacks_modify_wheel", test_callbacks_modify_wheel);
+    g_test_add_func("/hb_wheel/jitter", test_jitter);
+
+    return g_test_run();
+}
@@ -3,6 +3,7 @@
 #include <webkit/webkit.h>
 #include "../src/hb_window.h"
 #include "../src/hb_css.h"
+#include "../src/hb_freeze.h"
 
 static gboolean should_run_webkit_tests(void)
 {
@@ -152,6 +153,171 @@ static void test_create_window_smoke_opacity_clamp(void)
     g_object_unref(app);
 }
 
+// Create a window for cfg the way the existing tests do (on activate) and return its HbWindow
+static HbWindow* create_test_window(GtkApplication* app, HbWindowCfg* cfg)
+{
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate_create), cfg);
+    g_application_activate(G_APPLICATION(app));
+    g_signal_handlers_disconnect_by_func(app, on_activate_create, cfg);
+    GList* wins = gtk_application_get_windows(app);
+    return wins ? hb_window_from_widget(GTK_WIDGET(wins->data)) : NULL;
+}
+
+static gboolean on_wait_timeout(gpointer user_data)
+{
+    *(gboolean*)user_data = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+// Run the main loop until done(win) holds or timeout_s passed; returns done(win)
+static gboolean wait_until(gboolean (*done)(HbWindow* win), HbWindow* win, guint timeout_s)
+{
+    gboolean timed_out = FALSE;
+    guint source = g_timeout_add_seconds(timeout_s, on_wait_timeout, &timed_out);
+    while (!done(win) && !timed_out) g_main_context_iteration(NULL, TRUE);
+    if (!timed_out) g_source_remove(source);
+    return done(win);
+}
+
+// Stand in for a finished freeze_after snapshot, as the snapshot callback would install it
+static void freeze_with_placeholder(HbWindow* win)
+{
+    g_object_ref(win->web_view);
+    win->frozen = gtk_picture_new();
+    hb_window_set_content(win, win->frozen);
+}
+
+static gboolean carousel_advanced(HbWindow* win)
+{
+    return win->carousel_index == 1;
+}
+
+static void test_carousel_advance_swaps_views(void)
+{
+    if (!gtk_init_check() || !should_run_webkit_tests())
+    {
+        g_test_skip("Prereqs not met (display or HB_ENABLE_WEBKIT_TESTS not set); skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.window.carousel", G_APPLICATION_NON_UNIQUE);
+    HbWindowCfg cfg = make_cfg("Carousel", "data:text/html,one");
+    const gchar* addresses[] = {"data:text/html,one", "data:text/html,two", NULL};
+    cfg.addresses = g_strdupv((gchar**)addresses);
+    cfg.dwell = 1;
+
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        clear_cfg(&cfg);
+        g_object_unref(app);
+        return;
+    }
+
+    HbWindow* win = create_test_window(app, &cfg);
+    g_assert_nonnull(win);
+    GtkWidget* first = win->web_view;
+    GtkWidget* preload = win->carousel_next;
+    g_assert_nonnull(preload);
+    g_assert_true(gtk_window_get_child(win->window) == first);
+
+    // Once the second page has loaded out of sight and the dwell is up, the two views trade places
+    g_assert_true(wait_until(carousel_advanced, win, 20));
+    g_assert_true(win->web_view == preload);
+    g_assert_true(win->carousel_next == first);
+    g_assert_true(gtk_window_get_child(win->window) == win->web_view);
+    g_assert_cmpstr(webkit_web_view_get_uri(WEBKIT_WEB_VIEW(win->web_view)), ==, addresses[1]);
+
+    close_all_windows(app);
+    clear_cfg(&cfg);
+    g_object_unref(app);
+}
+
+static void test_recycle_replaces_view(void)
+{
+    if (!gtk_init_check() || !should_run_webkit_tests())
+    {
+        g_test_skip("Prereqs not met (display or HB_ENABLE_WEBKIT_TESTS not set); skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.window.recycle", G_APPLICATION_NON_UNIQUE);
+    HbWindowCfg cfg = make_cfg("Recycle", "data:text/html,recycled");
+
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        clear_cfg(&cfg);
+        g_object_unref(app);
+        return;
+    }
+
+    HbWindow* win = create_test_window(app, &cfg);
+    g_assert_nonnull(win);
+    GtkWidget* old_view = g_object_ref(win->web_view);
+
+    hb_window_recycle(win, "test");
+    g_assert_cmpuint(win->recycle_count, ==, 1);
+    g_assert_nonnull(win->web_view);
+    g_assert_true(win->web_view != old_view);
+    g_assert_true(gtk_window_get_child(win->window) == win->web_view);
+    g_assert_null(gtk_widget_get_parent(old_view));
+    g_object_unref(old_view);
+
+    // A frozen window gets the new view in place of its snapshot, and isn't frozen any more
+    freeze_with_placeholder(win);
+    GtkWidget* frozen_view = g_object_ref(win->web_view);
+    hb_window_recycle(win, "test");
+    g_assert_cmpuint(win->recycle_count, ==, 2);
+    g_assert_null(win->frozen);
+    g_assert_true(win->web_view != frozen_view);
+    g_assert_true(gtk_window_get_child(win->window) == win->web_view);
+    g_assert_null(gtk_widget_get_parent(frozen_view));
+    g_object_unref(frozen_view);
+
+    close_all_windows(app);
+    clear_cfg(&cfg);
+    g_object_unref(app);
+}
+
+static void test_freeze_thaw_restores_view(void)
+{
+    if (!gtk_init_check() || !should_run_webkit_tests())
+    {
+        g_test_skip("Prereqs not met (display or HB_ENABLE_WEBKIT_TESTS not set); skipping");
+        return;
+    }
+
+    GtkApplication* app = gtk_application_new("com.hudbox.tests.window.thaw", G_APPLICATION_NON_UNIQUE);
+    HbWindowCfg cfg = make_cfg("Thaw", "data:text/html,live");
+
+    if (!register_or_skip(app, "GApplication could not register; skipping"))
+    {
+        clear_cfg(&cfg);
+        g_object_unref(app);
+        return;
+    }
+
+    HbWindow* win = create_test_window(app, &cfg);
+    g_assert_nonnull(win);
+    GtkWidget* live = win->web_view;
+
+    freeze_with_placeholder(win);
+    g_assert_true(gtk_window_get_child(win->window) == win->frozen);
+    g_assert_null(gtk_widget_get_parent(live));
+
+    hb_freeze_thaw(win);
+    g_assert_null(win->frozen);
+    g_assert_true(win->web_view == live);
+    g_assert_true(gtk_window_get_child(win->window) == live);
+
+    // Thawing a live window changes nothing
+    hb_freeze_thaw(win);
+    g_assert_true(gtk_window_get_child(win->window) == live);
+
+    close_all_windows(app);
+    clear_cfg(&cfg);
+    g_object_unref(app);
+}
+
 int main(int argc, char** argv)
 {
     // Configure WebKit for test environment to avoid sandbox/bwrap issues
@@ -163,6 +329,9 @@ int main(int argc, char** argv)
     g_test_add_func("/hb_window/create_default", test_create_window_smoke_default);
     g_test_add_func("/hb_window/create_transparent_locked", test_create_window_smoke_transparent_and_locked);
     g_test_add_func("/hb_window/create_opacity_clamp", test_create_window_smoke_opacity_clamp);
+    g_test_add_func("/hb_window/carousel_advance", test_carousel_advance_swaps_views);
+    g_test_add_func("/hb_window/recycle", test_recycle_replaces_view);
+    g_test_add_func("/hb_window/freeze_thaw", test_freeze_thaw_restores_view);
 
     return g_test_run();
 }